@@ -0,0 +1,80 @@
+/**
+ * @file BenchmarkPayloads.cpp
+ * @brief Captured server payloads, used by the benchmarks
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "BenchmarkPayloads.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "backend/Storage.h"
+
+namespace Mattermost {
+
+QJsonDocument BenchmarkPayloads::load (const QString& name)
+{
+	QFile file (":/payloads/" + name);
+
+	if (!file.open (QIODevice::ReadOnly)) {
+		qFatal ("Payload %s not found", qPrintable (name));
+	}
+
+	return QJsonDocument::fromJson (file.readAll());
+}
+
+QVector<QPair<QString, QByteArray>> BenchmarkPayloads::loadEvents ()
+{
+	QFile file (":/payloads/events.jsonl");
+
+	if (!file.open (QIODevice::ReadOnly)) {
+		qFatal ("Payload events.jsonl not found");
+	}
+
+	QVector<QPair<QString, QByteArray>> events;
+
+	while (!file.atEnd()) {
+		QByteArray line (file.readLine().trimmed());
+
+		if (!line.isEmpty()) {
+			QString name (QJsonDocument::fromJson (line).object().value ("event").toString());
+			events.push_back (qMakePair (name, line));
+		}
+	}
+
+	return events;
+}
+
+BackendChannel* BenchmarkPayloads::fillStorage (Storage& storage)
+{
+	bool isLoginUser = true;
+
+	for (const auto& user: load ("users.json").array()) {
+		storage.addUser (user.toObject(), isLoginUser);
+		isLoginUser = false;
+	}
+
+	BackendTeam* team = storage.addTeam (load ("team.json").object());
+	return storage.addChannel (*team, load ("channel.json").object());
+}
+
+} /* namespace Mattermost */
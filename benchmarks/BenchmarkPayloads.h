@@ -0,0 +1,59 @@
+/**
+ * @file BenchmarkPayloads.h
+ * @brief Captured server payloads, used by the benchmarks
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+namespace Mattermost {
+
+class Storage;
+class BackendChannel;
+
+/**
+ * The payloads are stored as resources in the format of the Mattermost server responses:
+ * users.json (GET users), posts.json (GET channels/{id}/posts), team.json, channel.json
+ * and events.jsonl (one WebSocket packet per line)
+ */
+class BenchmarkPayloads {
+public:
+	static QJsonDocument load (const QString& name);
+
+	/**
+	 * @return event name and the whole WebSocket packet for each captured event
+	 */
+	static QVector<QPair<QString, QByteArray>> loadEvents ();
+
+	/**
+	 * Add the captured users (the first one is the logged-in user), team and channel
+	 * @return the channel. The posts are not added
+	 */
+	static BackendChannel* fillStorage (Storage& storage);
+};
+
+} /* namespace Mattermost */
@@ -0,0 +1,81 @@
+/**
+ * @file EventHandlerBenchmark.cpp
+ * @brief Benchmarks of the WebSocket event handling
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "EventHandlerBenchmark.h"
+
+#include <QtTest>
+#include <QJsonObject>
+#include "backend/Backend.h"
+#include "backend/WebSocketConnector.h"
+#include "backend/WebSocketEventHandler.h"
+#include "BenchmarkPayloads.h"
+
+namespace Mattermost {
+
+EventHandlerBenchmark::EventHandlerBenchmark () = default;
+
+EventHandlerBenchmark::~EventHandlerBenchmark () = default;
+
+void EventHandlerBenchmark::initTestCase ()
+{
+	backend = std::make_unique<Backend> ();
+
+	BackendChannel* channel = BenchmarkPayloads::fillStorage (backend->getStorage());
+	QJsonObject postList (BenchmarkPayloads::load ("posts.json").object());
+	channel->addPosts (postList.value ("order").toArray(), postList.value ("posts").toObject());
+
+	//the events are passed directly to the connector. It is not connected to a server
+	eventHandler = std::make_unique<WebSocketEventHandler> (*backend);
+	connector = std::make_unique<WebSocketConnector> (*eventHandler);
+}
+
+void EventHandlerBenchmark::cleanupTestCase ()
+{
+	connector.reset ();
+	eventHandler.reset ();
+	backend.reset ();
+}
+
+void EventHandlerBenchmark::handleEvent_data ()
+{
+	QTest::addColumn<QByteArray> ("packet");
+
+	for (const auto& event: BenchmarkPayloads::loadEvents()) {
+		QTest::newRow (qPrintable (event.first)) << event.second;
+	}
+}
+
+void EventHandlerBenchmark::handleEvent ()
+{
+	QFETCH (QByteArray, packet);
+
+	QBENCHMARK {
+		connector->onNewPacket (packet);
+
+		//status and typing events are batched. Apply them, as the batch timer does
+		eventHandler->flushBatchedEvents ();
+	}
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,57 @@
+/**
+ * @file EventHandlerBenchmark.h
+ * @brief Benchmarks of the WebSocket event handling
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+
+namespace Mattermost {
+
+class Backend;
+class WebSocketEventHandler;
+class WebSocketConnector;
+
+class EventHandlerBenchmark: public QObject {
+	Q_OBJECT
+public:
+	EventHandlerBenchmark ();
+	virtual ~EventHandlerBenchmark ();
+private slots:
+	void initTestCase ();
+	void cleanupTestCase ();
+
+	/**
+	 * Each captured event: parsing of the WebSocket packet, dispatching and the WebSocketEventHandler::handleEvent overload.
+	 * Some events (for example user_added, channel_created) also send HTTP requests. Their cost includes queuing the requests
+	 */
+	void handleEvent_data ();
+	void handleEvent ();
+private:
+	std::unique_ptr<Backend>					backend;
+	std::unique_ptr<WebSocketEventHandler>		eventHandler;
+	std::unique_ptr<WebSocketConnector>			connector;
+};
+
+} /* namespace Mattermost */
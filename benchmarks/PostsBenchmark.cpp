@@ -0,0 +1,163 @@
+/**
+ * @file PostsBenchmark.cpp
+ * @brief Benchmarks of adding posts to a channel
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "PostsBenchmark.h"
+
+#include <QSet>
+#include <QtTest>
+#include "backend/types/BackendChannel.h"
+#include "BenchmarkPayloads.h"
+
+namespace Mattermost {
+
+void PostsBenchmark::initTestCase ()
+{
+	BenchmarkPayloads::fillStorage (storage);
+	channelObject = BenchmarkPayloads::load ("channel.json").object();
+
+	QJsonObject postList (BenchmarkPayloads::load ("posts.json").object());
+	order = postList.value ("order").toArray();
+	posts = postList.value ("posts").toObject();
+}
+
+void PostsBenchmark::addPosts_data ()
+{
+	QTest::addColumn<int> ("newPosts");			//posts, which are not received yet
+	QTest::addColumn<int> ("gapInterval");		//every n-th of the received posts is missing locally
+	QTest::addColumn<int> ("deletedInterval");	//every n-th of the received posts is deleted
+
+	QTest::newRow ("initial load") << order.size() << 0 << 0;
+	QTest::newRow ("reconnect") << 10 << 0 << 0;
+	QTest::newRow ("reconnect with gaps") << 10 << 5 << 0;
+	QTest::newRow ("reconnect with deleted posts") << 10 << 0 << 7;
+}
+
+void PostsBenchmark::addPosts ()
+{
+	QFETCH (int, newPosts);
+	QFETCH (int, gapInterval);
+	QFETCH (int, deletedInterval);
+
+	//the reconnect requests only the newest posts
+	static constexpr int reconnectPageSize = 60;
+
+	QJsonArray localOrder;
+	QJsonArray receivedOrder;
+	QSet<QString> deletedPosts;
+
+	for (int i = 0; i < order.size(); ++i) {
+		QString id (order[i].toString());
+		bool isDeleted = deletedInterval && i % deletedInterval == 0;
+
+		if (isDeleted) {
+			deletedPosts.insert (id);
+		}
+
+		if (i >= newPosts && !(gapInterval && i < reconnectPageSize && i % gapInterval == 0)) {
+			localOrder.append (id);
+		}
+
+		//deleted posts are not sent by the server, but they exist locally
+		if ((newPosts == order.size() || i < reconnectPageSize) && !isDeleted) {
+			receivedOrder.append (id);
+		}
+	}
+
+	if (newPosts == order.size()) {
+		localOrder = QJsonArray ();
+	}
+
+	QBENCHMARK {
+		BackendChannel channel (storage, channelObject);
+
+		if (!localOrder.isEmpty()) {
+			channel.addPosts (localOrder, posts);
+
+			for (BackendPost& post: channel.posts) {
+				post.isDeleted = deletedPosts.contains (post.id);
+			}
+		}
+
+		channel.addPosts (receivedOrder, posts);
+	}
+
+	//the destroyed channels remove their posts from the search index, so it does not grow between the iterations
+	QCOMPARE (storage.searchIndex.getPostsCount(), 0u);
+}
+
+void PostsBenchmark::prependPosts ()
+{
+	QJsonArray newerPosts;
+	QJsonArray olderPosts;
+
+	for (int i = 0; i < order.size(); ++i) {
+		(i < order.size() / 2 ? newerPosts : olderPosts).append (order[i]);
+	}
+
+	QBENCHMARK {
+		BackendChannel channel (storage, channelObject);
+		channel.addPosts (newerPosts, posts);
+		channel.prependPosts (olderPosts, posts);
+	}
+
+	QCOMPARE (storage.searchIndex.getPostsCount(), 0u);
+}
+
+void PostsBenchmark::constructPost_data ()
+{
+	QTest::addColumn<QJsonObject> ("postObject");
+
+	QJsonObject plainPost, filesPost, reactionsPost, pollPost;
+
+	for (const auto& postValue: posts) {
+		QJsonObject post (postValue.toObject());
+		QJsonObject metadata (post.value ("metadata").toObject());
+
+		if (post.value ("props").toObject().contains ("poll_id")) {
+			pollPost = post;
+		} else if (metadata.contains ("files")) {
+			filesPost = post;
+		} else if (metadata.contains ("reactions")) {
+			reactionsPost = post;
+		} else if (metadata.isEmpty()) {
+			plainPost = post;
+		}
+	}
+
+	QTest::newRow ("plain") << plainPost;
+	QTest::newRow ("files") << filesPost;
+	QTest::newRow ("reactions") << reactionsPost;
+	QTest::newRow ("poll") << pollPost;
+}
+
+void PostsBenchmark::constructPost ()
+{
+	QFETCH (QJsonObject, postObject);
+
+	QBENCHMARK {
+		BackendPost post (postObject, storage);
+	}
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,63 @@
+/**
+ * @file PostsBenchmark.h
+ * @brief Benchmarks of adding posts to a channel
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "backend/Storage.h"
+
+namespace Mattermost {
+
+class PostsBenchmark: public QObject {
+	Q_OBJECT
+private slots:
+	void initTestCase ();
+
+	/**
+	 * BackendChannel::addPosts: initial load, merge after reconnect with missing posts and with locally deleted posts.
+	 * The local posts are added in each iteration too, so the merge rows include the time of adding them
+	 */
+	void addPosts_data ();
+	void addPosts ();
+
+	/**
+	 * BackendChannel::prependPosts: older posts, received when scrolling to the beginning of the channel
+	 */
+	void prependPosts ();
+
+	/**
+	 * BackendPost construction: plain posts, posts with files, reactions and polls
+	 */
+	void constructPost_data ();
+	void constructPost ();
+private:
+	Storage			storage;
+	QJsonObject		channelObject;
+	QJsonArray		order;			//newest post first
+	QJsonObject		posts;
+};
+
+} /* namespace Mattermost */
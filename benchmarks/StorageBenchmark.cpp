@@ -0,0 +1,86 @@
+/**
+ * @file StorageBenchmark.cpp
+ * @brief Benchmarks of filling the storage with users and channels
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "StorageBenchmark.h"
+
+#include <QtTest>
+#include <QJsonObject>
+#include "backend/Storage.h"
+#include "BenchmarkPayloads.h"
+
+namespace Mattermost {
+
+void StorageBenchmark::initTestCase ()
+{
+	users = BenchmarkPayloads::load ("users.json").array();
+}
+
+void StorageBenchmark::addUsers ()
+{
+	QBENCHMARK {
+		Storage storage;
+
+		for (const auto& user: users) {
+			storage.addUser (user.toObject());
+		}
+	}
+}
+
+void StorageBenchmark::addDirectChannels ()
+{
+	Storage storage;
+	BenchmarkPayloads::fillStorage (storage);
+
+	QString loginUserID (storage.loginUser->id);
+	QVector<QJsonObject> directChannels;
+
+	for (const auto& user: users) {
+		QString userID (user.toObject().value ("id").toString());
+
+		directChannels.push_back (QJsonObject {
+			{"id", "d" + userID.mid (1)},
+			{"type", "D"},
+			{"team_id", ""},
+			{"name", loginUserID + "__" + userID},
+			{"display_name", ""},
+		});
+	}
+
+	QBENCHMARK {
+		for (const QJsonObject& channel: directChannels) {
+			storage.addDirectChannel (channel);
+		}
+
+		//remove the channels, so that they are added again in the next iteration
+		for (const auto& channel: storage.directChannels.channels) {
+			storage.channels.remove (channel->id);
+		}
+
+		storage.directChannels.channels.clear ();
+		storage.directChannels.members.clear ();
+		storage.directChannelsByUser.clear ();
+	}
+}
+
+} /* namespace Mattermost */
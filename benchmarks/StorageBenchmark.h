@@ -0,0 +1,46 @@
+/**
+ * @file StorageBenchmark.h
+ * @brief Benchmarks of filling the storage with users and channels
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QJsonArray>
+
+namespace Mattermost {
+
+class StorageBenchmark: public QObject {
+	Q_OBJECT
+private slots:
+	void initTestCase ();
+	void addUsers ();
+
+	/**
+	 * A direct channel with each user. The users are added before the measurement
+	 */
+	void addDirectChannels ();
+private:
+	QJsonArray		users;
+};
+
+} /* namespace Mattermost */
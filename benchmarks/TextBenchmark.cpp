@@ -0,0 +1,84 @@
+/**
+ * @file TextBenchmark.cpp
+ * @brief Benchmarks of emoji lookup and message formatting
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "TextBenchmark.h"
+
+#include <QtTest>
+#include <QJsonObject>
+#include "backend/emoji/EmojiInfo.h"
+#include "chat-area/post/MessageTextFormatter.h"
+#include "BenchmarkPayloads.h"
+
+namespace Mattermost {
+
+void TextBenchmark::initTestCase ()
+{
+	QJsonObject posts (BenchmarkPayloads::load ("posts.json").object().value ("posts").toObject());
+
+	for (const auto& post: posts) {
+		messages.append (post.toObject().value ("message").toString());
+	}
+}
+
+void TextBenchmark::findEmojiByName_data ()
+{
+	QTest::addColumn<QString> ("name");
+
+	QTest::newRow ("first") << "grinning";
+	QTest::newRow ("common") << "+1";
+	QTest::newRow ("long name") << "white_check_mark";
+	QTest::newRow ("not found") << "no_such_emoji";
+}
+
+void TextBenchmark::findEmojiByName ()
+{
+	QFETCH (QString, name);
+
+	QBENCHMARK {
+		EmojiInfo::findByName (name);
+	}
+}
+
+void TextBenchmark::formatMessageText_data ()
+{
+	QTest::addColumn<QStringList> ("input");
+
+	QTest::newRow ("plain") << QStringList {"the build is green again after the merge"};
+	QTest::newRow ("links") << QStringList {"see https://example.com/issues/1 and http://example.com/wiki/Cache"};
+	QTest::newRow ("emojis") << QStringList {"done :white_check_mark: :tada: :smile: :not_an_emoji:"};
+	QTest::newRow ("captured posts") << messages;
+}
+
+void TextBenchmark::formatMessageText ()
+{
+	QFETCH (QStringList, input);
+
+	QBENCHMARK {
+		for (const QString& message: input) {
+			MessageTextFormatter::format (message);
+		}
+	}
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,49 @@
+/**
+ * @file TextBenchmark.h
+ * @brief Benchmarks of emoji lookup and message formatting
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+
+namespace Mattermost {
+
+class TextBenchmark: public QObject {
+	Q_OBJECT
+private slots:
+	void initTestCase ();
+
+	void findEmojiByName_data ();
+	void findEmojiByName ();
+
+	/**
+	 * MessageTextFormatter::format, used by PostWidget::formatMessageText
+	 */
+	void formatMessageText_data ();
+	void formatMessageText ();
+private:
+	QStringList		messages;
+};
+
+} /* namespace Mattermost */
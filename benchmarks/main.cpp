@@ -0,0 +1,138 @@
+/**
+ * @file main.cpp
+ * @brief Runs all benchmarks and writes the results as JSON
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include <iostream>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QtTest>
+#include <QXmlStreamReader>
+#include "build-config.h"
+#include "EventHandlerBenchmark.h"
+#include "PostsBenchmark.h"
+#include "StorageBenchmark.h"
+#include "TextBenchmark.h"
+
+using namespace Mattermost;
+
+/**
+ * Read the benchmark results from a QtTest XML log
+ */
+static void readResults (QIODevice& xmlLog, const QString& testCase, QJsonArray& results)
+{
+	QXmlStreamReader xml (&xmlLog);
+	QString testFunction;
+
+	while (!xml.atEnd()) {
+		if (xml.readNext() != QXmlStreamReader::StartElement) {
+			continue;
+		}
+
+		if (xml.name() == QLatin1String ("TestFunction")) {
+			testFunction = xml.attributes().value ("name").toString();
+		} else if (xml.name() == QLatin1String ("BenchmarkResult")) {
+			QXmlStreamAttributes attributes (xml.attributes());
+
+			results.append (QJsonObject {
+				{"name", testCase + "::" + testFunction},
+				{"tag", attributes.value ("tag").toString()},
+				{"metric", attributes.value ("metric").toString()},
+				{"value", attributes.value ("value").toDouble()},
+				{"iterations", attributes.value ("iterations").toInt()},
+			});
+		}
+	}
+}
+
+int main (int argc, char** argv)
+{
+	QCoreApplication app (argc, argv);
+
+	//do not use the cache and the settings of the installed client
+	QStandardPaths::setTestModeEnabled (true);
+
+	//the debug output of the backend would be measured too
+	QLoggingCategory::setFilterRules ("default.debug=false");
+
+	/*
+	 * --json <file> writes the results of all benchmarks in a single JSON file, so that they can be compared between builds.
+	 * All other arguments are passed to QtTest (for example, -callgrind or a test function name)
+	 */
+	QStringList arguments (app.arguments());
+	QString jsonFileName;
+	int jsonArgument = arguments.indexOf ("--json");
+
+	if (jsonArgument > 0 && jsonArgument + 1 < arguments.size()) {
+		jsonFileName = arguments[jsonArgument + 1];
+		arguments.erase (arguments.begin() + jsonArgument, arguments.begin() + jsonArgument + 2);
+	}
+
+	PostsBenchmark postsBenchmark;
+	StorageBenchmark storageBenchmark;
+	EventHandlerBenchmark eventHandlerBenchmark;
+	TextBenchmark textBenchmark;
+
+	QObject* benchmarks[] = {&postsBenchmark, &storageBenchmark, &eventHandlerBenchmark, &textBenchmark};
+
+	QJsonArray results;
+	int failures = 0;
+
+	for (QObject* benchmark: benchmarks) {
+		QStringList testArguments (arguments);
+		QTemporaryFile xmlLog;
+
+		if (!jsonFileName.isEmpty() && xmlLog.open()) {
+			testArguments << "-o" << xmlLog.fileName() + ",xml" << "-o" << "-,txt";
+		}
+
+		failures += QTest::qExec (benchmark, testArguments);
+
+		if (!jsonFileName.isEmpty()) {
+			xmlLog.seek (0);
+			readResults (xmlLog, benchmark->metaObject()->className(), results);
+		}
+	}
+
+	if (!jsonFileName.isEmpty()) {
+		QFile jsonFile (jsonFileName);
+
+		if (!jsonFile.open (QIODevice::WriteOnly)) {
+			std::cerr << "Cannot write " << jsonFileName.toStdString() << std::endl;
+			return 1;
+		}
+
+		jsonFile.write (QJsonDocument (QJsonObject {
+			{"version", PROJECT_VER},
+			{"qt_version", qVersion()},
+			{"results", results},
+		}).toJson());
+	}
+
+	return failures;
+}
@@ -30,5 +30,10 @@ static constexpr const char* DOWNLOAD_LOCATION = "config/downloadLocation";
 static constexpr const char* DOWNLOAD_ASK = "config/downloadAsk";
 static constexpr const char* DOWNLOAD_IMAGE_MAX_WIDTH = "config/imageMaxWidth";
 static constexpr const char* DOWNLOAD_IMAGE_MAX_HEIGHT = "config/imageMaxHeight";
+static constexpr const char* IMAGE_PRELOAD_DISTANCE = "config/imagePreloadDistance";
+static constexpr const char* CACHE_MAX_SIZE = "config/cacheMaxSize";
 
 
+static constexpr const char* TRACE_FILE = "debug/traceFile";
+static constexpr const char* STALL_THRESHOLD = "debug/stallThreshold";
+static constexpr const char* MEMORY_REPORT_INTERVAL = "debug/memoryReportInterval";
@@ -24,17 +24,50 @@
 #include <QIntValidator>
 #include <QStandardPaths>
 #include "ui_SettingsWindow.h"
+#include "backend/CacheManager.h"
 #include "Settings.h"
 
 namespace Mattermost {
 
-SettingsWindow::SettingsWindow(QWidget *parent) :
+static QString getSizeString (qint64 size)
+{
+	return QString::number (size / (1024.0 * 1024.0), 'f', 1) + " MB";
+}
+
+static QString getCacheUsageString (const CacheManager& cacheManager)
+{
+	QString ret;
+
+	for (int i = 0; i < CacheNamespace::count; ++i) {
+		CacheNamespace::type ns = (CacheNamespace::type) i;
+		CacheStats stats (cacheManager.getStats (ns));
+
+		ret += QString ("%1: %2 entries, %3 (hits: %4, misses: %5, evicted: %6)\n")
+				.arg (CacheManager::getNamespaceName (ns))
+				.arg (stats.entries)
+				.arg (getSizeString (stats.size))
+				.arg (stats.hits)
+				.arg (stats.misses)
+				.arg (stats.evictions);
+	}
+
+	CacheStats stats (cacheManager.getStats ());
+	ret += QString ("Total: %1 entries, %2 of %3").arg (stats.entries)
+			.arg (getSizeString (stats.size))
+			.arg (getSizeString (cacheManager.getMaximumSize()));
+
+	return ret;
+}
+
+SettingsWindow::SettingsWindow(const CacheManager& cacheManager, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::SettingsWindow)
 {
 	ui->setupUi(this);
 	ui->imageMaxWidthValue->setValidator(new QIntValidator (10, 1000, this));
 	ui->imageMaxHeightValue->setValidator(new QIntValidator (10, 1000, this));
+	ui->imagePreloadDistanceValue->setValidator(new QIntValidator (0, 10000, this));
+	ui->cacheMaxSizeValue->setValidator(new QIntValidator (10, 100000, this));
 
 	QString defaultDownloadDir (QStandardPaths::writableLocation (QStandardPaths::DownloadLocation));
 
@@ -43,6 +76,9 @@ SettingsWindow::SettingsWindow(QWidget *parent) :
 	ui->askLocationCheckBox->setChecked (settings.value (DOWNLOAD_ASK, 0).toBool());
 	ui->imageMaxWidthValue->setText (settings.value (DOWNLOAD_IMAGE_MAX_WIDTH, 400).toString());
 	ui->imageMaxHeightValue->setText (settings.value (DOWNLOAD_IMAGE_MAX_HEIGHT, 400).toString());
+	ui->imagePreloadDistanceValue->setText (settings.value (IMAGE_PRELOAD_DISTANCE, 1000).toString());
+	ui->cacheMaxSizeValue->setText (QString::number (cacheManager.getMaximumSize() / (1024 * 1024)));
+	ui->cacheUsageValue->setText (getCacheUsageString (cacheManager));
 
 	connect (ui->downloadLocationButton, &QPushButton::clicked, [this] {
 		QDir defaultDir (ui->downloadLocationValue->text());
@@ -66,6 +102,8 @@ void SettingsWindow::applyNewSettings ()
 	settings.setValue (DOWNLOAD_ASK, ui->askLocationCheckBox->text());
 	settings.setValue (DOWNLOAD_IMAGE_MAX_WIDTH, ui->imageMaxWidthValue->text());
 	settings.setValue (DOWNLOAD_IMAGE_MAX_HEIGHT, ui->imageMaxHeightValue->text());
+	settings.setValue (IMAGE_PRELOAD_DISTANCE, ui->imagePreloadDistanceValue->text());
+	settings.setValue (CACHE_MAX_SIZE, ui->cacheMaxSizeValue->text());
 	settings.sync ();
 }
 
@@ -28,12 +28,14 @@ class SettingsWindow;
 
 namespace Mattermost {
 
+class CacheManager;
+
 class SettingsWindow : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit SettingsWindow(QWidget *parent = nullptr);
+    explicit SettingsWindow(const CacheManager& cacheManager, QWidget *parent = nullptr);
     ~SettingsWindow();
 public:
     void applyNewSettings ();
@@ -39,11 +39,13 @@
 #include <QStandardPaths>
 #include <QDebug>
 #include <QList>
+#include <QDateTime>
 
 #include "NetworkRequest.h"
 #include "types/BackendPoll.h"
 #include "types/BackendNewPollData.h"
 #include "emoji/EmojiInfo.h"
+#include "Trace.h"
 #include "log.h"
 
 /**
@@ -54,6 +56,12 @@
 
 namespace Mattermost {
 
+static constexpr int customEmojisPerPage = 200;
+static const QString customEmojiListCacheKey ("list");
+
+//the saved custom emoji list is used without retrieving it again, until it is older than this (in milliseconds)
+static constexpr qint64 customEmojiListMaxAge = 24 * 60 * 60 * 1000;
+
 namespace RequestTrackerID {
 enum type {
 	channelMember,
@@ -64,6 +72,7 @@ enum type {
 Backend::Backend(QObject *parent)
 :QObject (parent)
 ,serverDialogsMap (*this)
+,httpConnector (cacheManager)
 ,webSocketEventHandler (*this)
 ,webSocketConnector (webSocketEventHandler)
 ,currentChannel (nullptr)
@@ -79,12 +88,11 @@ Backend::Backend(QObject *parent)
 			LOG_DEBUG ("Reconnect - check for missed posts");
 
 			/**
-			 * Reset the HTTP connector, so that all waiting requests are cancelled.
-			 * Each element that has sent a request should verify if it has arrived
-			 * and resend it (using the onWebSocketDisconnect / onWebSocketConnect signal).
-			 * Without the httpconnector reset, there may be stuck requests
+			 * Recreate the network access manager of the HTTP connector, so that there are no stuck requests.
+			 * The GET requests in progress are sent again and their callbacks receive the responses.
+			 * Other requests (POST, PUT, DELETE) are not idempotent and are not resent
 			 */
-			httpConnector.reset ();
+			httpConnector.reconnect ();
 
 			for (auto& it: storage.channels) {
 				retrieveChannelPosts (*it, 0, 25);
@@ -100,6 +108,19 @@ Backend::Backend(QObject *parent)
 	connect (&webSocketConnector, &WebSocketConnector::onDisconnect, this, &Backend::onWebSocketDisconnect);
 	connect (&httpConnector, &HTTPConnector::onNetworkError, this, &Backend::onNetworkError);
 
+	EmojiInfo::setCustomEmojiImageProvider ([this] (const QString& emojiName, const QString& emojiID, uint64_t updateTime) {
+		return getCustomEmojiImage (emojiName, emojiID, updateTime);
+	});
+
+	//images requested together (for example, for a post with several custom emojis) are notified at once
+	customEmojiImagesTimer.setSingleShot (true);
+	customEmojiImagesTimer.setInterval (100);
+	connect (&customEmojiImagesTimer, &QTimer::timeout, [this] {
+		QSet<QString> emojiNames;
+		emojiNames.swap (changedCustomEmojiImages);
+		emit onCustomEmojiImagesChanged (emojiNames);
+	});
+
 	connect (&httpConnector, &HTTPConnector::onHttpError, [this] (uint32_t errorNumber, const QString& errorText) {
 
 		emit onHttpError (errorNumber, errorText);
@@ -110,6 +131,9 @@ Backend::Backend(QObject *parent)
 					httpConnector.reset ();
 					webSocketConnector.reset ();
 					loginRetry ();
+
+					//exit() does not destroy the cache manager
+					cacheManager.flush ();
 					exit (1);
 				});
 			} else {
@@ -118,8 +142,6 @@ Backend::Backend(QObject *parent)
 		}
 	});
 
-	attachmentsCache.setCacheDirectory (QDir (QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("attachments"));
-	attachmentsCache.setMaximumCacheSize (300 * 1024 * 1024);
 }
 
 void debugRequest (const QNetworkRequest& request, QByteArray data = QByteArray())
@@ -137,13 +159,17 @@ void Backend::login (const BackendLoginData& loginData, std::function<void(const
 	this->loginData = loginData;
 	NetworkRequest::setHost (loginData.domain);
 
+	//from sending the login request to processing the login user
+	uint64_t traceID = Trace::beginAsync ("backend", "login");
+
 	if (!loginData.token.isEmpty()) {
 
 		NetworkRequest::setToken (loginData.token);
 		NetworkRequest request ("users/me");
 
-		httpConnector.get (request, HttpResponseCallback ([this, callback](const QJsonDocument& data, const QNetworkReply& reply) {
+		httpConnector.get (request, HttpResponseCallback ([this, callback, traceID](const QJsonDocument& data, const QNetworkReply& reply) {
 			loginSuccess (data, reply, callback);
+			Trace::endAsync ("backend", "login", traceID);
 		}));
 
 
@@ -177,8 +203,9 @@ void Backend::login (const BackendLoginData& loginData, std::function<void(const
 
 	//debugRequest (request, data);
 
-	httpConnector.post (request, json, HttpResponseCallback ([this, callback](const QJsonDocument& data, const QNetworkReply& reply) {
+	httpConnector.post (request, json, HttpResponseCallback ([this, callback, traceID](const QJsonDocument& data, const QNetworkReply& reply) {
 		loginSuccess (data, reply, callback);
+		Trace::endAsync ("backend", "login", traceID);
 	}));
 }
 
@@ -221,6 +248,8 @@ bool Backend::autoLoginEnabled ()
 
 void Backend::loginSuccess (const QJsonDocument& doc, const QNetworkReply& reply, std::function<void (const QString&)> callback)
 {
+	TraceSpan span ("backend", "loginSuccess");
+
 #if 1
 	QString jsonString = doc.toJson(QJsonDocument::Indented);
 	std::cout << "loginUser: " << jsonString.toStdString() << std::endl;
@@ -249,17 +278,29 @@ void Backend::reset ()
 	isLoggedIn = false;
 
 	/*
-	 * This is important. Disconnect all signals. Added lambda functions are not removed when
+	 * This is important. Disconnect all signals and entity observers. Added lambda functions are not removed when
 	 * objects are destroyed
 	 */
 	disconnect ();
+	storage.observers.clear ();
 	NetworkRequest::clearToken ();
 
 	//reinit all network connectors
 	timeoutTimer.disconnect ();
 	httpConnector.reset ();
 	webSocketConnector.close ();
+	webSocketEventHandler.reset ();
 	storage.reset ();
+
+	//the image requests were dropped. The images are requested again when the emojis are used
+	for (const QString& emojiName: pendingCustomEmojiImages) {
+		EmojiInfo::resetCustomEmojiImageRequest (emojiName);
+	}
+
+	pendingCustomEmojiImages.clear ();
+
+	//the cache budget may have been changed in the settings
+	cacheManager.readSettings ();
 	nonFilledTeams = 0;
 }
 
@@ -298,7 +339,7 @@ void Backend::retrieveUser (QString userID, std::function<void (const BackendUse
 
 	LOG_DEBUG ("retrieveUser " << userID);
 
-	httpConnector.get (request, HttpResponseCallback ([this, callback](const QJsonDocument& doc) {
+	httpConnector.getRevalidated (request, CacheNamespace::api, HttpResponseCallback ([this, callback](const QJsonDocument& doc) {
 
 		LOG_DEBUG ("retrieveUser reply");
 
@@ -306,7 +347,7 @@ void Backend::retrieveUser (QString userID, std::function<void (const BackendUse
 		//std::cout << "get users reply: " << statusCode.toInt() << std::endl;
 
 		BackendUser *user = storage.addUser (doc.object());
-		retrieveUserAvatar (user->id, user->update_at);
+		retrieveUserAvatar (user->id, user->last_picture_update);
 		callback (*user);
 	}));
 }
@@ -413,8 +454,9 @@ void Backend::retrieveAllUsers ()
 	for (uint32_t page = 0; page < totalPages; ++page) {
 		NetworkRequest request ("users?per_page=" + QString::number(usersPerPage) + "&page=" + QString::number(page));
 
-		httpConnector.get (request, HttpResponseCallback ([this, page, totalPages] (const QJsonDocument& doc) {
+		httpConnector.getRevalidated (request, CacheNamespace::api, HttpResponseCallback ([this, page, totalPages] (const QJsonDocument& doc) {
 
+			TraceSpan span ("backend", "retrieveAllUsers", "page " + QString::number (page));
 			LOG_DEBUG ("retrieveAllUsers reply");
 
 #if 0
@@ -427,7 +469,7 @@ void Backend::retrieveAllUsers ()
 
 			for (const auto &itemRef: doc.array()) {
 				BackendUser *user = storage.addUser (itemRef.toObject());
-				retrieveUserAvatar (user->id, user->update_at);
+				retrieveUserAvatar (user->id, user->last_picture_update);
 				userIds.push_back (user->id);
 			}
 
@@ -458,59 +500,112 @@ void Backend::retrieveAllUsers ()
 	}
 }
 
-void Backend::retrieveUserAvatar (QString userID, uint64_t lastUpdateTime)
+void Backend::retrieveUserAvatar (QString userID, uint64_t lastPictureUpdate)
 {
-	NetworkRequest request ("users/" + userID + "/image", true);
+	/*
+	 * The picture version is a part of the url (like in the official web client), so the response
+	 * is cached once, under the url, by the revalidated request. A new picture has a new url
+	 */
+	NetworkRequest request ("users/" + userID + "/image" + (lastPictureUpdate ? "?_=" + QString::number (lastPictureUpdate) : QString ()));
+	QString cacheKey (request.url().toString());
+
+	//the avatar has not changed since it was cached. Use it without sending a request
+	if (lastPictureUpdate && cacheManager.contains (CacheNamespace::avatars, cacheKey)) {
+		cacheManager.getAsync (CacheNamespace::avatars, cacheKey, [this, userID, lastPictureUpdate] (const QByteArray& data) {
+
+			//the cached avatar could not be read. Retrieve it from the server
+			if (data.isNull()) {
+				retrieveUserAvatar (userID, lastPictureUpdate);
+				return;
+			}
+
+			setUserAvatar (userID, data);
+		});
+		return;
+	}
 
 	//LOG_DEBUG ("getUserImage request");
 
-	httpConnector.get (request, HttpResponseCallback ([this, userID] (QVariant, QByteArray data) {
+	httpConnector.getRevalidated (request, CacheNamespace::avatars, HttpResponseCallback ([this, userID] (QVariant, QByteArray data) {
 
 		//LOG_DEBUG ("getUserImage reply");
+		setUserAvatar (userID, data);
+	}));
+}
 
-		BackendUser* user = storage.getUserById (userID);
+void Backend::setUserAvatar (const QString& userID, const QByteArray& data)
+{
+	BackendUser* user = storage.getUserById (userID);
 
-		if (!user) {
-			qCritical() << "Get Image: user " << userID << " not found";
-			return;
-		}
+	if (!user) {
+		qCritical() << "Get Image: user " << userID << " not found";
+		return;
+	}
 
-		user->avatar = data;
+	user->avatar = data;
 
-		emit user->onAvatarChanged();
-	}));
+	storage.observers.user.avatarChanged.notify (userID, *user);
 }
 
-void Backend::retrieveFile (QString fileID, std::function<void (const QByteArray&)> callback)
+/**
+ * Get the url path of a file version. The same path is used as a cache key,
+ * so that each version is cached separately
+ */
+static QString getFilePath (const QString& fileID, FileTier::type tier)
 {
-	NetworkRequest request ("files/" + fileID, true);
+	switch (tier) {
+	case FileTier::preview:
+		return "files/" + fileID + "/preview";
+	case FileTier::thumbnail:
+		return "files/" + fileID + "/thumbnail";
+	default:
+		return "files/" + fileID;
+	}
+}
 
-	QIODevice* cachedFile = attachmentsCache.data (fileID);
+HttpRequestHandle Backend::retrieveFile (QString fileID, std::function<void (const QByteArray&)> callback, FileTier::type tier)
+{
+	QString filePath (getFilePath (fileID, tier));
 
-	if (cachedFile) {
-		//LOG_DEBUG ("Retrieve File " << fileID << " done (from custom cache). Attachment cache size: " << attachmentsCache.cacheSize());
+	//files are cached by the backend, not by the network access manager
+	NetworkRequest request (filePath);
+
+	CacheNamespace::type cacheNamespace (tier == FileTier::original ? CacheNamespace::attachments : CacheNamespace::thumbnails);
+
+	if (cacheManager.contains (cacheNamespace, filePath)) {
 
 		/**
-		 * Do not call callback in the same stack frame
-		 * so that the same behavior is achieved like non-cached files.
+		 * The file is read in a worker thread, so that large files do not block the GUI.
+		 * The callback is not called in the same stack frame, so that the same behavior is achieved like non-cached files.
 		 * The behavior may matter in cases like widget resize, when the file is received
 		 */
-		QTimer::singleShot(1, [callback, cachedFile] {
-			callback (cachedFile->readAll());
+		HttpRequestHandle handle (HttpRequestHandle::createDeferred ());
+
+		cacheManager.getAsync (cacheNamespace, filePath, [this, fileID, tier, callback, handle] (const QByteArray& cachedFile) mutable {
+			//LOG_DEBUG ("Retrieve File " << fileID << " done (from cache). Cache size: " << cacheManager.getSize());
+
+			//cancelled while the file was being read
+			if (!handle.isPending()) {
+				return;
+			}
+
+			//the cached file could not be read. Download it, the download is cancelled through the same handle
+			if (cachedFile.isNull()) {
+				handle.setDeferredRequest (retrieveFile (fileID, callback, tier));
+				return;
+			}
+
+			handle.finishDeferred ();
+			callback (cachedFile);
 		});
-		return;
+		return handle;
 	}
 
-	QNetworkCacheMetaData metaData;
-	metaData.setUrl(fileID);
-	QIODevice* cacheIO = attachmentsCache.prepare(metaData);
+	return httpConnector.get (request, HttpResponseCallback ([this, cacheNamespace, filePath, callback](QVariant, QByteArray data) {
+		//LOG_DEBUG ("Retrieve File " << filePath << " done");
 
-	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
-
-	httpConnector.get (request, HttpResponseCallback ([this, fileID, callback, cacheIO](QVariant, QByteArray data) {
-		//LOG_DEBUG ("Retrieve File " << fileID << " done");
-		cacheIO->write (data);
-		attachmentsCache.insert (cacheIO);
+		//the entry is added only after the file is received, so that aborted requests do not leave unfinished entries
+		cacheManager.insert (cacheNamespace, filePath, data);
 		callback (data);
 	}));
 }
@@ -525,7 +620,8 @@ void Backend::retrieveOwnTeams (std::function<void(BackendTeam&)> callback)
 
     LOG_DEBUG ("retrieveOwnTeams request");
 
-    httpConnector.get (request, HttpResponseCallback ([this, callback] (const QJsonDocument& doc) {
+    httpConnector.getRevalidated (request, CacheNamespace::api, HttpResponseCallback ([this, callback] (const QJsonDocument& doc) {
+    	TraceSpan span ("backend", "retrieveOwnTeams");
     	LOG_DEBUG ("retrieveOwnTeams reply");
 		storage.teams.clear ();
 
@@ -590,7 +686,7 @@ void Backend::retrieveTeamPublicChannels (QString teamID, std::function<void(std
 
     std::cout << "get team channels " << teamID.toStdString() << std::endl;
 
-    httpConnector.get (request, HttpResponseCallback ([this, callback, teamID](QVariant, const QJsonDocument& doc) {
+    HttpRequestHandle handle (httpConnector.getRevalidated (request, CacheNamespace::api, HttpResponseCallback ([this, callback, teamID](QVariant, const QJsonDocument& doc) {
     	LOG_DEBUG ("getTeamChannels reply");
 
 		BackendTeam* team = storage.getTeamById (teamID);
@@ -610,14 +706,22 @@ void Backend::retrieveTeamPublicChannels (QString teamID, std::function<void(std
 		std::cout << "get team channels reply: " <<  jsonString.toStdString() << std::endl;
 #endif
 		callback (team->allPublicChannels);
-    }));
+    })));
+
+	//the callback may refer to the team
+	BackendTeam* team = storage.getTeamById (teamID);
+
+	if (team) {
+		team->requests.add (handle);
+	}
 }
 
 void Backend::retrieveOwnChannelMembershipsForTeam (BackendTeam& team, std::function<void(BackendChannel&)> callback)
 {
     NetworkRequest request ("users/me/teams/" + team.id + "/channels");
 
-    httpConnector.get (request, HttpResponseCallback ([this, &team, callback] (const QJsonDocument& doc) {
+    team.requests.add (httpConnector.getRevalidated (request, CacheNamespace::api, HttpResponseCallback ([this, &team, callback] (const QJsonDocument& doc) {
+    	TraceSpan span ("backend", "retrieveOwnChannelMembershipsForTeam", team.display_name);
     	team.channels.clear ();
 
 #if 0
@@ -640,7 +744,7 @@ void Backend::retrieveOwnChannelMembershipsForTeam (BackendTeam& team, std::func
 		if (nonFilledTeams == 0) {
 			emit onAllTeamChannelsPopulated ();
 		}
-    }));
+    })));
 }
 
 #if 0 //supported in Mattermost server 6.2
@@ -671,7 +775,7 @@ void Backend::retrieveTeamMembers (BackendTeam& team, int page)
 
 	//LOG_DEBUG ("retrieveTeamMembers " << team.display_name << " page " << page);
 
-	httpConnector.get(request, HttpResponseCallback ([this, &team, page] (const QJsonDocument& doc) {
+	team.requests.add (httpConnector.getRevalidated (request, CacheNamespace::api, HttpResponseCallback ([this, &team, page] (const QJsonDocument& doc) {
 
 #if 0
 		QString jsonString = doc.toJson(QJsonDocument::Indented);
@@ -686,7 +790,7 @@ void Backend::retrieveTeamMembers (BackendTeam& team, int page)
 		if (root.size() == itemsPerPage) {
 			retrieveTeamMembers (team, page + 1);
 		}
-	}));
+	})));
 }
 
 void Backend::retrieveTeamMember (BackendTeam& team, const BackendUser& user)
@@ -701,9 +805,7 @@ void Backend::retrieveTeamMember (BackendTeam& team, const BackendUser& user)
 
 	LOG_DEBUG ("retrieveTeamMember for team '" << team.name << "', user '" << user.getDisplayName() << "'");
 
-	requestTracker.addEntry (trackedEntry);
-
-	httpConnector.get (request, HttpResponseCallback ([this, &team, &user, trackedEntry](const QJsonDocument& doc) {
+	HttpRequestHandle handle (httpConnector.get (request, HttpResponseCallback ([this, &team, &user, trackedEntry](const QJsonDocument& doc) {
 
 #if 0
 		QString jsonString = doc.toJson(QJsonDocument::Indented);
@@ -711,8 +813,13 @@ void Backend::retrieveTeamMember (BackendTeam& team, const BackendUser& user)
 #endif
 		team.addMember (storage, doc.object());
 		requestTracker.eraseEntry (trackedEntry);
-		emit (team.onUserAdded (user));
-	}));
+		storage.observers.team.userAdded.notify (team.id, user);
+	})));
+
+	team.requests.add (handle);
+
+	//if the request is cancelled or fails, the entry is dropped, because the handle is not pending any more
+	requestTracker.addEntry (trackedEntry, handle);
 }
 
 void Backend::retrieveChannel (BackendTeam& team, QString channelID)
@@ -721,7 +828,7 @@ void Backend::retrieveChannel (BackendTeam& team, QString channelID)
 
 	LOG_DEBUG ("retrieveChannel '" << channelID << "' of team '" << team.name << "'");
 
-	httpConnector.get (request, HttpResponseCallback ([this, &team] (const QJsonDocument& doc) {
+	team.requests.add (httpConnector.get (request, HttpResponseCallback ([this, &team] (const QJsonDocument& doc) {
 		LOG_DEBUG ("retrieveChannel reply");
 
 #if 0
@@ -732,8 +839,8 @@ void Backend::retrieveChannel (BackendTeam& team, QString channelID)
 		BackendChannel* channel =  storage.addTeamChannel (team, doc.object());
 		LOG_DEBUG ("\tNew Channel added: " << channel->id << " " << channel->display_name);
 
-		emit team.onNewChannel (*channel);
-    }));
+		storage.observers.team.newChannel.notify (team.id, *channel);
+    })));
 }
 
 void Backend::retrieveDirectChannel (QString channelID)
@@ -753,7 +860,7 @@ void Backend::retrieveDirectChannel (QString channelID)
 		BackendChannel* channel =  storage.addDirectChannel (doc.object());
 		LOG_DEBUG ("\tNew Channel added: " << channel->id << " " << channel->display_name);
 
-		emit storage.directChannels.onNewChannel (*channel);
+		storage.observers.team.newChannel.notify (storage.directChannels.id, *channel);
 
 		/*
 		 * The channel is created, but the official Mattermost client requires
@@ -769,7 +876,7 @@ void Backend::retrieveChannelPosts (BackendChannel& channel, int page, int perPa
     NetworkRequest request ("channels/" + channel.id + "/posts?page=" + QString::number(page) + "&per_page=" + QString::number(perPage));
     //LOG_DEBUG ("retrieveChannelPosts request for " << channel.display_name << " (" << channel.id << ")");
 
-    httpConnector.get (request, HttpResponseCallback ([this, &channel](const QJsonDocument& doc) {
+    channel.requests.add (httpConnector.get (request, HttpResponseCallback ([this, &channel](const QJsonDocument& doc) {
 
 		//LOG_DEBUG ("retrieveChannelPosts reply for " << channel.display_name << " (" << channel.id << ")");
 
@@ -778,10 +885,11 @@ void Backend::retrieveChannelPosts (BackendChannel& channel, int page, int perPa
 		std::cout << jsonString.toStdString() << std::endl;
 #endif
 
+		TraceSpan span ("backend", "retrieveChannelPosts", channel.display_name);
 		QJsonObject root = doc.object();
 		channel.addPosts (root.value("order").toArray(), root.value("posts").toObject());
 		retrieveChannelPinnedPosts (channel);
-    }));
+    })));
 }
 
 void Backend::retrieveChannelPinnedPosts (BackendChannel& channel)
@@ -789,7 +897,7 @@ void Backend::retrieveChannelPinnedPosts (BackendChannel& channel)
     NetworkRequest request ("channels/" + channel.id + "/pinned");
     //LOG_DEBUG ("retrieveChannelPinnedPosts request for " << channel.display_name << " (" << channel.id << ")");
 
-    httpConnector.get (request, HttpResponseCallback ([this, &channel](const QJsonDocument& doc) {
+    channel.requests.add (httpConnector.get (request, HttpResponseCallback ([this, &channel](const QJsonDocument& doc) {
 
 		//LOG_DEBUG ("retrieveChannelPinnedPosts reply for " << channel.display_name << " (" << channel.id << ")");
 		//QString jsonString = doc.toJson(QJsonDocument::Indented);
@@ -797,14 +905,48 @@ void Backend::retrieveChannelPinnedPosts (BackendChannel& channel)
 
 		QJsonObject root = doc.object();
 		channel.addPinnedPosts (root.value("order").toArray(), root.value("posts").toObject());
-    }));
+    })));
+}
+
+void Backend::retrievePostThread (BackendChannel& channel, const QString& rootId, std::function<void()> callback)
+{
+	NetworkRequest request ("posts/" + rootId + "/thread");
+
+	channel.requests.add (httpConnector.get (request, HttpResponseCallback ([&channel, callback](const QJsonDocument& doc) {
+		QJsonObject root = doc.object();
+		channel.addThreadPosts (root.value("order").toArray(), root.value("posts").toObject());
+		callback ();
+	})));
+}
+
+void Backend::searchPosts (const QString& teamID, const QString& terms, std::function<void(std::list<BackendPost>&)> callback)
+{
+	QJsonObject jsonRoot;
+	jsonRoot.insert ("terms", terms);
+	jsonRoot.insert ("is_or_search", false);
+	jsonRoot.insert ("page", 0);
+	jsonRoot.insert ("per_page", 60);
+
+	NetworkRequest request ("teams/" + teamID + "/posts/search");
+
+	httpConnector.post (request, jsonRoot, HttpResponseCallback ([this, callback](const QJsonDocument& doc) {
+		QJsonObject root = doc.object();
+		QJsonObject postsObject = root.value("posts").toObject();
+		std::list<BackendPost> posts;
+
+		for (const auto& postEl: root.value("order").toArray()) {
+			posts.emplace_back (postsObject.value (postEl.toString()).toObject(), storage);
+		}
+
+		callback (posts);
+	}));
 }
 
 void Backend::retrieveChannelOlderPosts (BackendChannel& channel, int perPage)
 {
     NetworkRequest request ("channels/" + channel.id + "/posts?page=" + QString::number(0) + "&per_page=" + QString::number(perPage) + "&before=" + channel.posts.front().id);
 
-    httpConnector.get (request, HttpResponseCallback ([this, &channel](const QJsonDocument& doc) {
+    channel.requests.add (httpConnector.get (request, HttpResponseCallback ([this, &channel](const QJsonDocument& doc) {
 
 		LOG_DEBUG ("retrieveChannelOlderPosts reply for " << channel.display_name << " (" << channel.id << ") - since " << channel.posts.front().id);
 
@@ -815,14 +957,14 @@ void Backend::retrieveChannelOlderPosts (BackendChannel& channel, int perPage)
 
 		QJsonObject root = doc.object();
 		channel.prependPosts (root.value("order").toArray(), root.value("posts").toObject());
-    }));
+    })));
 }
 
 void Backend::retrieveChannelUnreadPost (BackendChannel& channel, std::function<void (const QString&)> responseHandler)
 {
 	NetworkRequest request ("users/me/channels/" + channel.id + "/posts/unread?limit_before=0&limit_after=1");
 
-	httpConnector.get (request, HttpResponseCallback ([this, &channel, responseHandler](const QJsonDocument& doc) {
+	channel.requests.add (httpConnector.get (request, HttpResponseCallback ([this, &channel, responseHandler](const QJsonDocument& doc) {
 
 		//LOG_DEBUG ("retrieveChannelUnreadPost reply for " << channel.display_name << " (" << channel.id << ")");
 
@@ -841,14 +983,14 @@ void Backend::retrieveChannelUnreadPost (BackendChannel& channel, std::function<
 			static QString emptyString ("");
 			responseHandler (emptyString);
 		}
-    }));
+    })));
 }
 
 void Backend::retrieveChannelMembers (BackendChannel& channel, std::function<void ()> callback)
 {
 	NetworkRequest request ("channels/" + channel.id + "/members");
 
-	httpConnector.get (request, HttpResponseCallback ([this, &channel, callback](const QJsonDocument& doc) {
+	channel.requests.add (httpConnector.get (request, HttpResponseCallback ([this, &channel, callback](const QJsonDocument& doc) {
 
 		//LOG_DEBUG ("retrieveChannelMembers reply");
 
@@ -861,7 +1003,7 @@ void Backend::retrieveChannelMembers (BackendChannel& channel, std::function<voi
 			channel.addMember (storage, itemRef.toObject());
 		}
 		callback ();
-	}));
+	})));
 }
 
 void Backend::retrieveChannelMember (BackendChannel& channel, const BackendUser& user)
@@ -876,9 +1018,7 @@ void Backend::retrieveChannelMember (BackendChannel& channel, const BackendUser&
 
 	LOG_DEBUG ("retrieveChannelMember for channel '" << channel.name << "', user '" << user.getDisplayName() << "'");
 
-	requestTracker.addEntry (trackedEntry);
-
-	httpConnector.get (request, HttpResponseCallback ([this, &channel, &user, trackedEntry](const QJsonDocument& doc) {
+	HttpRequestHandle handle (httpConnector.get (request, HttpResponseCallback ([this, &channel, &user, trackedEntry](const QJsonDocument& doc) {
 
 #if 0
 		QString jsonString = doc.toJson(QJsonDocument::Indented);
@@ -886,8 +1026,13 @@ void Backend::retrieveChannelMember (BackendChannel& channel, const BackendUser&
 #endif
 		channel.addMember (storage, doc.object());
 		requestTracker.eraseEntry (trackedEntry);
-		emit (channel.onUserAdded (user));
-	}));
+		storage.observers.channel.userAdded.notify (channel.id, user);
+	})));
+
+	channel.requests.add (handle);
+
+	//if the request is cancelled or fails, the entry is dropped, because the handle is not pending any more
+	requestTracker.addEntry (trackedEntry, handle);
 }
 
 void Backend::retrievePollMetadata (BackendPoll& poll)
@@ -896,14 +1041,21 @@ void Backend::retrievePollMetadata (BackendPoll& poll)
 
 	LOG_DEBUG ("retrievePollMetadata request");
 
-	httpConnector.get (request, HttpResponseCallback ([this, &poll](const QJsonDocument& doc) {
+	//the poll may be destroyed together with its post, before the response arrives
+	QPointer<BackendPoll> pollPtr (&poll);
+
+	httpConnector.get (request, HttpResponseCallback ([pollPtr](const QJsonDocument& doc) {
 
 		LOG_DEBUG ("retrievePollMetadata reply");
 
+		if (!pollPtr) {
+			return;
+		}
+
 		QString jsonString = doc.toJson(QJsonDocument::Indented);
 		std::cout << jsonString.toStdString() << std::endl;
 
-		poll.fillMetadata (doc.object());
+		pollPtr->fillMetadata (doc.object());
 	}));
 }
 
@@ -1248,48 +1400,182 @@ void Backend::sendSubmitDialog (const QJsonDocument& json)
 	}));
 }
 
+static QString getCustomEmojiImageKey (const QString& emojiID, uint64_t updateTime)
+{
+	//an emoji can be deleted and created again with the same name, but it will have a new ID
+	return emojiID + '/' + QString::number (updateTime);
+}
+
+static QString getCustomEmojiImageKey (const QJsonObject& emoji)
+{
+	return getCustomEmojiImageKey (emoji.value("id").toString(), emoji.value("update_at").toVariant().toULongLong());
+}
+
 void Backend::retrieveCustomEmojis ()
 {
-	NetworkRequest request ("emoji");
-	httpConnector.get (request, HttpResponseCallback ([this] (QVariant, QJsonDocument data) {
+	/*
+	 * Use the emoji list from the previous session. Only the list is needed at this point, images are requested
+	 * when the emojis are used.
+	 * The server can not list only the emojis changed since a given time, so all pages are retrieved
+	 * only if the saved list is old. Emojis created in the meantime are added by the emoji_added event
+	 */
+	QByteArray savedList (cacheManager.get (CacheNamespace::emoji, customEmojiListCacheKey));
+
+	if (!savedList.isNull()) {
+		for (const auto& it: QJsonDocument::fromJson (savedList).array()) {
+			addCustomEmoji (it.toObject());
+		}
+
+		//the meta data is the time, when the list was retrieved
+		qint64 retrieveTime = cacheManager.getMetaData (CacheNamespace::emoji, customEmojiListCacheKey).toLongLong();
+
+		if (QDateTime::currentMSecsSinceEpoch() - retrieveTime < customEmojiListMaxAge) {
+			LOG_DEBUG ("Custom emojis: using the saved list");
+			return;
+		}
+	}
+
+	retrieveCustomEmojisPage (0, QJsonArray ());
+}
+
+void Backend::retrieveCustomEmojisPage (int page, QJsonArray emojiList)
+{
+	NetworkRequest request ("emoji?page=" + QString::number (page) + "&per_page=" + QString::number (customEmojisPerPage));
+	httpConnector.get (request, HttpResponseCallback ([this, page, emojiList] (QVariant, QJsonDocument data) mutable {
 
 #if 0
 		QString jsonString = data.toJson(QJsonDocument::Indented);
 		qDebug() << "retrieveCustomEmojis reply: " << jsonString.toStdString().c_str();
 #endif
 
-		for (const auto& it: data.array()) {
-			QString emojiID = it.toObject().value("id").toString();
-			QString emojiName = it.toObject().value("name").toString();
-			retrieveCustomEmojiImage (emojiID, [emojiID, emojiName] (QByteArray data) {
+		QJsonArray pageList (data.array());
 
-				QDir cacheDir (QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
-				QDir emojiDir (cacheDir.filePath ("custom-emoji"));
+		for (const auto& it: pageList) {
+			QJsonObject emoji (it.toObject());
+			addCustomEmoji (emoji);
 
-				if (!emojiDir.exists()) {
-					emojiDir.mkpath(".");
-				}
+			//save only the needed fields
+			emojiList.push_back (QJsonObject {
+				{"id", emoji.value("id")},
+				{"name", emoji.value("name")},
+				{"update_at", emoji.value("update_at")},
+			});
+		}
 
-				QString filePath (emojiDir.filePath (emojiID + ".gif"));
-				QFile file (filePath);
+		//a full page means that there may be more emojis
+		if (pageList.size() == customEmojisPerPage) {
+			retrieveCustomEmojisPage (page + 1, emojiList);
+			return;
+		}
 
-				if (!file.open (QIODevice::WriteOnly)) {
-					qDebug() << "retrieveCustomEmojiImage: Cannot open " << filePath << ":" << file.errorString();
-					return;
-				}
+		LOG_DEBUG ("Custom emojis: " << emojiList.size());
+		saveCustomEmojiList (emojiList);
+	}));
+}
 
-				file.write (data);
-				file.close ();
-				EmojiInfo::addCustomEmoji (emojiName, filePath);
-			});
+void Backend::saveCustomEmojiList (const QJsonArray& emojiList)
+{
+	QSet<QString> emojiNames;
+	QSet<QString> imageKeys;
+
+	for (const auto& it: emojiList) {
+		QJsonObject emoji (it.toObject());
+		emojiNames.insert (emoji.value("name").toString());
+		imageKeys.insert (getCustomEmojiImageKey (emoji));
+	}
+
+	//emojis deleted on the server
+	EmojiInfo::retainCustomEmojis (emojiNames);
+
+	//the emoji namespace is not evicted, so the images of deleted and changed emojis are removed here
+	QByteArray savedList (cacheManager.get (CacheNamespace::emoji, customEmojiListCacheKey));
+
+	for (const auto& it: QJsonDocument::fromJson (savedList).array()) {
+		QString imageKey (getCustomEmojiImageKey (it.toObject()));
+
+		if (!imageKeys.contains (imageKey)) {
+			cacheManager.remove (CacheNamespace::emoji, imageKey);
 		}
-	}));
+	}
+
+	cacheManager.insert (CacheNamespace::emoji, customEmojiListCacheKey, QJsonDocument (emojiList).toJson (QJsonDocument::Compact),
+			QByteArray::number (QDateTime::currentMSecsSinceEpoch()));
+}
+
+void Backend::addNewCustomEmoji (const QJsonObject& emoji)
+{
+	addCustomEmoji (emoji);
+
+	QByteArray savedList (cacheManager.get (CacheNamespace::emoji, customEmojiListCacheKey));
+
+	//the list is being retrieved, it will contain the new emoji
+	if (savedList.isNull()) {
+		return;
+	}
+
+	QJsonArray emojiList (QJsonDocument::fromJson (savedList).array());
+	emojiList.push_back (QJsonObject {
+		{"id", emoji.value("id")},
+		{"name", emoji.value("name")},
+		{"update_at", emoji.value("update_at")},
+	});
+
+	//the retrieve time is kept, so that the list is still retrieved again when it gets old
+	cacheManager.insert (CacheNamespace::emoji, customEmojiListCacheKey, QJsonDocument (emojiList).toJson (QJsonDocument::Compact),
+			cacheManager.getMetaData (CacheNamespace::emoji, customEmojiListCacheKey));
+}
+
+void Backend::addCustomEmoji (const QJsonObject& emoji)
+{
+	EmojiInfo::addCustomEmoji (emoji.value("name").toString(), emoji.value("id").toString(), emoji.value("update_at").toVariant().toULongLong());
 }
 
-void Mattermost::Backend::retrieveCustomEmojiImage (const QString& emojiID, std::function <void (QByteArray)> callback)
+QString Backend::getCustomEmojiImage (const QString& emojiName, const QString& emojiID, uint64_t updateTime)
+{
+	QString cacheKey (getCustomEmojiImageKey (emojiID, updateTime));
+
+	QString filePath (cacheManager.getFilePath (CacheNamespace::emoji, cacheKey));
+
+	if (!filePath.isEmpty()) {
+		return filePath;
+	}
+
+	if (pendingCustomEmojiImages.contains (emojiID)) {
+		return QString ();
+	}
+
+	pendingCustomEmojiImages.insert (emojiID, emojiName);
+
+	retrieveCustomEmojiImage (emojiID, [this, emojiID, emojiName, cacheKey] (QByteArray data) {
+		pendingCustomEmojiImages.remove (emojiID);
+		cacheManager.insert (CacheNamespace::emoji, cacheKey, data);
+
+		QString filePath (cacheManager.getFilePath (CacheNamespace::emoji, cacheKey));
+
+		if (filePath.isEmpty()) {
+			qDebug() << "retrieveCustomEmojiImage: Cannot cache image for " << emojiName;
+			return;
+		}
+
+		EmojiInfo::setCustomEmojiImage (emojiName, filePath);
+		changedCustomEmojiImages.insert (emojiName);
+
+		if (!customEmojiImagesTimer.isActive()) {
+			customEmojiImagesTimer.start ();
+		}
+	}, [this, emojiID, emojiName] {
+		//the image is requested again the next time the emoji is used
+		pendingCustomEmojiImages.remove (emojiID);
+		EmojiInfo::resetCustomEmojiImageRequest (emojiName);
+	});
+
+	return QString ();
+}
+
+void Mattermost::Backend::retrieveCustomEmojiImage (const QString& emojiID, std::function <void (QByteArray)> callback, std::function<void()> failureCallback)
 {
 	NetworkRequest request ("emoji/" + emojiID + "/image");
-	httpConnector.get (request, HttpResponseCallback (callback));
+	httpConnector.get (request, HttpResponseCallback (callback), failureCallback);
 }
 
 const BackendUser& Backend::getLoginUser () const
@@ -1302,6 +1588,11 @@ Storage& Backend::getStorage ()
 	return storage;
 }
 
+CacheManager& Backend::getCacheManager ()
+{
+	return cacheManager;
+}
+
 ServerDialogsMap& Backend::getServerDialogsMap ()
 {
 	return serverDialogsMap;
@@ -27,9 +27,14 @@
 #include <QNetworkCookie>
 #include <QObject>
 #include <QList>
-#include <QNetworkDiskCache>
+#include <QSet>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
 
 #include "backend/types/BackendLoginData.h"
+#include "backend/types/BackendFile.h"
+#include "backend/CacheManager.h"
 #include "backend/HTTPConnector.h"
 #include "backend/WebSocketConnector.h"
 #include "backend/WebSocketEventHandler.h"
@@ -77,11 +82,14 @@ public:
 	//get all users (/users?per_page=200&page=pageIdx);
 	void retrieveAllUsers ();
 
-	//get user's avatar image (/users/userID/image). Emits BackendUser::onAvatarChanged
-	void retrieveUserAvatar (QString userID, uint64_t lastUpdateTime = 0);
+	//get user's avatar image (/users/userID/image). Notifies Storage::observers.user.avatarChanged.
+	//The request is skipped if the avatar is cached and its last_picture_update is the same
+	void retrieveUserAvatar (QString userID, uint64_t lastPictureUpdate = 0);
 
-	//get file (files/fileID)
-	void retrieveFile (QString fileID, std::function<void(const QByteArray&)> callback);
+	//get file (files/fileID, files/fileID/preview or files/fileID/thumbnail).
+	//Returns a handle for cancelling the request. If the file is cached, the handle also cancels reading it
+	//and the download, which is started if the cached file can not be read
+	HttpRequestHandle retrieveFile (QString fileID, std::function<void(const QByteArray&)> callback, FileTier::type tier = FileTier::original);
 
 	//get own teams (/users/me/teams)
 	void retrieveOwnTeams (std::function<void(BackendTeam&)> callback);
@@ -117,6 +125,12 @@ public:
 	//get channel's pinned posts (/channels/{channel_id}/pinned)
 	void retrieveChannelPinnedPosts (BackendChannel& channel);
 
+	//get a thread (root post and replies) in a channel (/posts/{post_id}/thread)
+	void retrievePostThread (BackendChannel& channel, const QString& rootId, std::function<void()> callback);
+
+	//search posts on the server, in a team and in the direct channels (/teams/{team_id}/posts/search)
+	void searchPosts (const QString& teamID, const QString& terms, std::function<void(std::list<BackendPost>&)> callback);
+
 	//get older posts in a channel (before the first one) (/channels/ID/posts)
 	void retrieveChannelOlderPosts (BackendChannel& channel, int perPage);
 
@@ -186,11 +200,14 @@ public:
 	//send a submit dialog response. In most cases, dialogs are handled by the UI
 	void sendSubmitDialog (const QJsonDocument& json);
 
-	//retrieve custom emojis (/emoji)
+	//retrieve custom emojis (/emoji). Only the emoji list is retrieved, images are retrieved when the emojis are used
 	void retrieveCustomEmojis ();
 
-	//retrieve custom emojis (/emoji/{emoji_id}/image)
-	void retrieveCustomEmojiImage (const QString& emojiID, std::function <void(QByteArray)> callback);
+	//add a custom emoji, created on the server after the emoji list was retrieved (emoji_added WebSocket event)
+	void addNewCustomEmoji (const QJsonObject& emoji);
+
+	//retrieve custom emojis (/emoji/{emoji_id}/image). failureCallback is called if the image can not be retrieved
+	void retrieveCustomEmojiImage (const QString& emojiID, std::function <void(QByteArray)> callback, std::function<void()> failureCallback = nullptr);
 
 	const BackendUser& getLoginUser () const;
 
@@ -199,6 +216,7 @@ public:
 	BackendChannel* getCurrentChannel () const;
 
 	Storage& getStorage ();
+	CacheManager& getCacheManager ();
 
 	ServerDialogsMap& getServerDialogsMap ();
 signals:
@@ -222,6 +240,20 @@ signals:
 	 * @param post post
 	 */
 	void onNewPost (BackendChannel& channel, const BackendPost& post);
+
+	/**
+	 * Called once for a batch of status changes. There is no notification per user:
+	 * views showing the status of one or many users check whether they are in the batch, and update all of them at once
+	 * @param userIDs IDs of the users, whose status has changed
+	 */
+	void onUserStatusesChanged (const QSet<QString>& userIDs);
+
+	/**
+	 * Called once for a batch of received custom emoji images. Until then, the emojis were shown by name,
+	 * so the views showing them render them again
+	 * @param emojiNames names of the custom emojis
+	 */
+	void onCustomEmojiImagesChanged (const QSet<QString>& emojiNames);
     void onAllUsers ();
 
     /**
@@ -243,16 +275,38 @@ signals:
     void onWebSocketDisconnect ();
 private:
     void loginSuccess (const QJsonDocument& data, const QNetworkReply& reply, std::function<void(const QString&)> callback);
+    void retrieveCustomEmojisPage (int page, QJsonArray emojiList);
+    void addCustomEmoji (const QJsonObject& emoji);
+
+    /**
+     * Save the complete custom emoji list. Emojis, which are not in the list any more, are removed
+     */
+    void saveCustomEmojiList (const QJsonArray& emojiList);
+    void setUserAvatar (const QString& userID, const QByteArray& data);
+
+    /**
+     * Get the image of a custom emoji from the cache. If it is not cached, retrieve it
+     * @return path to the image file, or empty string if it is being retrieved
+     */
+    QString getCustomEmojiImage (const QString& emojiName, const QString& emojiID, uint64_t updateTime);
 private:
     Storage							storage;
     ServerDialogsMap				serverDialogsMap;
 
+    //must be initialized before the HTTP connector, which uses it
+    CacheManager					cacheManager;
     HTTPConnector 					httpConnector;
     WebSocketEventHandler			webSocketEventHandler;
     WebSocketConnector				webSocketConnector;
     BackendLoginData				loginData;
-    QNetworkDiskCache				attachmentsCache;
     RequestTracker					requestTracker;
+
+    //emoji ID -> emoji name, for the custom emoji images being retrieved
+    QHash<QString, QString>			pendingCustomEmojiImages;
+
+    //custom emojis, whose images were received since the last onCustomEmojiImagesChanged
+    QSet<QString>					changedCustomEmojiImages;
+    QTimer							customEmojiImagesTimer;
     BackendChannel*					currentChannel;
     QTimer 							timeoutTimer;
     bool							isLoggedIn;
@@ -0,0 +1,639 @@
+/**
+ * @file CacheManager.cpp
+ * @brief Disk cache for all downloaded data (API responses, avatars, attachments, emoji images)
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "CacheManager.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QCoreApplication>
+#include <QRegularExpression>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include "Settings.h"
+#include "log.h"
+
+namespace Mattermost {
+
+static constexpr quint32 indexMagic = 0x4d4d4349;	//"MMCI"
+static constexpr quint32 indexVersion = 2;
+static constexpr const char* indexFileName = "index";
+static constexpr const char* blobsDirName = "blobs";
+
+//exists while there are blob files, which are not in the saved index
+static constexpr const char* unsavedBlobsMarkerName = "unsaved";
+
+//default cache budget, in megabytes
+static constexpr int defaultCacheSizeMB = 600;
+
+CacheManager::CacheManager ()
+:cacheDir (QDir (QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("store"))
+,maximumSize (defaultCacheSizeMB * 1024LL * 1024LL)
+,totalSize (0)
+,nextGeneration (1)
+,hasUnsavedBlobs (false)
+{
+	if (!cacheDir.exists (indexFileName)) {
+		removeLegacyCaches ();
+	}
+
+	cacheDir.mkpath (blobsDirName);
+
+	readSettings ();
+	loadIndex ();
+
+	//the application exited after writing blob files, but before saving the index
+	if (cacheDir.exists (unsavedBlobsMarkerName)) {
+		removeOrphanedBlobs ();
+		cacheDir.remove (unsavedBlobsMarkerName);
+	}
+
+	//reading cached files is limited by the disk, not by the CPU
+	readThreadPool.setMaxThreadCount (2);
+
+	saveIndexTimer.setSingleShot (true);
+	QObject::connect (&saveIndexTimer, &QTimer::timeout, [this] {
+		saveIndex ();
+	});
+}
+
+CacheManager::~CacheManager ()
+{
+	readThreadPool.waitForDone ();
+
+	flush ();
+}
+
+void CacheManager::flush ()
+{
+	if (saveIndexTimer.isActive()) {
+		saveIndex ();
+	}
+}
+
+void CacheManager::readSettings ()
+{
+	QSettings settings;
+	setMaximumSize (settings.value (CACHE_MAX_SIZE, defaultCacheSizeMB).toLongLong() * 1024 * 1024);
+}
+
+void CacheManager::setMaximumSize (qint64 size)
+{
+	maximumSize = size;
+	evict ();
+}
+
+qint64 CacheManager::getMaximumSize () const
+{
+	return maximumSize;
+}
+
+qint64 CacheManager::getSize () const
+{
+	return totalSize;
+}
+
+bool CacheManager::contains (CacheNamespace::type ns, const QString& key) const
+{
+	return entryMap.contains (getEntryID (ns, key));
+}
+
+QByteArray CacheManager::get (CacheNamespace::type ns, const QString& key)
+{
+	auto it = findEntry (ns, key);
+
+	if (it == entries.end()) {
+		++stats[ns].misses;
+		return QByteArray ();
+	}
+
+	QFile file (getBlobPath (it->hash));
+
+	if (!file.open (QIODevice::ReadOnly)) {
+		//the file was removed from outside
+		LOG_DEBUG ("CacheManager: cannot open " << file.fileName() << ": " << file.errorString());
+		removeEntry (it);
+		++stats[ns].misses;
+		return QByteArray ();
+	}
+
+	++stats[ns].hits;
+	touchEntry (it);
+	return file.readAll ();
+}
+
+class CacheReadTask: public QRunnable {
+public:
+	CacheReadTask (const QString& filePath, std::function<void(const QByteArray&)> callback)
+	:filePath (filePath)
+	,callback (callback)
+	{
+	}
+
+	void run () override
+	{
+		QFile file (filePath);
+
+		//a null QByteArray is passed only if the file can not be read
+		if (!file.open (QIODevice::ReadOnly)) {
+			callback (QByteArray ());
+			return;
+		}
+
+		QByteArray data (file.readAll ());
+		callback (data.isNull() ? QByteArray ("") : data);
+	}
+private:
+	QString									filePath;
+	std::function<void(const QByteArray&)>	callback;
+};
+
+void CacheManager::getAsync (CacheNamespace::type ns, const QString& key, std::function<void(const QByteArray&)> callback)
+{
+	auto it = findEntry (ns, key);
+
+	if (it == entries.end()) {
+		++stats[ns].misses;
+
+		//the callback is not called in the same stack frame, regardless of whether the entry exists
+		QMetaObject::invokeMethod (QCoreApplication::instance(), [callback] {
+			callback (QByteArray ());
+		}, Qt::QueuedConnection);
+		return;
+	}
+
+	++stats[ns].hits;
+	touchEntry (it);
+
+	uint64_t generation = it->generation;
+
+	auto deliverData = [this, ns, key, generation, callback] (const QByteArray& data) {
+		QMetaObject::invokeMethod (QCoreApplication::instance(), [this, ns, key, generation, callback, data] {
+
+			//the file was removed (evicted or removed from outside), before it was read
+			if (data.isNull()) {
+				LOG_DEBUG ("CacheManager: cannot read entry " << key);
+				auto it = findEntry (ns, key);
+
+				//the entry may have been replaced in the meantime. The new entry is not removed
+				if (it != entries.end() && it->generation == generation) {
+					removeEntry (it);
+					scheduleSaveIndex ();
+				}
+			}
+
+			callback (data);
+		}, Qt::QueuedConnection);
+	};
+
+	readThreadPool.start (new CacheReadTask (getBlobPath (it->hash), deliverData));
+}
+
+QString CacheManager::getFilePath (CacheNamespace::type ns, const QString& key)
+{
+	auto it = findEntry (ns, key);
+
+	if (it == entries.end()) {
+		++stats[ns].misses;
+		return QString ();
+	}
+
+	QString filePath (getBlobPath (it->hash));
+
+	if (!QFile::exists (filePath)) {
+		removeEntry (it);
+		++stats[ns].misses;
+		return QString ();
+	}
+
+	++stats[ns].hits;
+	touchEntry (it);
+	return filePath;
+}
+
+void CacheManager::insert (CacheNamespace::type ns, const QString& key, const QByteArray& data, const QByteArray& metaData)
+{
+	//entries bigger than the whole budget are not cached
+	if (data.size() > maximumSize) {
+		return;
+	}
+
+	QByteArray hash (QCryptographicHash::hash (data, QCryptographicHash::Sha1).toHex());
+
+	auto it = findEntry (ns, key);
+
+	if (it != entries.end()) {
+		if (it->hash == hash) {
+			it->metaData = metaData;
+			touchEntry (it);
+			return;
+		}
+
+		removeEntry (it);
+	}
+
+	//identical data is already stored, for another entry
+	if (!blobs.contains (hash)) {
+		QString blobPath (getBlobPath (hash));
+		QDir().mkpath (QFileInfo (blobPath).path());
+
+		QSaveFile file (blobPath);
+
+		if (!file.open (QIODevice::WriteOnly)) {
+			LOG_DEBUG ("CacheManager: cannot open " << blobPath << ": " << file.errorString());
+			return;
+		}
+
+		//if the application exits before the index is saved, the file is removed on the next start
+		if (!hasUnsavedBlobs) {
+			QFile marker (cacheDir.filePath (unsavedBlobsMarkerName));
+			marker.open (QIODevice::WriteOnly);
+			hasUnsavedBlobs = true;
+		}
+
+		file.write (data);
+
+		if (!file.commit ()) {
+			LOG_DEBUG ("CacheManager: cannot write " << blobPath << ": " << file.errorString());
+			return;
+		}
+	}
+
+	addBlobReference (hash, data.size());
+
+	entries.push_back (Entry {ns, key, hash, data.size(), metaData, nextGeneration++});
+	entryMap.insert (getEntryID (ns, key), std::prev (entries.end()));
+
+	CacheStats& nsStats = stats[ns];
+	++nsStats.insertions;
+	++nsStats.entries;
+	nsStats.size += data.size();
+
+	evict ();
+	scheduleSaveIndex ();
+}
+
+QByteArray CacheManager::getMetaData (CacheNamespace::type ns, const QString& key) const
+{
+	auto it = entryMap.find (getEntryID (ns, key));
+
+	if (it == entryMap.end()) {
+		return QByteArray ();
+	}
+
+	//an empty, but not null array, so that it can be distinguished from a missing entry
+	const QByteArray& metaData = it.value()->metaData;
+	return metaData.isNull() ? QByteArray ("") : metaData;
+}
+
+bool CacheManager::setMetaData (CacheNamespace::type ns, const QString& key, const QByteArray& metaData)
+{
+	auto it = findEntry (ns, key);
+
+	if (it == entries.end()) {
+		return false;
+	}
+
+	it->metaData = metaData;
+	scheduleSaveIndex ();
+	return true;
+}
+
+bool CacheManager::remove (CacheNamespace::type ns, const QString& key)
+{
+	auto it = findEntry (ns, key);
+
+	if (it == entries.end()) {
+		return false;
+	}
+
+	removeEntry (it);
+	scheduleSaveIndex ();
+	return true;
+}
+
+void CacheManager::clear (CacheNamespace::type ns)
+{
+	for (auto it = entries.begin(); it != entries.end();) {
+		auto next = std::next (it);
+
+		if (it->ns == ns) {
+			removeEntry (it);
+		}
+
+		it = next;
+	}
+
+	scheduleSaveIndex ();
+}
+
+CacheStats CacheManager::getStats () const
+{
+	CacheStats ret;
+
+	for (const CacheStats& nsStats: stats) {
+		ret.hits += nsStats.hits;
+		ret.misses += nsStats.misses;
+		ret.insertions += nsStats.insertions;
+		ret.evictions += nsStats.evictions;
+		ret.entries += nsStats.entries;
+	}
+
+	//identical data in different entries is stored once
+	ret.size = totalSize;
+	return ret;
+}
+
+CacheStats CacheManager::getStats (CacheNamespace::type ns) const
+{
+	return stats[ns];
+}
+
+qint64 CacheManager::getIndexMemoryUsage (CacheNamespace::type ns) const
+{
+	qint64 size = 0;
+
+	for (const Entry& entry: entries) {
+		if (entry.ns != ns) {
+			continue;
+		}
+
+		//the list node, the key (also used in the entry map, with the namespace prefix), the hash, the meta data and the entry map node
+		size += sizeof (Entry) + 2 * sizeof (void*)
+				+ 2 * (entry.key.capacity() + 1) * sizeof (QChar)
+				+ entry.hash.capacity() + 1
+				+ entry.metaData.capacity()
+				+ sizeof (QString) + sizeof (EntryList::iterator) + 2 * sizeof (void*);
+	}
+
+	return size;
+}
+
+const char* CacheManager::getNamespaceName (CacheNamespace::type ns)
+{
+	switch (ns) {
+	case CacheNamespace::api:
+		return "API";
+	case CacheNamespace::avatars:
+		return "Avatars";
+	case CacheNamespace::attachments:
+		return "Attachments";
+	case CacheNamespace::thumbnails:
+		return "Thumbnails";
+	case CacheNamespace::emoji:
+		return "Emoji";
+	default:
+		return "Unknown";
+	}
+}
+
+bool CacheManager::isPinned (CacheNamespace::type ns)
+{
+	//custom emoji images are referenced by file path from the rendered text, so the files must stay
+	return ns == CacheNamespace::emoji;
+}
+
+QString CacheManager::getEntryID (CacheNamespace::type ns, const QString& key)
+{
+	return QString::number (ns) + '/' + key;
+}
+
+QString CacheManager::getBlobPath (const QByteArray& hash) const
+{
+	//split the blobs into subdirectories, to avoid too many files in a single directory
+	QString hashStr (QString::fromLatin1 (hash));
+	return cacheDir.filePath (QString (blobsDirName) + '/' + hashStr.left (2) + '/' + hashStr);
+}
+
+CacheManager::EntryList::iterator CacheManager::findEntry (CacheNamespace::type ns, const QString& key)
+{
+	auto it = entryMap.find (getEntryID (ns, key));
+
+	if (it == entryMap.end()) {
+		return entries.end();
+	}
+
+	return it.value();
+}
+
+void CacheManager::touchEntry (EntryList::iterator it)
+{
+	//move the entry to the end of the list (most recently used). Iterators remain valid
+	entries.splice (entries.end(), entries, it);
+	scheduleSaveIndex ();
+}
+
+void CacheManager::removeEntry (EntryList::iterator it)
+{
+	CacheStats& nsStats = stats[it->ns];
+	--nsStats.entries;
+	nsStats.size -= it->size;
+
+	releaseBlob (it->hash);
+	entryMap.remove (getEntryID (it->ns, it->key));
+	entries.erase (it);
+}
+
+void CacheManager::addBlobReference (const QByteArray& hash, qint64 size)
+{
+	auto it = blobs.find (hash);
+
+	if (it != blobs.end()) {
+		++it->refCount;
+		return;
+	}
+
+	blobs.insert (hash, Blob {size, 1});
+	totalSize += size;
+}
+
+void CacheManager::releaseBlob (const QByteArray& hash)
+{
+	auto it = blobs.find (hash);
+
+	if (it == blobs.end()) {
+		return;
+	}
+
+	if (--it->refCount > 0) {
+		return;
+	}
+
+	totalSize -= it->size;
+	QFile::remove (getBlobPath (hash));
+	blobs.erase (it);
+}
+
+void CacheManager::evict ()
+{
+	qint64 pinnedSize = getPinnedSize ();
+	auto it = entries.begin();
+
+	while (totalSize - pinnedSize > maximumSize && it != entries.end()) {
+		auto next = std::next (it);
+
+		if (!isPinned (it->ns)) {
+			++stats[it->ns].evictions;
+			removeEntry (it);
+		}
+
+		it = next;
+	}
+}
+
+qint64 CacheManager::getPinnedSize () const
+{
+	qint64 size = 0;
+
+	for (int ns = 0; ns < CacheNamespace::count; ++ns) {
+		if (isPinned ((CacheNamespace::type) ns)) {
+			size += stats[ns].size;
+		}
+	}
+
+	return size;
+}
+
+void CacheManager::removeOrphanedBlobs ()
+{
+	QDirIterator it (cacheDir.filePath (blobsDirName), QDir::Files, QDirIterator::Subdirectories);
+	int removedCount = 0;
+
+	while (it.hasNext()) {
+		it.next ();
+
+		//unfinished QSaveFile temporary files are also removed
+		if (!blobs.contains (it.fileName().toLatin1())) {
+			QFile::remove (it.filePath());
+			++removedCount;
+		}
+	}
+
+	LOG_DEBUG ("CacheManager: " << removedCount << " files, missing in the index, are removed");
+}
+
+void CacheManager::loadIndex ()
+{
+	QFile file (cacheDir.filePath (indexFileName));
+
+	if (!file.open (QIODevice::ReadOnly)) {
+		return;
+	}
+
+	QDataStream stream (&file);
+
+	quint32 magic, version, count;
+	stream >> magic >> version >> count;
+
+	if (magic != indexMagic || version != indexVersion) {
+		LOG_DEBUG ("CacheManager: unknown index format. Starting with an empty cache");
+		file.close ();
+		QDir (cacheDir.filePath (blobsDirName)).removeRecursively ();
+		cacheDir.mkpath (blobsDirName);
+		return;
+	}
+
+	for (quint32 i = 0; i < count; ++i) {
+		qint32 ns;
+		Entry entry;
+		stream >> ns >> entry.key >> entry.hash >> entry.size >> entry.metaData;
+
+		if (stream.status() != QDataStream::Ok || ns < 0 || ns >= CacheNamespace::count) {
+			LOG_DEBUG ("CacheManager: index is corrupted. " << i << " of " << count << " entries are loaded");
+			break;
+		}
+
+		entry.ns = (CacheNamespace::type) ns;
+		entry.generation = nextGeneration++;
+
+		addBlobReference (entry.hash, entry.size);
+		entries.push_back (entry);
+		entryMap.insert (getEntryID (entry.ns, entry.key), std::prev (entries.end()));
+
+		CacheStats& nsStats = stats[entry.ns];
+		++nsStats.entries;
+		nsStats.size += entry.size;
+	}
+
+	LOG_DEBUG ("CacheManager: " << entries.size() << " entries, " << totalSize / 1024 << " KB");
+
+	//the budget may have been decreased since the last start
+	evict ();
+}
+
+void CacheManager::saveIndex ()
+{
+	saveIndexTimer.stop ();
+
+	QSaveFile file (cacheDir.filePath (indexFileName));
+
+	if (!file.open (QIODevice::WriteOnly)) {
+		LOG_DEBUG ("CacheManager: cannot save index: " << file.errorString());
+		return;
+	}
+
+	QDataStream stream (&file);
+	stream << indexMagic << indexVersion << (quint32) entries.size();
+
+	//the entries are saved in LRU order, so that it is preserved after restart
+	for (const Entry& entry: entries) {
+		stream << (qint32) entry.ns << entry.key << entry.hash << entry.size << entry.metaData;
+	}
+
+	if (file.commit () && hasUnsavedBlobs) {
+		cacheDir.remove (unsavedBlobsMarkerName);
+		hasUnsavedBlobs = false;
+	}
+}
+
+void CacheManager::scheduleSaveIndex ()
+{
+	//write the index at most once every few seconds, not on every cache access
+	if (!saveIndexTimer.isActive()) {
+		saveIndexTimer.start (10000);
+	}
+}
+
+void CacheManager::removeLegacyCaches ()
+{
+	/*
+	 * Remove the caches used by older versions: two QNetworkDiskCache instances
+	 * (one in the cache location directly, one in 'attachments') and the custom emoji directory
+	 */
+	QDir cacheLocation (QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+	QRegularExpression diskCacheDir ("^data\\d+$");
+
+	for (const QString& dirName: cacheLocation.entryList (QDir::Dirs | QDir::NoDotAndDotDot)) {
+		if (diskCacheDir.match (dirName).hasMatch() || dirName == "prepared" || dirName == "attachments" || dirName == "custom-emoji") {
+			LOG_DEBUG ("CacheManager: remove legacy cache directory " << dirName);
+			QDir (cacheLocation.filePath (dirName)).removeRecursively ();
+		}
+	}
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,222 @@
+/**
+ * @file CacheManager.h
+ * @brief Disk cache for all downloaded data (API responses, avatars, attachments, emoji images)
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDir>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <functional>
+#include <list>
+
+namespace Mattermost {
+
+namespace CacheNamespace {
+enum type {
+	api,			///< responses cached by QNetworkAccessManager
+	avatars,		///< user avatars
+	attachments,	///< original attached files
+	thumbnails,		///< server-generated previews and thumbnails of attached images
+	emoji,			///< custom emoji images. Never evicted, because their file paths are used in rendered posts
+	count
+};
+}
+
+/**
+ * Statistics for a cache namespace (or for the whole cache)
+ */
+struct CacheStats {
+	uint64_t	hits = 0;
+	uint64_t	misses = 0;
+	uint64_t	insertions = 0;
+	uint64_t	evictions = 0;
+	qint64		size = 0;
+	uint32_t	entries = 0;
+};
+
+/**
+ * Content-addressed disk cache, shared by all cache users.
+ * Entries are identified by namespace and key. The data of each entry is stored in a file, named
+ * by the SHA1 hash of the data, so identical data (for example, the same image, cached under
+ * different keys) is stored only once.
+ * The total size is limited by a single budget. When it is exceeded, the least recently used entries are evicted.
+ * Entries in pinned namespaces (see isPinned()) are never evicted and are not counted against the budget.
+ * The list of entries is kept in an index file, so the cache directory is not scanned on startup.
+ * It is scanned only if the application exited before saving the index, to remove the files missing in the index.
+ */
+class CacheManager {
+public:
+	CacheManager ();
+	~CacheManager ();
+
+	/**
+	 * Read the cache budget from the settings
+	 */
+	void readSettings ();
+
+	void setMaximumSize (qint64 size);
+	qint64 getMaximumSize () const;
+
+	/**
+	 * Save the index now, if it has changed. Used before exiting without destroying the cache manager
+	 */
+	void flush ();
+
+	/**
+	 * Get the size of all cached data (identical data is counted once)
+	 */
+	qint64 getSize () const;
+
+	bool contains (CacheNamespace::type ns, const QString& key) const;
+
+	/**
+	 * Get cached data. Marks the entry as recently used
+	 * @return the cached data, or a null QByteArray if there is no such entry
+	 */
+	QByteArray get (CacheNamespace::type ns, const QString& key);
+
+	/**
+	 * Get cached data, without blocking the calling (GUI) thread. The file is read in a worker thread.
+	 * The callback is called in the GUI thread, never in the same stack frame.
+	 * Marks the entry as recently used
+	 * @param callback called with the cached data, or with a null QByteArray if there is no such entry
+	 */
+	void getAsync (CacheNamespace::type ns, const QString& key, std::function<void(const QByteArray&)> callback);
+
+	/**
+	 * Get the path of the file, containing the cached data. The file may be removed
+	 * when the entry is evicted, so the path should not be kept for long, unless the namespace is pinned
+	 * @return the file path, or empty string if there is no such entry
+	 */
+	QString getFilePath (CacheNamespace::type ns, const QString& key);
+
+	/**
+	 * Add an entry or replace an existing one. Evicts old entries if the budget is exceeded
+	 * @param metaData small data, describing the entry. It is kept in memory (and in the index file),
+	 *        separately from the cached data
+	 */
+	void insert (CacheNamespace::type ns, const QString& key, const QByteArray& data, const QByteArray& metaData = QByteArray());
+
+	/**
+	 * Get the meta data of an entry, without reading the cached data. Does not mark the entry
+	 * as recently used and does not affect the statistics
+	 * @return the meta data, or a null QByteArray if there is no such entry
+	 */
+	QByteArray getMetaData (CacheNamespace::type ns, const QString& key) const;
+
+	/**
+	 * Replace the meta data of an existing entry. The cached data is not changed
+	 * @return false if there is no such entry
+	 */
+	bool setMetaData (CacheNamespace::type ns, const QString& key, const QByteArray& metaData);
+
+	bool remove (CacheNamespace::type ns, const QString& key);
+
+	/**
+	 * Remove all entries in a namespace
+	 */
+	void clear (CacheNamespace::type ns);
+
+	CacheStats getStats () const;
+	CacheStats getStats (CacheNamespace::type ns) const;
+
+	/**
+	 * Estimate the memory used by the in-memory index of a namespace (the cached data itself is on disk)
+	 */
+	qint64 getIndexMemoryUsage (CacheNamespace::type ns) const;
+
+	static const char* getNamespaceName (CacheNamespace::type ns);
+
+	/**
+	 * Entries in pinned namespaces are not evicted. They can only be replaced or removed explicitly
+	 */
+	static bool isPinned (CacheNamespace::type ns);
+private:
+	struct Entry {
+		CacheNamespace::type				ns;
+		QString								key;
+		QByteArray							hash;
+		qint64								size;
+		QByteArray							metaData;
+
+		//distinguishes an entry from the entries, which had the same key before it
+		uint64_t							generation;
+	};
+
+	using EntryList = std::list<Entry>;
+
+	struct Blob {
+		qint64								size;
+		uint32_t							refCount;
+	};
+
+	static QString getEntryID (CacheNamespace::type ns, const QString& key);
+	QString getBlobPath (const QByteArray& hash) const;
+	EntryList::iterator findEntry (CacheNamespace::type ns, const QString& key);
+	void touchEntry (EntryList::iterator it);
+	void removeEntry (EntryList::iterator it);
+	void addBlobReference (const QByteArray& hash, qint64 size);
+	void releaseBlob (const QByteArray& hash);
+	void evict ();
+
+	/**
+	 * Size of the entries in pinned namespaces, which is not counted against the budget
+	 */
+	qint64 getPinnedSize () const;
+
+	/**
+	 * Remove the blob files, which are not referenced by the index
+	 */
+	void removeOrphanedBlobs ();
+
+	void loadIndex ();
+	void saveIndex ();
+	void scheduleSaveIndex ();
+	void removeLegacyCaches ();
+
+private:
+	QDir									cacheDir;
+
+	//entries, ordered from the least to the most recently used
+	EntryList								entries;
+	QHash<QString, EntryList::iterator>		entryMap;
+	QHash<QByteArray, Blob>					blobs;
+
+	qint64									maximumSize;
+	qint64									totalSize;
+	uint64_t								nextGeneration;
+	CacheStats								stats[CacheNamespace::count];
+	QTimer									saveIndexTimer;
+
+	//blob files were written after the index was saved. They are not in the index file yet
+	bool									hasUnsavedBlobs;
+
+	//used for asynchronous reads
+	QThreadPool								readThreadPool;
+};
+
+} /* namespace Mattermost */
@@ -0,0 +1,175 @@
+/**
+ * @file EntityObservers.h
+ * @brief Change notifications of users, channels and teams
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "ObserverRegistry.h"
+
+namespace Mattermost {
+
+class BackendUser;
+class BackendChannel;
+class BackendPost;
+struct ChannelNewPosts;
+
+/**
+ * Changes of a BackendUser, keyed by user ID
+ */
+struct UserObservers {
+
+	/**
+	 * Called when the user's avatar is obtained (after login)
+	 * or when the user changes it's avatar
+	 */
+	ObserverRegistry<const BackendUser&>		avatarChanged;
+
+	//status changes are notified once per batch, by Backend::onUserStatusesChanged
+};
+
+/**
+ * Changes of a BackendChannel, keyed by channel ID
+ */
+struct ChannelObservers {
+
+	/**
+	 * Called when a channel is being viewed, either from this or from another Mattermost instance.
+	 * Same notification as Backend::onChannelViewed()
+	 */
+	ObserverRegistry<>							viewed;
+
+	/**
+	 * Called when a channel is being updated. For example, changing the channel title or image
+	 */
+	ObserverRegistry<>							updated;
+
+	/**
+	 * Called when new posts are received.
+	 * Either after init or after WebSocket disconnect. Only the missing posts are passed
+	 */
+	ObserverRegistry<const ChannelNewPosts&>	newPosts;
+
+	/**
+	 * Called when pinned posts are received.
+	 * Either after init or after WebSocket disconnect.
+	 */
+	ObserverRegistry<>							pinnedPostsReceived;
+
+	/**
+	 * Called when a new post has arrived in the channel
+	 * Same notification as Backend::onNewPost()
+	 */
+	ObserverRegistry<BackendPost&>				newPost;
+
+	/**
+	 * Called when a post is being edited
+	 */
+	ObserverRegistry<BackendPost&>				postEdited;
+
+	/**
+	 * Called when a post reaction is being updated (added or removed)
+	 */
+	ObserverRegistry<BackendPost&>				postReactionUpdated;
+
+	/**
+	 * Called when a post is being deleted. The post ID is passed
+	 */
+	ObserverRegistry<const QString&>			postDeleted;
+
+	/**
+	 * Called when someone is typing in the channel.
+	 * Typing notifications are sent ~every 5 seconds, while the user is typing
+	 */
+	ObserverRegistry<const BackendUser&>		userTyping;
+
+	/**
+	 * Called when the logged-in user is removed from the channel, or has left the channel
+	 */
+	ObserverRegistry<>							leave;
+
+	/**
+	 * Called when a user has been added to the channel
+	 */
+	ObserverRegistry<const BackendUser&>		userAdded;
+
+	/**
+	 * Called when a user (other than the logged-in user) has been removed from the channel
+	 */
+	ObserverRegistry<const BackendUser&>		userRemoved;
+};
+
+/**
+ * Changes of a BackendTeam, keyed by team ID.
+ * BackendDirectChannelsTeam (direct and group channels) use their fixed IDs
+ */
+struct TeamObservers {
+
+	/**
+	 * Called when the logged-in user is removed from the team, or has left the team
+	 */
+	ObserverRegistry<>							leave;
+
+	ObserverRegistry<BackendChannel&>			newChannel;
+
+	ObserverRegistry<const BackendUser&>		userAdded;
+
+	/**
+	 * Called when a user (other than the logged-in user) has been removed from the team
+	 */
+	ObserverRegistry<const BackendUser&>		userRemoved;
+};
+
+/**
+ * Change notifications of the entities in Storage. Replaces a QObject (and its signals) per entity:
+ * an entity, which nobody observes, has no notification overhead at all
+ */
+struct EntityObservers {
+	void clear ()
+	{
+		user.avatarChanged.clear ();
+
+		channel.viewed.clear ();
+		channel.updated.clear ();
+		channel.newPosts.clear ();
+		channel.pinnedPostsReceived.clear ();
+		channel.newPost.clear ();
+		channel.postEdited.clear ();
+		channel.postReactionUpdated.clear ();
+		channel.postDeleted.clear ();
+		channel.userTyping.clear ();
+		channel.leave.clear ();
+		channel.userAdded.clear ();
+		channel.userRemoved.clear ();
+
+		team.leave.clear ();
+		team.newChannel.clear ();
+		team.userAdded.clear ();
+		team.userRemoved.clear ();
+	}
+
+	UserObservers			user;
+	ChannelObservers		channel;
+	TeamObservers			team;
+};
+
+} /* namespace Mattermost */
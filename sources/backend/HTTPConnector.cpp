@@ -24,47 +24,384 @@
 
 #include "HTTPConnector.h"
 
+#include <algorithm>
 #include <QAbstractNetworkCache>
+#include <QDataStream>
 #include <QNetworkAccessManager>
-#include <QNetworkDiskCache>
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QStandardPaths>
 #include <QNetworkReply>
+#include <QTimer>
 #include "QByteArrayCreator.h"
+#include "NetworkCache.h"
+#include "Trace.h"
+#include "TrafficCapture.h"
 #include "log.h"
 
 namespace Mattermost {
 
-static QNetworkDiskCache* createDiskCache ()
+HTTPConnector::HTTPConnector (CacheManager& cacheManager)
+:qnetworkManager (TrafficCapture::createNetworkAccessManager ())
+,cacheManager (cacheManager)
+,nextSubscriberID (1)
 {
-	QNetworkDiskCache* diskCache = new QNetworkDiskCache ();
-	diskCache->setCacheDirectory (QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
-	diskCache->setMaximumCacheSize (300 * 1024 * 1024);
-	return diskCache;
+	//qnetworkManager takes ownership over the network cache. The cached data itself is kept in the cache manager
+	qnetworkManager->setCache (new NetworkCache (cacheManager));
 }
 
-HTTPConnector::HTTPConnector ()
-:qnetworkManager (std::make_unique <QNetworkAccessManager> ())
+HTTPConnector::~HTTPConnector () = default;
+
+void HTTPConnector::reset ()
 {
-	//qnetworkManager takes ownership over the disk cache
-	qnetworkManager->setCache (createDiskCache ());
+	//all requests in progress are destroyed together with the network access manager
+	sharedRequests.clear ();
+	recreateNetworkManager ();
 }
 
-HTTPConnector::~HTTPConnector () = default;
+void HTTPConnector::reconnect ()
+{
+	/*
+	 * The replies are destroyed together with the network access manager, but the journal
+	 * of GET requests in progress is kept. GET requests are idempotent, so they are sent again
+	 * and their responses are delivered to the callbacks, which were not cancelled meanwhile
+	 */
+	for (auto& sharedRequest: sharedRequests) {
+		sharedRequest.reply = nullptr;
+		sharedRequest.replayed = true;
+		sharedRequest.attempt = 0;
+	}
 
-void HTTPConnector::reset ()
+	recreateNetworkManager ();
+
+	if (!sharedRequests.isEmpty()) {
+		LOG_DEBUG ("Replay " << sharedRequests.size() << " GET requests");
+	}
+
+	for (const QString& key: sharedRequests.keys()) {
+		sendSharedRequest (key);
+	}
+}
+
+void HTTPConnector::recreateNetworkManager ()
 {
-	//qnetworkManager takes ownership over the disk cache
-	qnetworkManager.reset(new QNetworkAccessManager());
-	qnetworkManager->setCache (createDiskCache ());
+	//qnetworkManager takes ownership over the network cache
+	qnetworkManager.reset (TrafficCapture::createNetworkAccessManager ());
+	qnetworkManager->setCache (new NetworkCache (cacheManager));
 }
 
-void HTTPConnector::get (const QNetworkRequest& request, HttpResponseCallback responseHandler)
+bool HTTPConnector::isConnectionError (const QNetworkReply& reply)
 {
-	QNetworkReply* reply = qnetworkManager->get (request);
-	setProcessReply (reply, std::move (responseHandler));
+	//there is no HTTP status code if the server was not reached at all
+	return reply.error() != QNetworkReply::NoError
+			&& reply.error() != QNetworkReply::OperationCanceledError
+			&& !reply.attribute (QNetworkRequest::HttpStatusCodeAttribute).isValid();
+}
+
+bool HTTPConnector::isRetriedReplay (const SharedRequest& request, const QNetworkReply& reply)
+{
+	return request.reply == &reply && request.replayed && isConnectionError (reply) && request.attempt < maxReplayAttempts;
+}
+
+HttpRequestHandle::HttpRequestHandle ()
+:subscriberID (0)
+{
+}
+
+HttpRequestHandle::HttpRequestHandle (HTTPConnector* connector, const QString& key, uint64_t subscriberID)
+:connector (connector)
+,key (key)
+,subscriberID (subscriberID)
+{
+}
+
+HttpRequestHandle HttpRequestHandle::createDeferred ()
+{
+	HttpRequestHandle handle;
+	handle.deferred = std::make_shared<DeferredState> ();
+	return handle;
+}
+
+void HttpRequestHandle::cancel ()
+{
+	if (deferred) {
+		deferred->waiting = false;
+		deferred->request.cancel ();
+		return;
+	}
+
+	if (connector) {
+		connector->unsubscribe (key, subscriberID);
+	}
+}
+
+bool HttpRequestHandle::isPending () const
+{
+	if (deferred) {
+		return deferred->waiting || deferred->request.isPending ();
+	}
+
+	return connector && connector->isSubscribed (key, subscriberID);
+}
+
+void HttpRequestHandle::setDeferredRequest (const HttpRequestHandle& request)
+{
+	if (!deferred) {
+		return;
+	}
+
+	deferred->waiting = false;
+	deferred->request = request;
+}
+
+void HttpRequestHandle::finishDeferred ()
+{
+	if (deferred) {
+		deferred->waiting = false;
+	}
+}
+
+HttpRequestList::~HttpRequestList ()
+{
+	cancelAll ();
+}
+
+void HttpRequestList::add (const HttpRequestHandle& request)
+{
+	requests.erase (std::remove_if (requests.begin(), requests.end(), [] (const HttpRequestHandle& request) {
+		return !request.isPending();
+	}), requests.end());
+
+	requests.push_back (request);
+}
+
+void HttpRequestList::cancelAll ()
+{
+	for (HttpRequestHandle& request: requests) {
+		request.cancel ();
+	}
+
+	requests.clear ();
+}
+
+HttpRequestHandle HTTPConnector::get (const QNetworkRequest& request, HttpResponseCallback responseHandler, std::function<void()> failureHandler)
+{
+	return getShared (request.url().toString(), request, false, CacheNamespace::api, std::move (responseHandler), std::move (failureHandler));
+}
+
+HttpRequestHandle HTTPConnector::getRevalidated (const QNetworkRequest& request, CacheNamespace::type ns, HttpResponseCallback responseHandler)
+{
+	//revalidated requests are processed differently, so they are not shared with requests sent by get()
+	return getShared ("revalidated:" + request.url().toString(), request, true, ns, std::move (responseHandler));
+}
+
+HttpRequestHandle HTTPConnector::getShared (const QString& key, const QNetworkRequest& request, bool revalidated, CacheNamespace::type ns, HttpResponseCallback responseHandler, std::function<void()> failureHandler)
+{
+	auto it = sharedRequests.find (key);
+
+	//the same url is not being retrieved yet
+	if (it == sharedRequests.end()) {
+		it = sharedRequests.insert (key, SharedRequest {nullptr, {}, request, ns, revalidated, false, 0});
+		sendSharedRequest (key);
+	}
+
+	uint64_t subscriberID = nextSubscriberID++;
+	it->subscribers.push_back (Subscriber {subscriberID, std::move (responseHandler), std::move (failureHandler)});
+
+	//LOG_DEBUG ("Shared GET " << key << ": " << it->subscribers.size() << " callbacks");
+	return HttpRequestHandle (this, key, subscriberID);
+}
+
+void HTTPConnector::sendSharedRequest (const QString& key)
+{
+	auto it = sharedRequests.find (key);
+
+	if (it == sharedRequests.end()) {
+		return;
+	}
+
+	QNetworkReply* reply;
+
+	if (it->revalidated) {
+		reply = sendRevalidatedRequest (key, it->request, it->ns);
+	} else {
+		reply = qnetworkManager->get (it->request);
+
+		setProcessReply (reply, [this, key] (QVariant statusCode, QByteArray data, const QNetworkReply& reply) {
+			deliverResponse (key, statusCode, data, reply);
+		});
+	}
+
+	it->reply = reply;
+	trackSharedRequest (key, reply);
+}
+
+QNetworkReply* HTTPConnector::sendRevalidatedRequest (const QString& key, const QNetworkRequest& request, CacheNamespace::type ns)
+{
+	QString url (request.url().toString());
+	QNetworkRequest conditionalRequest (request);
+
+	//the response is stored here, not in the network access manager's cache
+	conditionalRequest.setAttribute (QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	conditionalRequest.setAttribute (QNetworkRequest::CacheSaveControlAttribute, false);
+
+	//the validators are stored as meta data of the cached response, so the response itself is not read here
+	QByteArray validators (cacheManager.getMetaData (ns, url));
+
+	//recordings contain full responses, so that they can be replayed with an empty cache
+	if (!validators.isEmpty() && !TrafficCapture::isRecording()) {
+		QByteArray eTag, lastModified;
+		QDataStream stream (validators);
+		stream >> eTag >> lastModified;
+
+		//ETag is preferred, because it identifies the response contents. Last-Modified is used only if there is no ETag
+		if (!eTag.isEmpty()) {
+			conditionalRequest.setRawHeader ("If-None-Match", eTag);
+		} else if (!lastModified.isEmpty()) {
+			conditionalRequest.setRawHeader ("If-Modified-Since", lastModified);
+		}
+	}
+
+	QNetworkReply* reply = qnetworkManager->get (conditionalRequest);
+
+	setProcessReply (reply, [this, key, ns, url, request] (QVariant statusCode, QByteArray data, const QNetworkReply& reply) {
+
+		if (statusCode == 304) {
+			QByteArray storedData (cacheManager.get (ns, url));
+
+			if (!storedData.isNull()) {
+				return deliverResponse (key, 200, storedData, reply);
+			}
+
+			//the stored response was evicted in the meantime. Request the resource again, without validators
+			auto it = sharedRequests.find (key);
+
+			if (it != sharedRequests.end() && it->reply == &reply) {
+				sendSharedRequest (key);
+			}
+			return;
+		}
+
+		QByteArray eTag (reply.rawHeader ("ETag"));
+		QByteArray lastModified (reply.rawHeader ("Last-Modified"));
+
+		if (!eTag.isEmpty() || !lastModified.isEmpty()) {
+			QByteArray validators;
+			QDataStream stream (&validators, QIODevice::WriteOnly);
+			stream << eTag << lastModified;
+
+			cacheManager.insert (ns, url, data, validators);
+		}
+
+		deliverResponse (key, statusCode, data, reply);
+	});
+
+	return reply;
+}
+
+void HTTPConnector::trackSharedRequest (const QString& key, QNetworkReply* reply)
+{
+	/*
+	 * Connected after the reply processing, so it is called after the response is delivered.
+	 * Removes the request if it has failed. Only the failure handlers are called in this case
+	 */
+	connect (reply, &QNetworkReply::finished, this, [this, key, reply] {
+		auto it = sharedRequests.find (key);
+
+		if (it == sharedRequests.end() || it->reply != reply) {
+			return;
+		}
+
+		//a replayed request, which could not reach the server. The network may not be up yet after the reconnect
+		if (isRetriedReplay (*it, *reply)) {
+			int delay = replayRetryDelay << it->attempt;
+			++it->attempt;
+			it->reply = nullptr;
+
+			LOG_DEBUG ("Replay " << key << " again in " << delay << " ms");
+
+			QTimer::singleShot (delay, this, [this, key] {
+				auto it = sharedRequests.find (key);
+
+				//the request may have been cancelled (and sent again) in the meantime
+				if (it != sharedRequests.end() && !it->reply) {
+					sendSharedRequest (key);
+				}
+			});
+			return;
+		}
+
+		//removed before calling the handlers, the same way as in deliverResponse()
+		std::list<Subscriber> subscribers (std::move (it->subscribers));
+		sharedRequests.erase (it);
+
+		for (auto& subscriber: subscribers) {
+			if (subscriber.failureHandler) {
+				subscriber.failureHandler ();
+			}
+		}
+	});
+}
+
+void HTTPConnector::deliverResponse (const QString& key, QVariant statusCode, const QByteArray& data, const QNetworkReply& reply)
+{
+	auto it = sharedRequests.find (key);
+
+	if (it == sharedRequests.end() || it->reply != &reply) {
+		return;
+	}
+
+	/*
+	 * Remove the request before calling the callbacks. If a callback sends
+	 * the same request again, it will be a new request
+	 */
+	std::list<Subscriber> subscribers (std::move (it->subscribers));
+	sharedRequests.erase (it);
+
+	for (auto& subscriber: subscribers) {
+		subscriber.responseHandler (statusCode, data, reply);
+	}
+}
+
+void HTTPConnector::unsubscribe (const QString& key, uint64_t subscriberID)
+{
+	auto it = sharedRequests.find (key);
+
+	if (it == sharedRequests.end()) {
+		return;
+	}
+
+	it->subscribers.remove_if ([subscriberID] (const Subscriber& subscriber) {
+		return subscriber.id == subscriberID;
+	});
+
+	//nobody waits for the response
+	if (it->subscribers.empty()) {
+		QNetworkReply* reply = it->reply;
+		sharedRequests.erase (it);
+
+		//the request may be waiting to be replayed
+		if (reply) {
+			reply->abort ();
+		}
+	}
+}
+
+bool HTTPConnector::isSubscribed (const QString& key, uint64_t subscriberID) const
+{
+	auto it = sharedRequests.find (key);
+
+	if (it == sharedRequests.end()) {
+		return false;
+	}
+
+	for (const auto& subscriber: it->subscribers) {
+		if (subscriber.id == subscriberID) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 void HTTPConnector::post (QNetworkRequest& request, const QByteArrayCreator& data, HttpResponseCallback responseHandler)
@@ -90,9 +427,50 @@ void HTTPConnector::del (const QNetworkRequest& request)
 	setProcessReply (reply, [](QVariant, QByteArray, const QNetworkReply&){});
 }
 
+/**
+ * Name of the request in the trace timeline, for example 'GET users/me/teams'
+ */
+static QString getTraceName (const QNetworkReply& reply)
+{
+	static const char* operationNames[] = {"UNKNOWN", "HEAD", "GET", "PUT", "POST", "DELETE", "CUSTOM"};
+	QNetworkAccessManager::Operation operation = reply.operation();
+
+	QString path (reply.request().url().path());
+	static const QString apiPrefix ("/api/v4/");
+
+	if (path.startsWith (apiPrefix)) {
+		path.remove (0, apiPrefix.size());
+	}
+
+	if (operation < QNetworkAccessManager::HeadOperation || operation > QNetworkAccessManager::CustomOperation) {
+		operation = QNetworkAccessManager::UnknownOperation;
+	}
+
+	return QString (operationNames[operation]) + " " + path;
+}
+
 void HTTPConnector::setProcessReply (QNetworkReply* reply, std::function<void (QVariant, QByteArray, const QNetworkReply&)> responseHandler)
 {
-	connect(reply, &QNetworkReply::finished, [this, reply, responseHandler]() {
+	//the request is traced from sending to receiving the reply
+	QString traceName;
+	uint64_t traceID = 0;
+
+	if (TraceSpan::isActive()) {
+		traceName = getTraceName (*reply);
+		traceID = Trace::beginAsync ("network", traceName);
+	}
+
+	int64_t requestTime = TrafficCapture::isRecording() ? TrafficCapture::now() : 0;
+
+	connect(reply, &QNetworkReply::finished, [this, reply, responseHandler, traceName, traceID, requestTime]() {
+
+		Trace::endAsync ("network", traceName, traceID);
+
+		//the request was aborted by the caller. Nobody is waiting for the response
+		if (reply->error() == QNetworkReply::OperationCanceledError) {
+			reply->deleteLater();
+			return;
+		}
 
 		//print whether the resource is obtained from the cache
 #if 0
@@ -109,6 +487,8 @@ void HTTPConnector::setProcessReply (QNetworkReply* reply, std::function<void (Q
 		auto data = reply->readAll();
 		reply->deleteLater();
 
+		TrafficCapture::recordHttpExchange (*reply, requestTime, statusCode, data);
+
 		//print the cache size
 #if 0
 		QAbstractNetworkCache* cache = qnetworkManager->cache();
@@ -120,7 +500,9 @@ void HTTPConnector::setProcessReply (QNetworkReply* reply, std::function<void (Q
 		}
 #endif
 
-		if (statusCode == 200 || statusCode == 201) {
+		//304 (Not Modified) is received only for requests sent with getRevalidated()
+		if (statusCode == 200 || statusCode == 201 || statusCode == 304) {
+			TraceSpan span ("network", "reply", traceName);
 			return responseHandler (statusCode, qMove (data), *reply);
 		}
 
@@ -145,6 +527,17 @@ void HTTPConnector::setProcessReply (QNetworkReply* reply, std::function<void (Q
 #endif
 			this, [this, reply](QNetworkReply::NetworkError error) {
 
+		if (error == QNetworkReply::OperationCanceledError) {
+			return;
+		}
+
+		//a replayed request, which will be sent again. The error is reported only if the last attempt fails
+		for (const SharedRequest& request: sharedRequests) {
+			if (isRetriedReplay (request, *reply)) {
+				return;
+			}
+		}
+
 		emit onNetworkError (error, reply->errorString());
 	});
 }
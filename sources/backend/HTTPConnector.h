@@ -25,25 +25,133 @@
 #pragma once
 
 #include <memory>
+#include <list>
+#include <vector>
+#include <QHash>
 #include <QNetworkReply>
+#include <QPointer>
 #include "backend/types/BackendError.h"
 #include "backend/HttpResponseCallback.h"
+#include "backend/CacheManager.h"
 
 class QNetworkAccessManager;
 
 namespace Mattermost {
 
 class QByteArrayCreator;
+class HTTPConnector;
+
+/**
+ * Handle for a pending GET request. Several callers may share the same network request,
+ * so cancelling a handle only removes its callback. The network request is aborted
+ * when no callbacks are left.
+ * A default constructed handle does not refer to any request
+ */
+class HttpRequestHandle {
+public:
+	HttpRequestHandle ();
+
+	/**
+	 * Create a handle for a request, which may be sent later. For example, cached data is read first
+	 * and the request is sent only if the data can not be read. Copies of the handle share its state.
+	 * The handle is pending until finishDeferred() or setDeferredRequest() is called, or until it is cancelled
+	 */
+	static HttpRequestHandle createDeferred ();
+
+	/**
+	 * The callback will not be called. Does nothing if the request is already finished
+	 */
+	void cancel ();
+
+	/**
+	 * Check whether the callback is still waiting for the response
+	 */
+	bool isPending () const;
+
+	/**
+	 * Attach the request, which was sent for a deferred handle. Cancelling the handle cancels the request
+	 */
+	void setDeferredRequest (const HttpRequestHandle& request);
+
+	/**
+	 * Mark a deferred handle as finished, without sending a request
+	 */
+	void finishDeferred ();
+private:
+	friend class HTTPConnector;
+	HttpRequestHandle (HTTPConnector* connector, const QString& key, uint64_t subscriberID);
+
+	struct DeferredState;
+
+	QPointer<HTTPConnector>				connector;
+	QString								key;
+	uint64_t							subscriberID;
+	std::shared_ptr<DeferredState>		deferred;
+};
+
+struct HttpRequestHandle::DeferredState {
+	bool								waiting = true;	//the request is not sent yet
+	HttpRequestHandle					request;
+};
+
+/**
+ * Requests, whose callbacks refer to the object owning the list (for example, a channel or a team).
+ * The requests are cancelled when the list is destroyed, so that their callbacks are not called
+ * for a destroyed object, if the response arrives later (or the request is replayed after reconnect)
+ */
+class HttpRequestList {
+public:
+	HttpRequestList () = default;
+	~HttpRequestList ();
+
+	HttpRequestList (const HttpRequestList&) = delete;
+	HttpRequestList& operator= (const HttpRequestList&) = delete;
+
+	/**
+	 * Add a request. The finished requests are removed, so the list does not grow
+	 */
+	void add (const HttpRequestHandle& request);
+	void cancelAll ();
+private:
+	std::vector<HttpRequestHandle>		requests;
+};
 
 class HTTPConnector: public QObject {
 	Q_OBJECT
 public:
-	HTTPConnector ();
+	explicit HTTPConnector (CacheManager& cacheManager);
 	virtual ~HTTPConnector ();
 
+	/**
+	 * Recreate the network access manager. All requests in progress are dropped
+	 */
 	void reset ();
 
-	void get (const QNetworkRequest &request, HttpResponseCallback responseHandler);
+	/**
+	 * Recreate the network access manager, keeping the GET requests in progress.
+	 * They are sent again and, if the server is not reachable yet, retried with exponential backoff.
+	 * The responses are delivered to the callbacks, which were not cancelled through their handles
+	 */
+	void reconnect ();
+
+	/**
+	 * Send a GET request. If a GET request for the same url is already in progress,
+	 * no new request is sent. The responseHandler receives the response of the request in progress
+	 * @param failureHandler called instead of the responseHandler if the request fails (HTTP error,
+	 *        network error, or a replayed request, which gave up). Not called if the request is cancelled
+	 * @return handle, which can be used to cancel the request
+	 */
+	HttpRequestHandle get (const QNetworkRequest &request, HttpResponseCallback responseHandler, std::function<void()> failureHandler = nullptr);
+
+	/**
+	 * Send a GET request, revalidating the previously received response (if any).
+	 * The response is stored with its ETag / Last-Modified validators, which are sent back on the next
+	 * request as If-None-Match / If-Modified-Since. If the server replies with 304 (Not Modified),
+	 * the responseHandler receives the stored response, as if it was sent again by the server
+	 * Requests in progress are shared, the same way as with get()
+	 * @param ns cache namespace for the stored responses
+	 */
+	HttpRequestHandle getRevalidated (const QNetworkRequest &request, CacheNamespace::type ns, HttpResponseCallback responseHandler);
 	void post (QNetworkRequest &request, const QByteArrayCreator &data, HttpResponseCallback responseHandler);
 	void put (const QNetworkRequest &request, const QByteArrayCreator &data, HttpResponseCallback responseHandler);
 	void del (const QNetworkRequest &request);
@@ -53,9 +161,67 @@ signals:
 	void onHttpError (uint32_t errorNumber, const QString& errorText);
 
 private:
+	friend class HttpRequestHandle;
+
+	struct Subscriber {
+		uint64_t													id;
+		HttpResponseCallback										responseHandler;
+		std::function<void()>										failureHandler;
+	};
+
+	/**
+	 * GET request in progress, shared by all callers requesting the same url.
+	 * The request itself is kept, so that it can be sent again after reconnect()
+	 */
+	struct SharedRequest {
+		QNetworkReply*												reply;	//null while waiting to be replayed
+		std::list<Subscriber>										subscribers;
+		QNetworkRequest												request;
+		CacheNamespace::type										ns;
+		bool														revalidated;
+		bool														replayed;
+		int															attempt;
+	};
+
+	//replayed requests are retried after 1, 2, 4 ... 32 seconds
+	static constexpr int maxReplayAttempts = 6;
+	static constexpr int replayRetryDelay = 1000;
+
 	virtual void setProcessReply (QNetworkReply* reply, std::function<void(QVariant,QByteArray,const QNetworkReply&)> responseHandler);
+
+	/**
+	 * Add a callback to the request in progress with this key. The request is sent, if there is no such request
+	 * @return handle for the callback
+	 */
+	HttpRequestHandle getShared (const QString& key, const QNetworkRequest& request, bool revalidated, CacheNamespace::type ns, HttpResponseCallback responseHandler, std::function<void()> failureHandler = nullptr);
+
+	/**
+	 * Send (or send again) the network request of a shared request
+	 */
+	void sendSharedRequest (const QString& key);
+
+	/**
+	 * Call all callbacks of a finished request
+	 */
+	void deliverResponse (const QString& key, QVariant statusCode, const QByteArray& data, const QNetworkReply& reply);
+
+	void unsubscribe (const QString& key, uint64_t subscriberID);
+	bool isSubscribed (const QString& key, uint64_t subscriberID) const;
+
+	void trackSharedRequest (const QString& key, QNetworkReply* reply);
+	QNetworkReply* sendRevalidatedRequest (const QString& key, const QNetworkRequest& request, CacheNamespace::type ns);
+	void recreateNetworkManager ();
+	static bool isConnectionError (const QNetworkReply& reply);
+
+	/**
+	 * Check whether the reply is a failed attempt of a replayed request, which will be sent again
+	 */
+	static bool isRetriedReplay (const SharedRequest& request, const QNetworkReply& reply);
 private:
 	std::unique_ptr<QNetworkAccessManager> 	qnetworkManager;
+	CacheManager&							cacheManager;
+	QHash<QString, SharedRequest>			sharedRequests;
+	uint64_t								nextSubscriberID;
 };
 
 } /* namespace Mattermost */
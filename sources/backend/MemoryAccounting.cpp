@@ -0,0 +1,331 @@
+/**
+ * @file MemoryAccounting.cpp
+ * @brief Estimates the memory used by the backend data, by category
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "MemoryAccounting.h"
+
+#include <algorithm>
+#include "backend/CacheManager.h"
+#include "backend/Storage.h"
+#include "backend/types/BackendPoll.h"
+#include "log.h"
+
+namespace Mattermost {
+
+namespace {
+
+//node of std::list, std::map and QMap (the pointers and the color / level)
+constexpr qint64 listNodeOverhead = 2 * sizeof (void*);
+constexpr qint64 mapNodeOverhead = 3 * sizeof (void*) + sizeof (int);
+
+//QArrayData header, used by QString, QByteArray and QVector
+constexpr qint64 arrayDataHeader = 3 * sizeof (int) + sizeof (qptrdiff);
+
+void addEntry (QVector<MemoryUsage>& usage, const QString& category, const QString& name, uint64_t count, qint64 bytes)
+{
+	if (count) {
+		usage.append (MemoryUsage {category, name, count, bytes});
+	}
+}
+
+QString getChannelName (const BackendChannel& channel)
+{
+	return channel.display_name.isEmpty() ? channel.name : channel.display_name;
+}
+
+qint64 estimatePosts (const std::list<BackendPost>& posts)
+{
+	qint64 bytes = 0;
+
+	for (const BackendPost& post: posts) {
+		bytes += MemoryAccounting::estimate (post) + listNodeOverhead;
+	}
+
+	return bytes;
+}
+
+qint64 estimatePosts (const BackendChannelPosts& posts)
+{
+	//the posts themselves are in the chunks, counted with the unused slots
+	qint64 bytes = posts.getCapacityBytes ();
+
+	for (const BackendPost& post: posts) {
+		bytes += MemoryAccounting::estimate (post) - qint64 (sizeof (BackendPost));
+	}
+
+	return bytes;
+}
+
+qint64 estimateChannel (const BackendChannel& channel)
+{
+	qint64 bytes = sizeof (BackendChannel);
+
+	for (const QString* string: {&channel.id, &channel.display_name, &channel.name, &channel.header, &channel.purpose}) {
+		bytes += MemoryAccounting::estimate (*string);
+	}
+
+	bytes += channel.members.size() * (sizeof (QString) + sizeof (BackendChannelMember) + mapNodeOverhead);
+	return bytes;
+}
+
+} /* namespace */
+
+qint64 MemoryAccounting::estimate (const QString& string)
+{
+	if (string.isNull()) {
+		return sizeof (QString);
+	}
+
+	return sizeof (QString) + arrayDataHeader + (string.capacity() + 1) * sizeof (QChar);
+}
+
+qint64 MemoryAccounting::estimate (const QByteArray& data)
+{
+	if (data.isNull()) {
+		return sizeof (QByteArray);
+	}
+
+	return sizeof (QByteArray) + arrayDataHeader + data.capacity() + 1;
+}
+
+qint64 MemoryAccounting::estimate (const BackendFile& file)
+{
+	return sizeof (BackendFile) + estimate (file.id) + estimate (file.name) + estimate (file.mimeType)
+			+ estimate (file.extension) + estimate (file.mini_preview);
+}
+
+qint64 MemoryAccounting::estimate (const BackendPost& post)
+{
+	qint64 bytes = sizeof (BackendPost);
+
+	for (const QString* string: {&post.id, &post.user_id, &post.channel_id, &post.root_id, &post.message}) {
+		bytes += estimate (*string);
+	}
+
+	if (post.extra) {
+		const BackendPostExtra& extra = *post.extra;
+		bytes += sizeof (BackendPostExtra) - sizeof (QByteArray) + estimate (extra.props);
+
+		for (const QString* string: {&extra.parent_id, &extra.original_id, &extra.type, &extra.hashtags, &extra.pending_post_id}) {
+			bytes += estimate (*string) - qint64 (sizeof (QString));
+		}
+	}
+
+	//the files and reactions are stored inline in the QVector buffers
+	if (!post.files.isEmpty()) {
+		bytes += arrayDataHeader;
+	}
+
+	for (const BackendFile& file: post.files) {
+		bytes += estimate (file);
+	}
+
+	if (!post.reactions.isEmpty()) {
+		bytes += arrayDataHeader;
+	}
+
+	for (const auto& reaction: post.reactions) {
+		//the user IDs are shared with the users, only the references are counted
+		bytes += sizeof (reaction) + arrayDataHeader + reaction.second.count() * sizeof (QString);
+	}
+
+	if (post.poll) {
+		bytes += sizeof (BackendPoll) + estimate (post.poll->title) + estimate (post.poll->text);
+
+		for (const BackendPollOption& option: post.poll->options) {
+			bytes += sizeof (option) + estimate (option.voters);
+		}
+	}
+
+	return bytes;
+}
+
+qint64 MemoryAccounting::estimate (const BackendUser& user)
+{
+	qint64 bytes = sizeof (BackendUser);
+
+	for (const QString* string: {&user.id, &user.username, &user.auth_data, &user.auth_service, &user.email,
+			&user.nickname, &user.first_name, &user.last_name, &user.position, &user.locale, &user.status}) {
+		bytes += estimate (*string);
+	}
+
+	for (const QString& role: user.roles) {
+		bytes += estimate (role);
+	}
+
+	return bytes;
+}
+
+QVector<MemoryUsage> MemoryAccounting::collect (const Storage& storage, const CacheManager& cacheManager)
+{
+	QVector<MemoryUsage> usage;
+
+	for (const BackendChannel* channel: storage.channels) {
+		qint64 postsSize = estimatePosts (channel->posts) + channel->postIdToPost.size() * (estimate (QString()) + sizeof (void*) + mapNodeOverhead);
+		qint64 messagesSize = 0;
+
+		for (const BackendPost& post: channel->posts) {
+			messagesSize += estimate (post.message);
+		}
+
+		//the message texts are shown separately from the rest of the posts
+		addEntry (usage, "Posts", getChannelName (*channel), channel->posts.size(), postsSize - messagesSize);
+		addEntry (usage, "Messages", getChannelName (*channel), channel->posts.size(), messagesSize);
+		addEntry (usage, "Pinned posts", getChannelName (*channel), channel->pinnedPosts.size(), estimatePosts (channel->pinnedPosts));
+
+		//the reply lists hold pointers only. The posts, loaded with a thread are counted separately
+		qint64 threadsSize = estimatePosts (channel->threadPosts) + channel->threadPostIdToPost.size() * (estimate (QString()) + sizeof (void*) + mapNodeOverhead);
+
+		for (auto it = channel->threadReplies.begin(); it != channel->threadReplies.end(); ++it) {
+			threadsSize += estimate (it.key()) + mapNodeOverhead + it.value().capacity() * sizeof (void*);
+		}
+
+		addEntry (usage, "Threads", getChannelName (*channel), channel->threadReplies.size(), threadsSize);
+	}
+
+	uint64_t channelsCount = 0;
+	qint64 channelsSize = 0;
+
+	for (const BackendChannel* channel: storage.channels) {
+		++channelsCount;
+		channelsSize += estimateChannel (*channel);
+	}
+
+	addEntry (usage, "Channels", QString(), channelsCount, channelsSize);
+
+	for (const auto& team: storage.teams) {
+		qint64 bytes = 0;
+
+		for (const BackendChannel& channel: team.second.allPublicChannels) {
+			bytes += estimateChannel (channel) + estimatePosts (channel.posts) + listNodeOverhead;
+		}
+
+		addEntry (usage, "Public channel lists", team.second.display_name, team.second.allPublicChannels.size(), bytes);
+	}
+
+	uint64_t avatarsCount = 0;
+	qint64 avatarsSize = 0;
+	qint64 usersSize = 0;
+
+	for (const auto& user: storage.users) {
+		usersSize += estimate (user.second) + estimate (user.first) + mapNodeOverhead;
+
+		if (!user.second.avatar.isEmpty()) {
+			++avatarsCount;
+			avatarsSize += estimate (user.second.avatar);
+		}
+	}
+
+	addEntry (usage, "Users", QString(), storage.users.size(), usersSize);
+	addEntry (usage, "Avatars", QString(), avatarsCount, avatarsSize);
+
+	//the attachment previews, received with the posts (the files themselves are in the disk cache)
+	uint64_t previewsCount = 0;
+	qint64 previewsSize = 0;
+
+	for (const BackendChannel* channel: storage.channels) {
+		for (const BackendPost& post: channel->posts) {
+			for (const BackendFile& file: post.files) {
+				if (!file.mini_preview.isEmpty()) {
+					++previewsCount;
+					previewsSize += estimate (file.mini_preview);
+				}
+			}
+		}
+	}
+
+	addEntry (usage, "Attachment previews", QString(), previewsCount, previewsSize);
+
+	for (int ns = 0; ns < CacheNamespace::count; ++ns) {
+		CacheStats stats = cacheManager.getStats (static_cast<CacheNamespace::type> (ns));
+		addEntry (usage, "Cache index", CacheManager::getNamespaceName (static_cast<CacheNamespace::type> (ns)),
+				stats.entries, cacheManager.getIndexMemoryUsage (static_cast<CacheNamespace::type> (ns)));
+	}
+
+	return usage;
+}
+
+QVector<MemoryUsage> MemoryAccounting::getCategoryTotals (const QVector<MemoryUsage>& usage)
+{
+	QVector<MemoryUsage> totals;
+
+	for (const MemoryUsage& entry: usage) {
+		auto it = std::find_if (totals.begin(), totals.end(), [&entry] (const MemoryUsage& total) {
+			return total.category == entry.category;
+		});
+
+		if (it == totals.end()) {
+			totals.append (MemoryUsage {entry.category, QString(), entry.count, entry.bytes});
+		} else {
+			it->count += entry.count;
+			it->bytes += entry.bytes;
+		}
+	}
+
+	std::sort (totals.begin(), totals.end(), [] (const MemoryUsage& lhs, const MemoryUsage& rhs) {
+		return lhs.bytes > rhs.bytes;
+	});
+
+	return totals;
+}
+
+void MemoryAccounting::log (const QVector<MemoryUsage>& usage)
+{
+	QVector<MemoryUsage> totals (getCategoryTotals (usage));
+	qint64 totalSize = 0;
+
+	for (const MemoryUsage& total: totals) {
+		totalSize += total.bytes;
+	}
+
+	LOG_DEBUG ("Memory usage (estimated): " << formatSize (totalSize));
+
+	for (const MemoryUsage& total: totals) {
+		LOG_DEBUG ("\t" << total.category << ": " << formatSize (total.bytes) << " (" << total.count << " objects)");
+	}
+
+	QVector<MemoryUsage> largest (usage);
+	std::sort (largest.begin(), largest.end(), [] (const MemoryUsage& lhs, const MemoryUsage& rhs) {
+		return lhs.bytes > rhs.bytes;
+	});
+
+	for (int i = 0; i < std::min (largest.size(), int (maxLoggedEntries)); ++i) {
+		const MemoryUsage& entry = largest[i];
+		LOG_DEBUG ("\t\t" << entry.category << " " << entry.name << ": " << formatSize (entry.bytes) << " (" << entry.count << " objects)");
+	}
+}
+
+QString MemoryAccounting::formatSize (qint64 bytes)
+{
+	if (bytes < 1024) {
+		return QString::number (bytes) + " B";
+	}
+
+	if (bytes < 1024 * 1024) {
+		return QString::number (bytes / 1024.0, 'f', 1) + " KB";
+	}
+
+	return QString::number (bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,85 @@
+/**
+ * @file MemoryAccounting.h
+ * @brief Estimates the memory used by the backend data, by category
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <QString>
+#include <QVector>
+
+namespace Mattermost {
+
+class BackendChannel;
+class BackendFile;
+class BackendPost;
+class BackendUser;
+class CacheManager;
+class Storage;
+
+/**
+ * Memory used by a group of objects
+ */
+struct MemoryUsage {
+	QString		category;	//for example "Posts"
+	QString		name;		//for example the channel name. Empty for the category total
+	uint64_t	count;		//number of objects
+	qint64		bytes;		//estimated size
+};
+
+/**
+ * Estimates the live memory, used by the backend data. The sizes are approximate: the object sizes,
+ * the string and byte array buffers and the container nodes are counted, the heap allocator overhead is not.
+ * Shared (implicitly shared Qt) data is counted by each owner
+ */
+class MemoryAccounting {
+public:
+	/**
+	 * Memory used per channel, per user data type and by the cache index.
+	 * The entries are grouped by category
+	 */
+	static QVector<MemoryUsage> collect (const Storage& storage, const CacheManager& cacheManager);
+
+	/**
+	 * Total memory for each category
+	 */
+	static QVector<MemoryUsage> getCategoryTotals (const QVector<MemoryUsage>& usage);
+
+	/**
+	 * Print the category totals and the largest entries
+	 */
+	static void log (const QVector<MemoryUsage>& usage);
+
+	static QString formatSize (qint64 bytes);
+
+	static qint64 estimate (const QString& string);
+	static qint64 estimate (const QByteArray& data);
+	static qint64 estimate (const BackendFile& file);
+	static qint64 estimate (const BackendPost& post);
+	static qint64 estimate (const BackendUser& user);
+
+	//the largest entries are printed by log()
+	static constexpr int maxLoggedEntries = 5;
+};
+
+} /* namespace Mattermost */
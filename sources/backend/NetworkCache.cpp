@@ -0,0 +1,165 @@
+/**
+ * @file NetworkCache.cpp
+ * @brief QNetworkAccessManager cache, which stores its data in the CacheManager
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "NetworkCache.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QRegularExpression>
+
+namespace Mattermost {
+
+NetworkCache::NetworkCache (CacheManager& cacheManager, QObject* parent)
+:QAbstractNetworkCache (parent)
+,cacheManager (cacheManager)
+{
+}
+
+NetworkCache::~NetworkCache ()
+{
+	qDeleteAll (preparedEntries.keys());
+}
+
+QNetworkCacheMetaData NetworkCache::metaData (const QUrl& url)
+{
+	//QNetworkAccessManager checks the meta data for every request, so only the in-memory meta data is used.
+	//The response data is not read and the entry is not counted as a cache hit, until it is actually used
+	QNetworkCacheMetaData metaData;
+	QByteArray serializedMetaData (cacheManager.getMetaData (getNamespace (url), url.toString()));
+
+	if (serializedMetaData.isEmpty()) {
+		return metaData;
+	}
+
+	QDataStream stream (serializedMetaData);
+	stream >> metaData;
+
+	if (stream.status() != QDataStream::Ok) {
+		return QNetworkCacheMetaData ();
+	}
+
+	return metaData;
+}
+
+void NetworkCache::updateMetaData (const QNetworkCacheMetaData& metaData)
+{
+	cacheManager.setMetaData (getNamespace (metaData.url()), metaData.url().toString(), serializeMetaData (metaData));
+}
+
+QIODevice* NetworkCache::data (const QUrl& url)
+{
+	QString filePath (cacheManager.getFilePath (getNamespace (url), url.toString()));
+
+	if (filePath.isEmpty()) {
+		return nullptr;
+	}
+
+	//the file is read by the caller, as needed. The caller takes ownership over the device
+	QFile* file = new QFile (filePath);
+
+	if (!file->open (QIODevice::ReadOnly)) {
+		delete file;
+		return nullptr;
+	}
+
+	return file;
+}
+
+bool NetworkCache::remove (const QUrl& url)
+{
+	//the download may have failed after the entry was prepared
+	for (auto it = preparedEntries.begin(); it != preparedEntries.end();) {
+		if (it.value().url() == url) {
+			delete it.key();
+			it = preparedEntries.erase (it);
+		} else {
+			++it;
+		}
+	}
+
+	return cacheManager.remove (getNamespace (url), url.toString());
+}
+
+qint64 NetworkCache::cacheSize () const
+{
+	return cacheManager.getSize ();
+}
+
+QIODevice* NetworkCache::prepare (const QNetworkCacheMetaData& metaData)
+{
+	if (!metaData.isValid() || !metaData.saveToDisk()) {
+		return nullptr;
+	}
+
+	QBuffer* buffer = new QBuffer ();
+	buffer->open (QIODevice::ReadWrite);
+	preparedEntries.insert (buffer, metaData);
+	return buffer;
+}
+
+void NetworkCache::insert (QIODevice* device)
+{
+	auto it = preparedEntries.find (device);
+
+	if (it == preparedEntries.end()) {
+		return;
+	}
+
+	QBuffer* buffer = static_cast<QBuffer*> (device);
+	const QNetworkCacheMetaData& metaData = it.value();
+
+	//the meta data (HTTP headers, expiration date, etc.) is stored separately from the response data
+	cacheManager.insert (getNamespace (metaData.url()), metaData.url().toString(), buffer->data(), serializeMetaData (metaData));
+
+	preparedEntries.erase (it);
+	delete device;
+}
+
+void NetworkCache::clear ()
+{
+	cacheManager.clear (CacheNamespace::api);
+	cacheManager.clear (CacheNamespace::avatars);
+}
+
+CacheNamespace::type NetworkCache::getNamespace (const QUrl& url)
+{
+	static QRegularExpression avatarPath ("/users/[^/]+/image$");
+
+	if (avatarPath.match (url.path()).hasMatch()) {
+		return CacheNamespace::avatars;
+	}
+
+	return CacheNamespace::api;
+}
+
+QByteArray NetworkCache::serializeMetaData (const QNetworkCacheMetaData& metaData)
+{
+	QByteArray ret;
+	QDataStream stream (&ret, QIODevice::WriteOnly);
+	stream << metaData;
+	return ret;
+}
+
+} /* namespace Mattermost */
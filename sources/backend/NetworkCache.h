@@ -0,0 +1,63 @@
+/**
+ * @file NetworkCache.h
+ * @brief QNetworkAccessManager cache, which stores its data in the CacheManager
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QAbstractNetworkCache>
+#include <QHash>
+#include "backend/CacheManager.h"
+
+namespace Mattermost {
+
+/**
+ * Network cache for QNetworkAccessManager. A new instance is created for each QNetworkAccessManager
+ * (which takes ownership over it), but all instances share the same CacheManager.
+ * User avatars are stored in the 'avatars' namespace, all other responses in the 'api' namespace.
+ * The meta data of each response is kept in the CacheManager index, so it is available without reading the response data
+ */
+class NetworkCache: public QAbstractNetworkCache {
+public:
+	explicit NetworkCache (CacheManager& cacheManager, QObject* parent = nullptr);
+	~NetworkCache ();
+
+	QNetworkCacheMetaData metaData (const QUrl& url) override;
+	void updateMetaData (const QNetworkCacheMetaData& metaData) override;
+	QIODevice* data (const QUrl& url) override;
+	bool remove (const QUrl& url) override;
+	qint64 cacheSize () const override;
+	QIODevice* prepare (const QNetworkCacheMetaData& metaData) override;
+	void insert (QIODevice* device) override;
+	void clear () override;
+private:
+	static CacheNamespace::type getNamespace (const QUrl& url);
+
+	static QByteArray serializeMetaData (const QNetworkCacheMetaData& metaData);
+private:
+	CacheManager&								cacheManager;
+
+	//entries, which are being downloaded
+	QHash<QIODevice*, QNetworkCacheMetaData>	preparedEntries;
+};
+
+} /* namespace Mattermost */
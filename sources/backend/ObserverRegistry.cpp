@@ -0,0 +1,79 @@
+/**
+ * @file ObserverRegistry.cpp
+ * @brief Typed registry of change observers, keyed by entity ID
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "ObserverRegistry.h"
+
+namespace Mattermost {
+
+Subscription::Subscription ()
+:observerID (0)
+{
+}
+
+Subscription::Subscription (const std::shared_ptr<ObserverRegistryCore>& registry, const QString& entityID, uint32_t observerID)
+:registry (registry)
+,entityID (entityID)
+,observerID (observerID)
+{
+}
+
+Subscription::Subscription (Subscription&& other) noexcept
+:registry (std::move (other.registry))
+,entityID (std::move (other.entityID))
+,observerID (other.observerID)
+{
+	other.observerID = 0;
+}
+
+Subscription& Subscription::operator= (Subscription&& other) noexcept
+{
+	if (this != &other) {
+		reset ();
+		registry = std::move (other.registry);
+		entityID = std::move (other.entityID);
+		observerID = other.observerID;
+		other.observerID = 0;
+	}
+
+	return *this;
+}
+
+Subscription::~Subscription ()
+{
+	reset ();
+}
+
+void Subscription::reset ()
+{
+	std::shared_ptr<ObserverRegistryCore> core = registry.lock ();
+
+	if (core && observerID != 0) {
+		core->remove (entityID, observerID);
+	}
+
+	registry.reset ();
+	observerID = 0;
+}
+
+} /* namespace Mattermost */
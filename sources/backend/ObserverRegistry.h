@@ -0,0 +1,216 @@
+/**
+ * @file ObserverRegistry.h
+ * @brief Typed registry of change observers, keyed by entity ID
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <QString>
+
+namespace Mattermost {
+
+/**
+ * Untyped part of an ObserverRegistry, used by Subscription to remove its observer
+ */
+class ObserverRegistryCore {
+public:
+	virtual ~ObserverRegistryCore () = default;
+	virtual void remove (const QString& entityID, uint32_t observerID) = 0;
+};
+
+/**
+ * Handle of an observer, registered in an ObserverRegistry. The observer is removed when
+ * the handle is destroyed, so objects which keep their subscriptions as members are never
+ * notified after their destruction. The handle does not keep the registry alive
+ */
+class Subscription {
+public:
+	Subscription ();
+	Subscription (const std::shared_ptr<ObserverRegistryCore>& registry, const QString& entityID, uint32_t observerID);
+	Subscription (Subscription&& other) noexcept;
+	Subscription& operator= (Subscription&& other) noexcept;
+	~Subscription ();
+
+	Subscription (const Subscription&) = delete;
+	Subscription& operator= (const Subscription&) = delete;
+public:
+	/**
+	 * Remove the observer now
+	 */
+	void reset ();
+private:
+	std::weak_ptr<ObserverRegistryCore>		registry;
+	QString									entityID;
+	uint32_t								observerID;
+};
+
+/**
+ * Observers of a single kind of change, keyed by the ID of the changed entity (user, channel, team).
+ * Notifying only walks the observers of the given entity, so entities with no observers cost nothing.
+ * Observers may be added or removed (including the one being called) while a notification is in progress
+ */
+template <typename... Args>
+class ObserverRegistry {
+public:
+	using Callback = std::function<void (Args...)>;
+
+	ObserverRegistry ()
+	:core (std::make_shared<Core> ())
+	{
+	}
+
+	ObserverRegistry (const ObserverRegistry&) = delete;
+	ObserverRegistry& operator= (const ObserverRegistry&) = delete;
+public:
+	Subscription subscribe (const QString& entityID, Callback callback)
+	{
+		uint32_t observerID = core->nextObserverID++;
+		core->observers[entityID].push_back (Observer {observerID, false, std::move (callback)});
+		return Subscription (core, entityID, observerID);
+	}
+
+	void notify (const QString& entityID, Args... args) const
+	{
+		auto it = core->observers.find (entityID);
+
+		if (it == core->observers.end()) {
+			return;
+		}
+
+		/*
+		 * std::list keeps the observers in place if new ones are added by a callback.
+		 * Observers added during the notification are not called
+		 */
+		std::list<Observer>& observers = it->second;
+		size_t count = observers.size();
+
+		++core->notifyDepth;
+
+		for (auto observer = observers.begin(); count > 0; ++observer, --count) {
+			if (!observer->removed) {
+				observer->callback (args...);
+			}
+		}
+
+		if (--core->notifyDepth == 0 && core->hasRemovedObservers) {
+			core->purge ();
+		}
+	}
+
+	bool hasObservers (const QString& entityID) const
+	{
+		return core->observers.find (entityID) != core->observers.end();
+	}
+
+	/**
+	 * Remove all observers. Existing subscriptions become no-op
+	 */
+	void clear ()
+	{
+		if (core->notifyDepth == 0) {
+			core->observers.clear ();
+			return;
+		}
+
+		for (auto& entity: core->observers) {
+			for (auto& observer: entity.second) {
+				observer.removed = true;
+			}
+		}
+
+		core->hasRemovedObservers = true;
+	}
+private:
+	struct Observer {
+		uint32_t			id;
+		bool				removed;
+		Callback			callback;
+	};
+
+	class Core: public ObserverRegistryCore {
+	public:
+		void remove (const QString& entityID, uint32_t observerID) override
+		{
+			auto it = observers.find (entityID);
+
+			if (it == observers.end()) {
+				return;
+			}
+
+			std::list<Observer>& list = it->second;
+
+			for (auto observer = list.begin(); observer != list.end(); ++observer) {
+				if (observer->id != observerID) {
+					continue;
+				}
+
+				/*
+				 * The callback may be running right now (for example, it destroys its own subscriber),
+				 * so during a notification the observer is only marked and erased afterwards
+				 */
+				if (notifyDepth > 0) {
+					observer->removed = true;
+					hasRemovedObservers = true;
+				} else {
+					list.erase (observer);
+
+					if (list.empty()) {
+						observers.erase (it);
+					}
+				}
+
+				return;
+			}
+		}
+
+		void purge ()
+		{
+			for (auto it = observers.begin(); it != observers.end();) {
+				it->second.remove_if ([] (const Observer& observer) {
+					return observer.removed;
+				});
+
+				if (it->second.empty()) {
+					it = observers.erase (it);
+				} else {
+					++it;
+				}
+			}
+
+			hasRemovedObservers = false;
+		}
+	public:
+		std::map<QString, std::list<Observer>>	observers;
+		uint32_t								nextObserverID = 1;
+		int										notifyDepth = 0;
+		bool									hasRemovedObservers = false;
+	};
+
+	std::shared_ptr<Core>		core;
+};
+
+} /* namespace Mattermost */
@@ -0,0 +1,176 @@
+/**
+ * @file ReplayNetworkAccessManager.cpp
+ * @brief Network access manager, which answers the requests from a traffic recording
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "ReplayNetworkAccessManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <QTimer>
+#include "TrafficCapture.h"
+#include "log.h"
+
+namespace Mattermost {
+
+ReplayNetworkReply::ReplayNetworkReply (QNetworkAccessManager::Operation operation, const QNetworkRequest& request, QObject* parent)
+:QNetworkReply (parent)
+,offset (0)
+{
+	setRequest (request);
+	setUrl (request.url());
+	setOperation (operation);
+	open (QIODevice::ReadOnly);
+
+	CapturedHttpExchange exchange;
+	int delay = 0;
+
+	if (!TrafficCapture::takeHttpExchange (TrafficCapture::getMethod (operation, request), request.url(), exchange, delay)) {
+		LOG_DEBUG ("Replay: no recorded response for " << request.url().toString());
+
+		//finished is emitted from the event loop, as with real replies
+		QTimer::singleShot (0, this, [this] {
+			finish (nullptr);
+		});
+		return;
+	}
+
+	QTimer::singleShot (delay, this, [this, exchange] {
+		finish (&exchange);
+	});
+}
+
+ReplayNetworkReply::~ReplayNetworkReply () = default;
+
+void ReplayNetworkReply::finish (const CapturedHttpExchange* exchange)
+{
+	if (isFinished()) {
+		return;
+	}
+
+	NetworkError errorCode = NoError;
+
+	if (!exchange) {
+		setAttribute (QNetworkRequest::HttpStatusCodeAttribute, 404);
+		errorCode = ContentNotFoundError;
+	} else {
+		//status 0 means that the server was not reached during the recording
+		if (exchange->statusCode) {
+			setAttribute (QNetworkRequest::HttpStatusCodeAttribute, exchange->statusCode);
+		}
+
+		for (const auto& header: exchange->headers) {
+			setRawHeader (header.first, header.second);
+		}
+
+		content = exchange->body;
+
+		switch (exchange->statusCode) {
+		case 0:
+			errorCode = HostNotFoundError;
+			break;
+		case 401:
+			errorCode = AuthenticationRequiredError;
+			break;
+		case 403:
+			errorCode = ContentAccessDenied;
+			break;
+		case 404:
+			errorCode = ContentNotFoundError;
+			break;
+		default:
+			if (exchange->statusCode >= 400) {
+				errorCode = UnknownContentError;
+			}
+		}
+	}
+
+	emit metaDataChanged ();
+
+	if (errorCode != NoError) {
+		setError (errorCode, "Replayed error response");
+#if QT_VERSION <= QT_VERSION_CHECK(5,15,0)
+		emit error (errorCode);
+#else
+		emit errorOccurred (errorCode);
+#endif
+	}
+
+	if (!content.isEmpty()) {
+		emit readyRead ();
+	}
+
+	setFinished (true);
+	emit finished ();
+}
+
+void ReplayNetworkReply::abort ()
+{
+	if (isFinished()) {
+		return;
+	}
+
+	setError (OperationCanceledError, "Operation canceled");
+#if QT_VERSION <= QT_VERSION_CHECK(5,15,0)
+	emit error (OperationCanceledError);
+#else
+	emit errorOccurred (OperationCanceledError);
+#endif
+	setFinished (true);
+	emit finished ();
+}
+
+qint64 ReplayNetworkReply::bytesAvailable () const
+{
+	return content.size() - offset + QNetworkReply::bytesAvailable();
+}
+
+bool ReplayNetworkReply::isSequential () const
+{
+	return true;
+}
+
+qint64 ReplayNetworkReply::readData (char* data, qint64 maxSize)
+{
+	if (offset >= content.size()) {
+		return isFinished() ? -1 : 0;
+	}
+
+	qint64 size = std::min<qint64> (maxSize, content.size() - offset);
+	std::memcpy (data, content.constData() + offset, size);
+	offset += size;
+	return size;
+}
+
+ReplayNetworkAccessManager::ReplayNetworkAccessManager (QObject* parent)
+:QNetworkAccessManager (parent)
+{
+}
+
+ReplayNetworkAccessManager::~ReplayNetworkAccessManager () = default;
+
+QNetworkReply* ReplayNetworkAccessManager::createRequest (Operation operation, const QNetworkRequest& request, QIODevice*)
+{
+	return new ReplayNetworkReply (operation, request, this);
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,67 @@
+/**
+ * @file ReplayNetworkAccessManager.h
+ * @brief Network access manager, which answers the requests from a traffic recording
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+namespace Mattermost {
+
+struct CapturedHttpExchange;
+
+/**
+ * Reply with a recorded response. It finishes after the recorded response time
+ */
+class ReplayNetworkReply: public QNetworkReply {
+	Q_OBJECT
+public:
+	ReplayNetworkReply (QNetworkAccessManager::Operation operation, const QNetworkRequest& request, QObject* parent);
+	~ReplayNetworkReply ();
+
+	void abort () override;
+	qint64 bytesAvailable () const override;
+	bool isSequential () const override;
+protected:
+	qint64 readData (char* data, qint64 maxSize) override;
+private:
+	void finish (const CapturedHttpExchange* exchange);
+private:
+	QByteArray		content;
+	qint64			offset;
+};
+
+/**
+ * Used by HTTPConnector when a traffic recording is replayed (see TrafficCapture). No network is used
+ */
+class ReplayNetworkAccessManager: public QNetworkAccessManager {
+	Q_OBJECT
+public:
+	explicit ReplayNetworkAccessManager (QObject* parent = nullptr);
+	~ReplayNetworkAccessManager ();
+protected:
+	QNetworkReply* createRequest (Operation operation, const QNetworkRequest& request, QIODevice* outgoingData) override;
+};
+
+} /* namespace Mattermost */
@@ -36,19 +36,40 @@ quint32 qHash(const RequestTrackerEntry& entry)
 RequestTracker::RequestTracker () = default;
 RequestTracker::~RequestTracker () = default;
 
-void RequestTracker::addEntry (const RequestTrackerEntry& entry)
+void RequestTracker::addEntry (const RequestTrackerEntry& entry, const HttpRequestHandle& request)
 {
 	if (hasEntry (entry)) {
 		LOG_DEBUG ("RequestTracker addEntry: Entry " << entry.type << " alreay exists");
 		return;
 	}
 
-	entries.insert (entry);
+	//the entries of cancelled requests may refer to destroyed objects, whose addresses can be reused
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (it.value().isPending()) {
+			++it;
+		} else {
+			it = entries.erase (it);
+		}
+	}
+
+	entries.insert (entry, request);
 }
 
 bool RequestTracker::hasEntry (const RequestTrackerEntry& entry)
 {
-	return entries.contains (entry);
+	auto it = entries.find (entry);
+
+	if (it == entries.end()) {
+		return false;
+	}
+
+	//the request was cancelled or has failed, without erasing the entry
+	if (!it.value().isPending()) {
+		entries.erase (it);
+		return false;
+	}
+
+	return true;
 }
 
 void RequestTracker::eraseEntry (const RequestTrackerEntry& entry)
@@ -25,7 +25,8 @@
 
 #pragma once
 
-#include <QSet>
+#include <QHash>
+#include "backend/HTTPConnector.h"
 
 namespace Mattermost {
 
@@ -51,19 +52,20 @@ struct RequestTrackerEntry {
 /**
  * Prevents sending multiple requests for actions related to specified objects.
  * Callers can add an entry that was requested, and ignore next requests for the same data.
- * Callers delete entries when a response is received
+ * Callers delete entries when a response is received. An entry, whose request is not pending any more
+ * (it was cancelled, or it failed), is dropped, so the next request for the same data is sent
  */
 class RequestTracker {
 public:
 	RequestTracker ();
 	virtual ~RequestTracker ();
 public:
-	void addEntry (const RequestTrackerEntry& entry);
+	void addEntry (const RequestTrackerEntry& entry, const HttpRequestHandle& request);
 	bool hasEntry (const RequestTrackerEntry& entry);
 	void eraseEntry (const RequestTrackerEntry& entry);
 	void reset ();
 private:
-	QSet<RequestTrackerEntry> entries;
+	QHash<RequestTrackerEntry, HttpRequestHandle> entries;
 };
 
 } /* namespace Mattermost */
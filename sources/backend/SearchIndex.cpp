@@ -0,0 +1,318 @@
+/**
+ * @file SearchIndex.cpp
+ * @brief Full-text index of the posts, held in memory
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include "backend/types/BackendChannel.h"
+#include "backend/types/BackendPost.h"
+
+namespace Mattermost {
+
+namespace {
+
+//shorter words are mostly noise ("a", "I"), longer ones are usually links and hashes
+constexpr int minWordLength = 2;
+constexpr int maxWordLength = 40;
+
+//posts indexed per event loop iteration
+constexpr int indexSliceSize = 500;
+
+//a whole word match is preferred over a prefix match
+constexpr int wordMatchWeight = 3;
+constexpr int prefixMatchWeight = 1;
+
+}
+
+SearchIndex::SearchIndex ()
+{
+	indexTimer.setSingleShot (true);
+	QObject::connect (&indexTimer, &QTimer::timeout, [this] {
+		indexQueuedPosts (indexSliceSize);
+	});
+}
+
+SearchIndex::~SearchIndex () = default;
+
+void SearchIndex::addPost (BackendChannel& channel, BackendPost& post)
+{
+	queuedPosts.push_back (QueuedPost {&channel, &post});
+	scheduleIndexing ();
+}
+
+void SearchIndex::updatePost (BackendChannel& channel, BackendPost& post)
+{
+	auto it = postToDocument.find (&post);
+
+	//not indexed yet (the new text will be indexed), or not a channel post at all
+	if (it == postToDocument.end()) {
+		return;
+	}
+
+	removeDocument (it.value());
+	addPost (channel, post);
+}
+
+void SearchIndex::removePost (const BackendPost& post)
+{
+	auto it = postToDocument.find (&post);
+
+	if (it != postToDocument.end()) {
+		removeDocument (it.value());
+		return;
+	}
+
+	queuedPosts.erase (std::remove_if (queuedPosts.begin(), queuedPosts.end(), [&post] (const QueuedPost& queuedPost) {
+		return queuedPost.post == &post;
+	}), queuedPosts.end());
+}
+
+void SearchIndex::removeChannel (const BackendChannel& channel)
+{
+	queuedPosts.erase (std::remove_if (queuedPosts.begin(), queuedPosts.end(), [&channel] (const QueuedPost& queuedPost) {
+		return queuedPost.channel == &channel;
+	}), queuedPosts.end());
+
+	for (DocumentID documentID = 0; documentID < documents.size(); ++documentID) {
+		if (documents[documentID].post && documents[documentID].channel == &channel) {
+			removeDocument (documentID);
+		}
+	}
+}
+
+void SearchIndex::clear ()
+{
+	indexTimer.stop ();
+	queuedPosts.clear ();
+	documents.clear ();
+	freeDocuments.clear ();
+	postToDocument.clear ();
+	wordToPostings.clear ();
+}
+
+QVector<SearchResult> SearchIndex::search (const QString& query, int maxResults)
+{
+	indexQueuedPosts ((int)queuedPosts.size());
+
+	QVector<QString> queryWords (tokenize (query));
+	QHash<DocumentID, int> scores;
+
+	for (int i = 0; i < queryWords.size(); ++i) {
+		const QString& queryWord = queryWords[i];
+		QHash<DocumentID, int> wordScores;
+
+		//the words, starting with the query word are adjacent in the map. The first one is the word itself, if present
+		for (auto it = wordToPostings.lowerBound (queryWord); it != wordToPostings.end() && it.key().startsWith (queryWord); ++it) {
+			int weight = it.key().size() == queryWord.size() ? wordMatchWeight : prefixMatchWeight;
+
+			for (const Posting& posting: it.value()) {
+				wordScores[posting.document] += weight * posting.count;
+			}
+		}
+
+		//the posts have to match all query words
+		if (i == 0) {
+			scores = std::move (wordScores);
+		} else {
+			for (auto it = scores.begin(); it != scores.end();) {
+				auto wordScore = wordScores.find (it.key());
+
+				if (wordScore == wordScores.end()) {
+					it = scores.erase (it);
+				} else {
+					it.value() += wordScore.value();
+					++it;
+				}
+			}
+		}
+
+		if (scores.isEmpty()) {
+			break;
+		}
+	}
+
+	QVector<SearchResult> results;
+	results.reserve (scores.size());
+
+	for (auto it = scores.begin(); it != scores.end(); ++it) {
+		const Document& document = documents[it.key()];
+		results.push_back (SearchResult {document.channel, document.post, it.value()});
+	}
+
+	auto isBetterMatch = [] (const SearchResult& a, const SearchResult& b) {
+		if (a.score != b.score) {
+			return a.score > b.score;
+		}
+		return a.post->create_at > b.post->create_at;
+	};
+
+	if (results.size() > maxResults) {
+		std::partial_sort (results.begin(), results.begin() + maxResults, results.end(), isBetterMatch);
+		results.resize (maxResults);
+	} else {
+		std::sort (results.begin(), results.end(), isBetterMatch);
+	}
+
+	return results;
+}
+
+uint32_t SearchIndex::getPostsCount () const
+{
+	return postToDocument.size() + queuedPosts.size();
+}
+
+uint32_t SearchIndex::getWordsCount () const
+{
+	return wordToPostings.size();
+}
+
+QVector<QString> SearchIndex::tokenize (const QString& text)
+{
+	QVector<QString> words;
+	int wordStart = -1;
+
+	for (int i = 0; i <= text.size(); ++i) {
+		bool isWordCharacter = i < text.size() && text[i].isLetterOrNumber();
+
+		if (isWordCharacter) {
+			if (wordStart < 0) {
+				wordStart = i;
+			}
+			continue;
+		}
+
+		if (wordStart >= 0 && i - wordStart >= minWordLength) {
+			words.push_back (text.mid (wordStart, std::min (i - wordStart, maxWordLength)).toCaseFolded());
+		}
+
+		wordStart = -1;
+	}
+
+	return words;
+}
+
+void SearchIndex::indexQueuedPosts (int maxCount)
+{
+	int count = std::min (maxCount, (int)queuedPosts.size());
+
+	for (int i = 0; i < count; ++i) {
+		indexPost (*queuedPosts[i].channel, *queuedPosts[i].post);
+	}
+
+	queuedPosts.erase (queuedPosts.begin(), queuedPosts.begin() + count);
+
+	if (queuedPosts.empty()) {
+		indexTimer.stop ();
+	} else {
+		scheduleIndexing ();
+	}
+}
+
+void SearchIndex::indexPost (BackendChannel& channel, BackendPost& post)
+{
+	//a post may be queued twice, for example when edited before being indexed
+	if (postToDocument.contains (&post)) {
+		return;
+	}
+
+	QHash<QString, uint32_t> wordCounts;
+
+	for (const QString& word: tokenize (post.message)) {
+		++wordCounts[word];
+	}
+
+	for (const BackendFile& file: post.files) {
+		for (const QString& word: tokenize (file.name)) {
+			++wordCounts[word];
+		}
+	}
+
+	DocumentID documentID;
+
+	if (freeDocuments.empty()) {
+		documentID = documents.size();
+		documents.emplace_back ();
+	} else {
+		documentID = freeDocuments.back();
+		freeDocuments.pop_back ();
+	}
+
+	Document& document = documents[documentID];
+	document.channel = &channel;
+	document.post = &post;
+	document.words.reserve (wordCounts.size());
+
+	for (auto it = wordCounts.begin(); it != wordCounts.end(); ++it) {
+		auto postings = wordToPostings.find (it.key());
+
+		if (postings == wordToPostings.end()) {
+			postings = wordToPostings.insert (it.key(), QVector<Posting>());
+		}
+
+		postings.value().push_back (Posting {documentID, it.value()});
+
+		//share the word string with the map key
+		document.words.push_back (postings.key());
+	}
+
+	postToDocument.insert (&post, documentID);
+}
+
+void SearchIndex::removeDocument (DocumentID documentID)
+{
+	Document& document = documents[documentID];
+
+	for (const QString& word: document.words) {
+		auto postings = wordToPostings.find (word);
+
+		if (postings == wordToPostings.end()) {
+			continue;
+		}
+
+		QVector<Posting>& list = postings.value();
+
+		list.erase (std::remove_if (list.begin(), list.end(), [documentID] (const Posting& posting) {
+			return posting.document == documentID;
+		}), list.end());
+
+		if (list.isEmpty()) {
+			wordToPostings.erase (postings);
+		}
+	}
+
+	postToDocument.remove (document.post);
+	document.channel = nullptr;
+	document.post = nullptr;
+	document.words = QVector<QString> ();
+	freeDocuments.push_back (documentID);
+}
+
+void SearchIndex::scheduleIndexing ()
+{
+	if (!indexTimer.isActive()) {
+		indexTimer.start (0);
+	}
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,124 @@
+/**
+ * @file SearchIndex.h
+ * @brief Full-text index of the posts, held in memory
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+namespace Mattermost {
+
+class BackendChannel;
+class BackendPost;
+
+/**
+ * A post, matching a search query
+ */
+struct SearchResult {
+	BackendChannel*		channel;
+	BackendPost*		post;
+	int					score;
+};
+
+/**
+ * Inverted index of the words in the posts, which are loaded in the channels (BackendChannel::posts).
+ * Words are case-folded. Each query word matches the same word (best) or the words it is a prefix of,
+ * and only posts, which match all query words are returned.
+ * Added and edited posts are queued and indexed from the event loop in small slices,
+ * so loading many posts at once does not block the UI
+ */
+class SearchIndex {
+public:
+	SearchIndex ();
+	~SearchIndex ();
+
+	SearchIndex (const SearchIndex&) = delete;
+	SearchIndex& operator= (const SearchIndex&) = delete;
+public:
+	void addPost (BackendChannel& channel, BackendPost& post);
+	void updatePost (BackendChannel& channel, BackendPost& post);
+	void removePost (const BackendPost& post);
+
+	/**
+	 * Remove all posts of a channel. Called by the channel, when it is destroyed
+	 */
+	void removeChannel (const BackendChannel& channel);
+	void clear ();
+
+	/**
+	 * Find the posts, matching all words of the query. The queued posts are indexed first
+	 * @param query search text
+	 * @param maxResults maximum number of results
+	 * @return the matching posts, best matches first. Posts with equal score are ordered newest first
+	 */
+	QVector<SearchResult> search (const QString& query, int maxResults);
+
+	uint32_t getPostsCount () const;
+	uint32_t getWordsCount () const;
+
+	/**
+	 * Split a text to case-folded words. Too short words are skipped, too long ones are truncated
+	 */
+	static QVector<QString> tokenize (const QString& text);
+private:
+	using DocumentID = uint32_t;
+
+	struct Document {
+		BackendChannel*		channel;
+		BackendPost*		post;		//nullptr if the document is free
+		QVector<QString>	words;		//unique words of the post, to remove it from the index
+	};
+
+	struct Posting {
+		DocumentID			document;
+		uint32_t			count;
+	};
+
+	struct QueuedPost {
+		BackendChannel*		channel;
+		BackendPost*		post;
+	};
+
+	void indexQueuedPosts (int maxCount);
+	void indexPost (BackendChannel& channel, BackendPost& post);
+	void removeDocument (DocumentID documentID);
+	void scheduleIndexing ();
+private:
+	std::vector<Document>					documents;
+	std::vector<DocumentID>					freeDocuments;
+	QHash<const BackendPost*, DocumentID>	postToDocument;
+
+	//word -> documents, which contain it. Ordered, so all words with a given prefix are adjacent
+	QMap<QString, QVector<Posting>>			wordToPostings;
+
+	std::vector<QueuedPost>					queuedPosts;
+	QTimer									indexTimer;
+};
+
+} /* namespace Mattermost */
@@ -0,0 +1,235 @@
+/**
+ * @file StallMonitor.cpp
+ * @brief Detects stalls of the GUI event loop and the handlers causing them
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "StallMonitor.h"
+
+#include <algorithm>
+#include <QAbstractEventDispatcher>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include "Trace.h"
+#include "log.h"
+
+namespace Mattermost {
+
+std::atomic<bool> StallMonitor::enabled (false);
+
+namespace {
+
+struct FinishedSpan {
+	int64_t			duration;
+	const char*		name;
+	QString			detail;
+};
+
+/**
+ * Accessed only from the main thread
+ */
+struct MonitorState {
+	QMetaObject::Connection		awakeConnection;
+	QMetaObject::Connection		aboutToBlockConnection;
+	Qt::HANDLE					mainThread = nullptr;
+	int64_t						threshold = 0;			//nanoseconds
+	int64_t						dispatchStart = -1;		//-1 while the event loop is waiting for events
+	QVector<FinishedSpan>		spans;					//spans finished during the current dispatch
+	QVector<EventLoopStall>		stalls;					//the oldest first
+	uint64_t					stallsCount = 0;
+};
+
+MonitorState& monitorState ()
+{
+	static MonitorState instance;
+	return instance;
+}
+
+constexpr int64_t nanosecondsPerMillisecond = 1000000;
+
+//at most this many handlers are shown for a stall
+constexpr int maxStallHandlers = 5;
+
+QString formatSpan (const FinishedSpan& span)
+{
+	QString text (span.name);
+
+	if (!span.detail.isEmpty()) {
+		text += " (" + span.detail + ")";
+	}
+
+	return text + ": " + QString::number (span.duration / double (nanosecondsPerMillisecond), 'f', 1) + " ms";
+}
+
+void onAwake ()
+{
+	MonitorState& state (monitorState());
+
+	//the event loop may wake up several times before it waits again
+	if (state.dispatchStart < 0) {
+		state.dispatchStart = Trace::now();
+		state.spans.clear ();
+	}
+}
+
+void onAboutToBlock ()
+{
+	MonitorState& state (monitorState());
+
+	if (state.dispatchStart < 0) {
+		return;
+	}
+
+	int64_t dispatchEnd = Trace::now();
+	int64_t duration = dispatchEnd - state.dispatchStart;
+
+	if (duration >= state.threshold) {
+		std::sort (state.spans.begin(), state.spans.end(), [] (const FinishedSpan& lhs, const FinishedSpan& rhs) {
+			return lhs.duration > rhs.duration;
+		});
+
+		EventLoopStall stall {QDateTime::currentDateTime(), duration / double (nanosecondsPerMillisecond), {}};
+
+		for (int i = 0; i < std::min (state.spans.size(), maxStallHandlers); ++i) {
+			stall.handlers.append (formatSpan (state.spans[i]));
+		}
+
+		if (stall.handlers.isEmpty()) {
+			stall.handlers.append ("(no traced handler)");
+		}
+
+		LOG_DEBUG ("Event loop stall: " << stall.duration << " ms, " << stall.handlers.first());
+		Trace::complete ("stall", "event loop stall", state.dispatchStart, dispatchEnd, stall.handlers.first());
+
+		if (state.stalls.size() == StallMonitor::maxStalls) {
+			state.stalls.removeFirst ();
+		}
+
+		state.stalls.append (std::move (stall));
+		++state.stallsCount;
+	}
+
+	state.dispatchStart = -1;
+}
+
+} /* namespace */
+
+void StallMonitor::start (int threshold)
+{
+	QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance();
+
+	if (!dispatcher || isEnabled()) {
+		return;
+	}
+
+	MonitorState& state (monitorState());
+	state.mainThread = QThread::currentThreadId();
+	state.threshold = threshold * nanosecondsPerMillisecond;
+	state.dispatchStart = -1;
+
+	/*
+	 * The dispatcher signals, that it is going to wait for events (aboutToBlock) and that it has
+	 * events to process (awake). The time between them is spent in event handlers,
+	 * so no periodic timer is needed
+	 */
+	state.awakeConnection = QObject::connect (dispatcher, &QAbstractEventDispatcher::awake, onAwake);
+	state.aboutToBlockConnection = QObject::connect (dispatcher, &QAbstractEventDispatcher::aboutToBlock, onAboutToBlock);
+
+	enabled = true;
+	LOG_DEBUG ("Event loop stall threshold: " << threshold << " ms");
+}
+
+void StallMonitor::stop ()
+{
+	if (!enabled.exchange (false)) {
+		return;
+	}
+
+	MonitorState& state (monitorState());
+	QObject::disconnect (state.awakeConnection);
+	QObject::disconnect (state.aboutToBlockConnection);
+}
+
+void StallMonitor::spanFinished (const char* name, const QString& detail, int64_t startTime, int64_t endTime)
+{
+	if (!isEnabled()) {
+		return;
+	}
+
+	MonitorState& state (monitorState());
+	int64_t duration = endTime - startTime;
+
+	//spans from other threads do not block the event loop
+	if (QThread::currentThreadId() != state.mainThread || state.dispatchStart < 0
+			|| duration < state.threshold / minSpanFraction) {
+		return;
+	}
+
+	state.spans.append (FinishedSpan {duration, name, detail});
+}
+
+QVector<EventLoopStall> StallMonitor::getWorstStalls ()
+{
+	QVector<EventLoopStall> stalls (monitorState().stalls);
+
+	std::stable_sort (stalls.begin(), stalls.end(), [] (const EventLoopStall& lhs, const EventLoopStall& rhs) {
+		return lhs.duration > rhs.duration;
+	});
+
+	return stalls;
+}
+
+uint64_t StallMonitor::getStallsCount ()
+{
+	return monitorState().stallsCount;
+}
+
+int StallMonitor::getThreshold ()
+{
+	return monitorState().threshold / nanosecondsPerMillisecond;
+}
+
+bool StallMonitor::saveReport (const QString& fileName)
+{
+	QFile file (fileName);
+
+	if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+		return false;
+	}
+
+	QTextStream stream (&file);
+
+	stream << "Event loop stalls longer than " << getThreshold() << " ms: " << getStallsCount()
+		   << " (the last " << monitorState().stalls.size() << " are shown, the longest first)\n\n";
+
+	for (const EventLoopStall& stall: getWorstStalls()) {
+		stream << stall.time.toString (Qt::ISODateWithMs) << "  " << QString::number (stall.duration, 'f', 1) << " ms\n";
+
+		for (const QString& handler: stall.handlers) {
+			stream << "\t" << handler << "\n";
+		}
+	}
+
+	return stream.status() == QTextStream::Ok;
+}
+
+} /* namespace Mattermost */
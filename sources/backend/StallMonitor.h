@@ -0,0 +1,98 @@
+/**
+ * @file StallMonitor.h
+ * @brief Detects stalls of the GUI event loop and the handlers causing them
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+
+namespace Mattermost {
+
+struct EventLoopStall {
+	QDateTime		time;
+	double			duration;	//milliseconds
+	QStringList		handlers;	//traced handlers, which ran during the stall. The longest is first
+};
+
+/**
+ * Measures how long the main event loop is busy between two waits for new events.
+ * If a single dispatch takes longer than the threshold, it is recorded as a stall,
+ * together with the handlers (TraceSpan objects) which ran during it.
+ * The last stalls are kept and can be shown, or saved to a file
+ */
+class StallMonitor {
+public:
+	/**
+	 * Start monitoring the event loop of the calling (main) thread
+	 * @param threshold minimal duration of a stall, in milliseconds
+	 */
+	static void start (int threshold);
+	static void stop ();
+
+	static bool isEnabled ()
+	{
+		return enabled.load (std::memory_order_relaxed);
+	}
+
+	/**
+	 * Called by TraceSpan when a span finishes
+	 * @param startTime, endTime times of the trace clock (Trace::now())
+	 */
+	static void spanFinished (const char* name, const QString& detail, int64_t startTime, int64_t endTime);
+
+	/**
+	 * Get the recorded stalls, the longest first
+	 */
+	static QVector<EventLoopStall> getWorstStalls ();
+
+	/**
+	 * Count of all stalls since start()
+	 */
+	static uint64_t getStallsCount ();
+
+	static int getThreshold ();
+
+	/**
+	 * Write a text report of the recorded stalls
+	 * @return false if the file cannot be written
+	 */
+	static bool saveReport (const QString& fileName);
+
+	//the last stalls are kept
+	static constexpr int maxStalls = 200;
+
+	//spans shorter than 1/10 of the threshold are not shown as a cause of a stall
+	static constexpr int minSpanFraction = 10;
+
+	//default value of the threshold setting
+	static constexpr int defaultThreshold = 50;
+
+private:
+	static std::atomic<bool>	enabled;
+};
+
+} /* namespace Mattermost */
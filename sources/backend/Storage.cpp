@@ -28,7 +28,9 @@
 namespace Mattermost {
 
 Storage::Storage ()
-:loginUser (nullptr)
+:directChannels ("directChannels")
+,groupChannels ("groupChannels")
+,loginUser (nullptr)
 ,matterpollUser (nullptr)
 ,totalUsersCount (0)
 {
@@ -38,6 +40,7 @@ Storage::~Storage () = default;
 
 void Storage::reset ()
 {
+	searchIndex.clear();
 	teams.clear();
 
 	directChannels.channels.clear();
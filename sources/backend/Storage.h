@@ -30,6 +30,8 @@
 #include "backend/types/BackendUser.h"
 #include "backend/types/BackendTeam.h"
 #include "backend/types/BackendDirectChannelsTeam.h"
+#include "backend/EntityObservers.h"
+#include "backend/SearchIndex.h"
 
 namespace Mattermost {
 
@@ -75,6 +77,9 @@ public:
 
 	void printTeams ();
 public:
+	//full-text index of the channel posts. Declared first, because the channels remove their posts from it when destroyed
+	SearchIndex										searchIndex;
+
 	std::map<QString, BackendTeam>					teams;
 	BackendDirectChannelsTeam						directChannels;
 	BackendDirectChannelsTeam						groupChannels;
@@ -84,6 +89,9 @@ public:
 	BackendUser*									loginUser;
 	BackendUser*									matterpollUser;
 	uint32_t										totalUsersCount;
+
+	//change notifications of the stored users, channels and teams
+	EntityObservers									observers;
 };
 
 } /* namespace Mattermost */
@@ -0,0 +1,213 @@
+/**
+ * @file Trace.cpp
+ * @brief Scoped trace spans in the Chrome trace event format
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "Trace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include "log.h"
+
+namespace Mattermost {
+
+std::atomic<bool> Trace::enabled (false);
+
+namespace {
+
+/**
+ * The trace file is written by all threads (image decoding runs in a thread pool)
+ */
+struct TraceFile {
+	QMutex					mutex;
+	QFile					file;
+	QElapsedTimer			clock;
+	std::atomic<uint64_t>	nextAsyncID {1};
+	bool					firstEvent = true;
+
+	//the clock is used by the StallMonitor too, so it runs even if the trace is not written
+	TraceFile ()
+	{
+		clock.start ();
+	}
+};
+
+TraceFile& traceFile ()
+{
+	static TraceFile instance;
+	return instance;
+}
+
+/**
+ * Trace timestamps are in microseconds
+ */
+double toMicroseconds (int64_t nanoseconds)
+{
+	return nanoseconds / 1000.0;
+}
+
+void writeEvent (QJsonObject event)
+{
+	TraceFile& trace (traceFile());
+
+	event.insert ("pid", QCoreApplication::applicationPid());
+	event.insert ("tid", static_cast<qint64> (reinterpret_cast<quintptr> (QThread::currentThreadId())));
+
+	QByteArray data (QJsonDocument (event).toJson (QJsonDocument::Compact));
+
+	QMutexLocker lock (&trace.mutex);
+
+	if (!trace.file.isOpen()) {
+		return;
+	}
+
+	if (!trace.firstEvent) {
+		trace.file.write (",\n");
+	}
+
+	trace.firstEvent = false;
+	trace.file.write (data);
+}
+
+} /* namespace */
+
+bool Trace::start (const QString& fileName)
+{
+	TraceFile& trace (traceFile());
+
+	{
+		QMutexLocker lock (&trace.mutex);
+
+		if (trace.file.isOpen()) {
+			return true;
+		}
+
+		trace.file.setFileName (fileName);
+
+		if (!trace.file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+			qCritical() << "Cannot open trace file" << fileName << ":" << trace.file.errorString();
+			return false;
+		}
+
+		trace.file.write ("[\n");
+		trace.firstEvent = true;
+	}
+
+	enabled = true;
+
+	//name the process and the main thread in the timeline
+	writeEvent (QJsonObject {
+		{"ph", "M"},
+		{"name", "process_name"},
+		{"args", QJsonObject {{"name", QCoreApplication::applicationName()}}},
+	});
+
+	writeEvent (QJsonObject {
+		{"ph", "M"},
+		{"name", "thread_name"},
+		{"args", QJsonObject {{"name", "main"}}},
+	});
+
+	LOG_DEBUG ("Trace started: " << fileName);
+	return true;
+}
+
+void Trace::stop ()
+{
+	if (!enabled.exchange (false)) {
+		return;
+	}
+
+	TraceFile& trace (traceFile());
+	QMutexLocker lock (&trace.mutex);
+
+	trace.file.write ("\n]\n");
+	trace.file.close ();
+}
+
+int64_t Trace::now ()
+{
+	return traceFile().clock.nsecsElapsed();
+}
+
+void Trace::complete (const char* category, const char* name, int64_t startTime, int64_t endTime, const QString& detail)
+{
+	if (!isEnabled()) {
+		return;
+	}
+
+	QJsonObject event {
+		{"ph", "X"},
+		{"cat", category},
+		{"name", name},
+		{"ts", toMicroseconds (startTime)},
+		{"dur", toMicroseconds (endTime - startTime)},
+	};
+
+	if (!detail.isEmpty()) {
+		event.insert ("args", QJsonObject {{"detail", detail}});
+	}
+
+	writeEvent (event);
+}
+
+uint64_t Trace::beginAsync (const char* category, const QString& name)
+{
+	if (!isEnabled()) {
+		return 0;
+	}
+
+	uint64_t id = traceFile().nextAsyncID++;
+
+	writeEvent (QJsonObject {
+		{"ph", "b"},
+		{"cat", category},
+		{"name", name},
+		{"id", static_cast<qint64> (id)},
+		{"ts", toMicroseconds (now())},
+	});
+
+	return id;
+}
+
+void Trace::endAsync (const char* category, const QString& name, uint64_t id)
+{
+	if (!id || !isEnabled()) {
+		return;
+	}
+
+	writeEvent (QJsonObject {
+		{"ph", "e"},
+		{"cat", category},
+		{"name", name},
+		{"id", static_cast<qint64> (id)},
+		{"ts", toMicroseconds (now())},
+	});
+}
+
+} /* namespace Mattermost */
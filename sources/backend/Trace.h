@@ -0,0 +1,132 @@
+/**
+ * @file Trace.h
+ * @brief Scoped trace spans in the Chrome trace event format
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <QString>
+#include "backend/StallMonitor.h"
+
+namespace Mattermost {
+
+/**
+ * Writes a timeline of the application in the Chrome trace event format (JSON array format).
+ * The file can be opened directly in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ * Tracing is disabled by default. When disabled, all calls return immediately
+ */
+class Trace {
+public:
+	/**
+	 * Start writing trace events to a file
+	 * @return false if the file cannot be opened
+	 */
+	static bool start (const QString& fileName);
+
+	/**
+	 * Finish the trace file. Events after stop() are ignored
+	 */
+	static void stop ();
+
+	static bool isEnabled ()
+	{
+		return enabled.load (std::memory_order_relaxed);
+	}
+
+	/**
+	 * Current time of the trace clock, in nanoseconds
+	 */
+	static int64_t now ();
+
+	/**
+	 * Add a complete span ('X' event)
+	 * @param startTime, endTime times, obtained from now()
+	 * @param detail optional text, shown in the arguments of the span
+	 */
+	static void complete (const char* category, const char* name, int64_t startTime, int64_t endTime, const QString& detail = QString());
+
+	/**
+	 * Start an asynchronous span ('b' event), which can end in another event handler. Used for network requests
+	 * @return id of the span, to be passed to endAsync(). 0 if tracing is disabled
+	 */
+	static uint64_t beginAsync (const char* category, const QString& name);
+
+	/**
+	 * End an asynchronous span ('e' event). Does nothing if id is 0
+	 */
+	static void endAsync (const char* category, const QString& name, uint64_t id);
+
+private:
+	static std::atomic<bool>	enabled;
+};
+
+/**
+ * Span covering the lifetime of the object (or until end() is called).
+ * Spans are written to the trace file and reported to the StallMonitor
+ */
+class TraceSpan {
+public:
+	TraceSpan (const char* category, const char* name, const QString& detail = QString())
+	:category (category)
+	,name (name)
+	,startTime (isActive() ? Trace::now() : -1)
+	{
+		if (startTime >= 0) {
+			this->detail = detail;
+		}
+	}
+
+	~TraceSpan ()
+	{
+		end ();
+	}
+
+	void end ()
+	{
+		if (startTime >= 0) {
+			int64_t endTime = Trace::now();
+			Trace::complete (category, name, startTime, endTime, detail);
+			StallMonitor::spanFinished (name, detail, startTime, endTime);
+			startTime = -1;
+		}
+	}
+
+	/**
+	 * Check whether the spans are measured. If not, the span details do not need to be prepared
+	 */
+	static bool isActive ()
+	{
+		return Trace::isEnabled() || StallMonitor::isEnabled();
+	}
+
+	TraceSpan (const TraceSpan&) = delete;
+	TraceSpan& operator= (const TraceSpan&) = delete;
+private:
+	const char*		category;
+	const char*		name;
+	QString			detail;
+	int64_t			startTime;
+};
+
+} /* namespace Mattermost */
@@ -0,0 +1,472 @@
+/**
+ * @file TrafficCapture.cpp
+ * @brief Recording and replay of the HTTP and WebSocket traffic
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "TrafficCapture.h"
+
+#include <algorithm>
+#include <memory>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+#include "ReplayNetworkAccessManager.h"
+#include "log.h"
+
+namespace Mattermost {
+
+namespace {
+
+//'MMTR' - Mattermost traffic recording
+constexpr quint32 captureFileMagic = 0x4D4D5452;
+constexpr quint32 captureFileVersion = 1;
+
+namespace CaptureRecordType {
+enum type: quint8 {
+	httpExchange = 1,
+	webSocketOpen,
+	webSocketFrameIn,
+	webSocketFrameOut,
+};
+}
+
+namespace CaptureMode {
+enum type {
+	off,
+	record,
+	replay,
+};
+}
+
+struct CapturedFrame {
+	int64_t			time;	//milliseconds since the WebSocket was opened
+	QByteArray		data;
+};
+
+/**
+ * Delivers the replayed WebSocket frames, one timer shot per frame
+ */
+class WebSocketReplay: public QObject {
+public:
+	WebSocketReplay (QObject* context, const QVector<CapturedFrame>& frames, double speed, std::function<void(const QByteArray&)> deliver)
+	:context (context)
+	,frames (frames)
+	,speed (speed)
+	,deliver (std::move (deliver))
+	,nextFrame (0)
+	{
+		timer.setSingleShot (true);
+		connect (&timer, &QTimer::timeout, this, &WebSocketReplay::deliverFrames);
+		clock.start ();
+		scheduleNextFrame ();
+	}
+
+private:
+	int64_t getFrameTime (const CapturedFrame& frame) const
+	{
+		return speed > 0 ? int64_t (frame.time / speed) : 0;
+	}
+
+	void scheduleNextFrame ()
+	{
+		if (nextFrame < frames.size()) {
+			timer.start (int (std::max<int64_t> (0, getFrameTime (frames[nextFrame]) - clock.elapsed())));
+		} else {
+			LOG_DEBUG ("Replay: all " << frames.size() << " WebSocket frames delivered");
+		}
+	}
+
+	void deliverFrames ()
+	{
+		//all frames, which are due, are delivered in one go, so that the replay does not fall behind
+		while (nextFrame < frames.size() && getFrameTime (frames[nextFrame]) <= clock.elapsed()) {
+			if (!context) {
+				return;
+			}
+
+			deliver (frames[nextFrame].data);
+			++nextFrame;
+		}
+
+		scheduleNextFrame ();
+	}
+
+private:
+	QPointer<QObject>						context;
+	const QVector<CapturedFrame>&			frames;
+	double									speed;
+	std::function<void(const QByteArray&)>	deliver;
+	int										nextFrame;
+	QTimer									timer;
+	QElapsedTimer							clock;
+};
+
+struct CaptureState {
+	CaptureMode::type								mode = CaptureMode::off;
+	QElapsedTimer									clock;
+
+	//recording
+	QFile											file;
+	QDataStream										stream;
+
+	//replay
+	double											speed = 1;
+	QHash<QString, QList<CapturedHttpExchange>>		httpExchanges;
+	QVector<CapturedFrame>							frames;
+	std::unique_ptr<WebSocketReplay>				webSocketReplay;
+};
+
+CaptureState& captureState ()
+{
+	static CaptureState instance;
+	return instance;
+}
+
+/**
+ * Requests are identified by method, path and query. The host is ignored
+ */
+QString getPath (const QUrl& url)
+{
+	QString path (url.path (QUrl::FullyEncoded));
+
+	if (url.hasQuery()) {
+		path += "?" + url.query (QUrl::FullyEncoded);
+	}
+
+	return path;
+}
+
+QString getExchangeKey (const QByteArray& method, const QString& path)
+{
+	return QString::fromLatin1 (method) + ' ' + path;
+}
+
+/**
+ * Only these headers are used by the client. All other (cookies and so on) are dropped
+ */
+bool isRecordedHeader (const QByteArray& name)
+{
+	static const QByteArray recordedHeaders[] = {"ETag", "Last-Modified", "Content-Type", "Token"};
+
+	for (const QByteArray& header: recordedHeaders) {
+		if (name.compare (header, Qt::CaseInsensitive) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool readCaptureFile (QFile& file, CaptureState& state)
+{
+	QDataStream stream (&file);
+	quint32 magic, version;
+	stream >> magic >> version;
+
+	if (magic != captureFileMagic || version != captureFileVersion) {
+		qCritical() << "Not a traffic recording, or unsupported version:" << file.fileName();
+		return false;
+	}
+
+	stream.setVersion (QDataStream::Qt_5_10);
+	int64_t webSocketOpenTime = -1;
+
+	//the recording may have been interrupted. Only the complete records are used
+	auto isTruncated = [&stream, &file] {
+		if (stream.status() == QDataStream::Ok) {
+			return false;
+		}
+
+		LOG_DEBUG ("Traffic recording is truncated: " << file.fileName());
+		return true;
+	};
+
+	while (!stream.atEnd()) {
+		quint8 recordType;
+		stream >> recordType;
+
+		if (recordType == CaptureRecordType::httpExchange) {
+			CapturedHttpExchange exchange;
+			qint64 requestTime, responseTime;
+			qint32 statusCode;
+			QByteArray compressedBody;
+
+			stream >> requestTime >> responseTime >> exchange.method >> exchange.path >> statusCode >> exchange.headers >> compressedBody;
+
+			if (isTruncated ()) {
+				break;
+			}
+
+			exchange.requestTime = requestTime;
+			exchange.responseTime = responseTime;
+			exchange.statusCode = statusCode;
+			exchange.body = qUncompress (compressedBody);
+
+			state.httpExchanges[getExchangeKey (exchange.method, exchange.path)].append (exchange);
+		} else if (recordType == CaptureRecordType::webSocketOpen) {
+			qint64 time;
+			stream >> time;
+
+			if (isTruncated ()) {
+				break;
+			}
+
+			//the frames after reconnects are timed from the first connection
+			if (webSocketOpenTime < 0) {
+				webSocketOpenTime = time;
+			}
+		} else if (recordType == CaptureRecordType::webSocketFrameIn || recordType == CaptureRecordType::webSocketFrameOut) {
+			qint64 time;
+			QByteArray data;
+			stream >> time >> data;
+
+			if (isTruncated ()) {
+				break;
+			}
+
+			if (recordType == CaptureRecordType::webSocketFrameIn) {
+				state.frames.append (CapturedFrame {time - std::max<int64_t> (webSocketOpenTime, 0), data});
+			}
+		} else if (isTruncated ()) {
+			break;
+		} else {
+			qCritical() << "Invalid record in the traffic recording" << file.fileName();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} /* namespace */
+
+bool TrafficCapture::startRecording (const QString& fileName)
+{
+	CaptureState& state (captureState());
+
+	if (state.mode != CaptureMode::off) {
+		return false;
+	}
+
+	state.file.setFileName (fileName);
+
+	if (!state.file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qCritical() << "Cannot open traffic recording" << fileName << ":" << state.file.errorString();
+		return false;
+	}
+
+	state.stream.setDevice (&state.file);
+	state.stream << captureFileMagic << captureFileVersion;
+	state.stream.setVersion (QDataStream::Qt_5_10);
+
+	state.clock.start ();
+	state.mode = CaptureMode::record;
+	LOG_DEBUG ("Recording the traffic to " << fileName);
+	return true;
+}
+
+bool TrafficCapture::startReplay (const QString& fileName, double speed)
+{
+	CaptureState& state (captureState());
+
+	if (state.mode != CaptureMode::off) {
+		return false;
+	}
+
+	QFile file (fileName);
+
+	if (!file.open (QIODevice::ReadOnly)) {
+		qCritical() << "Cannot open traffic recording" << fileName << ":" << file.errorString();
+		return false;
+	}
+
+	if (!readCaptureFile (file, state)) {
+		return false;
+	}
+
+	state.speed = speed;
+	state.clock.start ();
+	state.mode = CaptureMode::replay;
+
+	LOG_DEBUG ("Replaying " << fileName << ": " << state.httpExchanges.size() << " HTTP requests, "
+			<< state.frames.size() << " WebSocket frames, speed " << speed);
+	return true;
+}
+
+void TrafficCapture::stop ()
+{
+	CaptureState& state (captureState());
+
+	if (state.mode == CaptureMode::record) {
+		state.stream.setDevice (nullptr);
+		state.file.close ();
+	}
+
+	state.webSocketReplay.reset ();
+	state.mode = CaptureMode::off;
+}
+
+bool TrafficCapture::isRecording ()
+{
+	return captureState().mode == CaptureMode::record;
+}
+
+bool TrafficCapture::isReplaying ()
+{
+	return captureState().mode == CaptureMode::replay;
+}
+
+int64_t TrafficCapture::now ()
+{
+	return captureState().clock.elapsed();
+}
+
+QNetworkAccessManager* TrafficCapture::createNetworkAccessManager ()
+{
+	if (isReplaying()) {
+		return new ReplayNetworkAccessManager ();
+	}
+
+	return new QNetworkAccessManager ();
+}
+
+QByteArray TrafficCapture::getMethod (QNetworkAccessManager::Operation operation, const QNetworkRequest& request)
+{
+	switch (operation) {
+	case QNetworkAccessManager::HeadOperation:
+		return "HEAD";
+	case QNetworkAccessManager::GetOperation:
+		return "GET";
+	case QNetworkAccessManager::PutOperation:
+		return "PUT";
+	case QNetworkAccessManager::PostOperation:
+		return "POST";
+	case QNetworkAccessManager::DeleteOperation:
+		return "DELETE";
+	case QNetworkAccessManager::CustomOperation:
+		return request.attribute (QNetworkRequest::CustomVerbAttribute).toByteArray();
+	default:
+		return "UNKNOWN";
+	}
+}
+
+void TrafficCapture::recordHttpExchange (const QNetworkReply& reply, int64_t requestTime, const QVariant& statusCode, const QByteArray& data)
+{
+	if (!isRecording()) {
+		return;
+	}
+
+	QList<QPair<QByteArray, QByteArray>> headers;
+
+	for (const auto& header: reply.rawHeaderPairs()) {
+		if (!isRecordedHeader (header.first)) {
+			continue;
+		}
+
+		//the session token is not recorded. The client needs only to receive some token on login
+		if (header.first.compare ("Token", Qt::CaseInsensitive) == 0) {
+			headers.append (qMakePair (header.first, QByteArray (scrubbedToken)));
+		} else {
+			headers.append (header);
+		}
+	}
+
+	QDataStream& stream (captureState().stream);
+
+	stream << quint8 (CaptureRecordType::httpExchange)
+		   << qint64 (requestTime) << qint64 (now())
+		   << getMethod (reply.operation(), reply.request())
+		   << getPath (reply.url())
+		   << qint32 (statusCode.toInt())
+		   << headers
+		   << qCompress (data);
+}
+
+void TrafficCapture::recordWebSocketOpen ()
+{
+	if (!isRecording()) {
+		return;
+	}
+
+	captureState().stream << quint8 (CaptureRecordType::webSocketOpen) << qint64 (now());
+}
+
+void TrafficCapture::recordWebSocketFrame (bool outgoing, const QByteArray& frame)
+{
+	if (!isRecording()) {
+		return;
+	}
+
+	QByteArray recordedFrame (frame);
+
+	//the authentication challenge contains the session token
+	if (outgoing) {
+		QJsonObject root (QJsonDocument::fromJson (frame).object());
+		QJsonObject data (root.value ("data").toObject());
+
+		if (data.contains ("token")) {
+			data.insert ("token", scrubbedToken);
+			root.insert ("data", data);
+			recordedFrame = QJsonDocument (root).toJson (QJsonDocument::Compact);
+		}
+	}
+
+	captureState().stream << quint8 (outgoing ? CaptureRecordType::webSocketFrameOut : CaptureRecordType::webSocketFrameIn)
+						  << qint64 (now()) << recordedFrame;
+}
+
+void TrafficCapture::replayWebSocket (QObject* context, std::function<void(const QByteArray&)> deliver)
+{
+	CaptureState& state (captureState());
+
+	//the recorded frames are replayed once, on the first connection
+	if (!isReplaying() || state.webSocketReplay) {
+		return;
+	}
+
+	state.webSocketReplay = std::make_unique<WebSocketReplay> (context, state.frames, state.speed, std::move (deliver));
+}
+
+bool TrafficCapture::takeHttpExchange (const QByteArray& method, const QUrl& url, CapturedHttpExchange& exchange, int& delay)
+{
+	CaptureState& state (captureState());
+	auto it = state.httpExchanges.find (getExchangeKey (method, getPath (url)));
+
+	if (it == state.httpExchanges.end() || it->isEmpty()) {
+		return false;
+	}
+
+	exchange = it->size() > 1 ? it->takeFirst() : it->first();
+
+	int64_t responseTime = exchange.responseTime - exchange.requestTime;
+	delay = state.speed > 0 ? int (responseTime / state.speed) : 0;
+	return true;
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,142 @@
+/**
+ * @file TrafficCapture.h
+ * @brief Recording and replay of the HTTP and WebSocket traffic
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <QByteArray>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QPair>
+#include <QString>
+
+class QNetworkReply;
+class QObject;
+class QUrl;
+class QVariant;
+
+namespace Mattermost {
+
+/**
+ * HTTP request and its response, as stored in a capture file
+ */
+struct CapturedHttpExchange {
+	int64_t									requestTime;	//milliseconds since the start of the recording
+	int64_t									responseTime;
+	QByteArray								method;
+	QString									path;			//path and query, without the host
+	int										statusCode;		//0 if the server was not reached
+	QList<QPair<QByteArray, QByteArray>>	headers;
+	QByteArray								body;
+};
+
+/**
+ * Records the HTTP and WebSocket traffic to a compact file and replays it without network.
+ *
+ * When recording, every HTTP request with its response and every WebSocket frame is written,
+ * with timestamps. Secrets are not recorded: request bodies (which contain the password on login)
+ * are dropped, only the headers needed by the client are kept and the session token is replaced.
+ *
+ * When replaying, the network access manager of HTTPConnector answers the requests from the file,
+ * after the recorded response time, and the received WebSocket frames are passed to
+ * WebSocketConnector::onNewPacket with the recorded timing. The timing can be accelerated.
+ * Any server address and credentials can be used to log in, the host is ignored
+ */
+class TrafficCapture {
+public:
+	/**
+	 * Start recording the traffic
+	 * @return false if the file cannot be opened
+	 */
+	static bool startRecording (const QString& fileName);
+
+	/**
+	 * Load a recording and replay it instead of using the network
+	 * @param speed time acceleration factor. 0 replays everything without delays
+	 * @return false if the file cannot be read
+	 */
+	static bool startReplay (const QString& fileName, double speed);
+
+	/**
+	 * Finish the recording file
+	 */
+	static void stop ();
+
+	static bool isRecording ();
+	static bool isReplaying ();
+
+	/**
+	 * Milliseconds since the start of the recording
+	 */
+	static int64_t now ();
+
+	/**
+	 * Network access manager for HTTPConnector. When replaying, it answers the requests from the recording
+	 */
+	static QNetworkAccessManager* createNetworkAccessManager ();
+
+	/**
+	 * Record a finished HTTP request
+	 * @param requestTime time, when the request was sent (from now())
+	 */
+	static void recordHttpExchange (const QNetworkReply& reply, int64_t requestTime, const QVariant& statusCode, const QByteArray& data);
+
+	/**
+	 * Record that the WebSocket connection is being opened. The replayed frames are timed from this moment
+	 */
+	static void recordWebSocketOpen ();
+
+	/**
+	 * Record a WebSocket frame. Outgoing frames are scrubbed from the session token
+	 */
+	static void recordWebSocketFrame (bool outgoing, const QByteArray& frame);
+
+	/**
+	 * Start replaying the received WebSocket frames
+	 * @param context the frames are not delivered after the context object is destroyed
+	 * @param deliver called for each received frame
+	 */
+	static void replayWebSocket (QObject* context, std::function<void(const QByteArray&)> deliver);
+
+	/**
+	 * Take the next recorded response for a request. If a request was recorded several times,
+	 * the responses are returned in the recorded order, and the last one is repeated after that
+	 * @param delay receives the recorded response time, scaled with the replay speed
+	 * @return false if the request was not recorded
+	 */
+	static bool takeHttpExchange (const QByteArray& method, const QUrl& url, CapturedHttpExchange& exchange, int& delay);
+
+	/**
+	 * HTTP method of a request, for example "GET"
+	 */
+	static QByteArray getMethod (QNetworkAccessManager::Operation operation, const QNetworkRequest& request);
+
+	/**
+	 * Value of the session token in the recordings
+	 */
+	static constexpr const char* scrubbedToken = "recorded-session-token";
+};
+
+} /* namespace Mattermost */
@@ -24,47 +24,151 @@
 
 #include "WebSocketConnector.h"
 
+#include <algorithm>
 #include <iostream>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
 
 #include "backend/WebSocketEventHandler.h"
+#include "backend/Trace.h"
+#include "backend/TrafficCapture.h"
 #include "log.h"
 
 namespace Mattermost {
 
+//reconnect delays (in milliseconds) are random, up to 1, 2, 4 ... seconds, but not more than maxReconnectDelay
+static constexpr int initialReconnectDelay = 1000;
+static constexpr int maxReconnectDelay = 120000;
+
+//after staying connected for this time, the next reconnect starts with a short delay again
+static constexpr int stableConnectionTime = 60000;
+
+/*
+ * The payloads of the received packets are logged only if enabled, for example with
+ * QT_LOGGING_RULES="mattermost.websocket.payload.debug=true"
+ */
+Q_LOGGING_CATEGORY (webSocketPayloadLog, "mattermost.websocket.payload", QtInfoMsg)
+
+using EventHandler = void (*) (WebSocketConnector&, const QJsonObject&, const QJsonObject&);
+
+struct EventHandlerEntry {
+	uint32_t		nameHash;
+	const char*		name;
+	EventHandler	handler;
+};
+
+//FNV-1a
+static constexpr uint32_t eventNameHashBasis = 2166136261u;
+static constexpr uint32_t eventNameHashPrime = 16777619u;
+
+/**
+ * Hash of an event name, computed at compile time for the handlers table
+ */
+static constexpr uint32_t eventNameHash (const char* name)
+{
+	uint32_t hash = eventNameHashBasis;
+
+	for (; *name; ++name) {
+		hash = (hash ^ static_cast<unsigned char> (*name)) * eventNameHashPrime;
+	}
+
+	return hash;
+}
+
+/**
+ * Hash of a received event name. Event names are ASCII, so the result is the same as for the compile time hash
+ */
+static uint32_t eventNameHash (const QString& name)
+{
+	uint32_t hash = eventNameHashBasis;
+
+	for (QChar c: name) {
+		hash = (hash ^ c.unicode()) * eventNameHashPrime;
+	}
+
+	return hash;
+}
+
 template<typename T>
 void handler (WebSocketConnector& conn, const QJsonObject& data, const QJsonObject& broadcast)
 {
 	conn.eventHandler.handleEvent (T (data, broadcast));
 }
 
-static const QMap<QString, void(*)(WebSocketConnector&, const QJsonObject&, const QJsonObject&)> eventHandlers {
-	{"hello", [] (WebSocketConnector&, const QJsonObject&, const QJsonObject&) {
-		std::cout << "Hello" << std::endl;
-	}},
-	{"channel_viewed",		handler<ChannelViewedEvent>},
-	{"posted", 				handler<PostEvent>},
-	{"post_edited", 		handler<PostEditedEvent>},
-	{"post_deleted",		handler<PostDeletedEvent>},
-	{"reaction_added",		handler<PostReactionAddedEvent>},
-	{"reaction_removed",	handler<PostReactionRemovedEvent>},
-	{"typing",				handler<TypingEvent>},
-	{"status_change", 		handler<StatusChangeEvent>},
-	{"direct_added", 		handler<NewDirectChannelEvent>}, 		//new direct channel created
-	{"new_user",			handler<NewUserEvent>}, 				//user added to the server
-	{"user_updated",		handler<UserUpdatedEvent>}, 			//user data updated
-	{"user_added",			handler<UserAddedToChannelEvent>}, 		//user added to channel
-	{"added_to_team",		handler<UserAddedToTeamEvent>},			//user added to team
-	{"leave_team",			handler<UserLeaveTeamEvent>},			//a user has left a team
-	{"user_removed",		handler<UserRemovedFromChannelEvent>}, 	//a user (the logged-in user, or someone else) was removed from a channel
-	{"channel_created",		handler<ChannelCreatedEvent>},			//a new channel was created
-	{"channel_updated",		handler<ChannelUpdatedEvent>},			//a channel was updated
-	{"open_dialog",			handler<OpenDialogEvent>},				//a server-side dialog
+static void helloHandler (WebSocketConnector&, const QJsonObject&, const QJsonObject&)
+{
+	std::cout << "Hello" << std::endl;
+}
+
+#define EVENT_HANDLER(name, function) {eventNameHash (name), name, function}
+
+static constexpr EventHandlerEntry eventHandlers[] = {
+	EVENT_HANDLER ("hello",				helloHandler),
+	EVENT_HANDLER ("channel_viewed",	handler<ChannelViewedEvent>),
+	EVENT_HANDLER ("posted",			handler<PostEvent>),
+	EVENT_HANDLER ("post_edited",		handler<PostEditedEvent>),
+	EVENT_HANDLER ("post_deleted",		handler<PostDeletedEvent>),
+	EVENT_HANDLER ("reaction_added",	handler<PostReactionAddedEvent>),
+	EVENT_HANDLER ("reaction_removed",	handler<PostReactionRemovedEvent>),
+	EVENT_HANDLER ("typing",			handler<TypingEvent>),
+	EVENT_HANDLER ("status_change",		handler<StatusChangeEvent>),
+	EVENT_HANDLER ("direct_added",		handler<NewDirectChannelEvent>), 		//new direct channel created
+	EVENT_HANDLER ("new_user",			handler<NewUserEvent>), 				//user added to the server
+	EVENT_HANDLER ("user_updated",		handler<UserUpdatedEvent>), 			//user data updated
+	EVENT_HANDLER ("user_added",		handler<UserAddedToChannelEvent>), 		//user added to channel
+	EVENT_HANDLER ("added_to_team",		handler<UserAddedToTeamEvent>),			//user added to team
+	EVENT_HANDLER ("leave_team",		handler<UserLeaveTeamEvent>),			//a user has left a team
+	EVENT_HANDLER ("user_removed",		handler<UserRemovedFromChannelEvent>), 	//a user (the logged-in user, or someone else) was removed from a channel
+	EVENT_HANDLER ("channel_created",	handler<ChannelCreatedEvent>),			//a new channel was created
+	EVENT_HANDLER ("channel_updated",	handler<ChannelUpdatedEvent>),			//a channel was updated
+	EVENT_HANDLER ("open_dialog",		handler<OpenDialogEvent>),				//a server-side dialog
+	EVENT_HANDLER ("emoji_added",		handler<CustomEmojiAddedEvent>),		//a custom emoji was created
 };
 
+#undef EVENT_HANDLER
+
+static constexpr bool eventNameHashesAreUnique ()
+{
+	for (const EventHandlerEntry& a: eventHandlers) {
+		int count = 0;
+
+		for (const EventHandlerEntry& b: eventHandlers) {
+			if (a.nameHash == b.nameHash) {
+				++count;
+			}
+		}
+
+		if (count != 1) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static_assert (eventNameHashesAreUnique (), "Two WebSocket event names have the same hash");
+
+/**
+ * Find the handler of an event. The table is small, so a linear search over the hashes is the fastest
+ */
+static const EventHandlerEntry* findEventHandler (const QString& name)
+{
+	uint32_t nameHash = eventNameHash (name);
+
+	for (const EventHandlerEntry& entry: eventHandlers) {
+		if (entry.nameHash == nameHash && name == QLatin1String (entry.name)) {
+			return &entry;
+		}
+	}
+
+	return nullptr;
+}
+
 WebSocketConnector::WebSocketConnector (WebSocketEventHandler& eventHandler)
 :eventHandler (eventHandler)
+,reconnectAttempt (0)
 ,hasReconnect (false)
 {
 	connect (&webSocket, qOverload<QAbstractSocket::SocketError>(&QWebSocket::error), [this] (QAbstractSocket::SocketError error){
@@ -80,6 +184,7 @@ WebSocketConnector::WebSocketConnector (WebSocketEventHandler& eventHandler)
 
 		hasReconnect = false;
 		pingTimer.start (5000);
+		stableConnectionTimer.start ();
 	});
 
 	connect(&webSocket, &QWebSocket::pong, [this]{
@@ -97,7 +202,11 @@ WebSocketConnector::WebSocketConnector (WebSocketEventHandler& eventHandler)
 		}
 	});
 
-    connect(&webSocket, &QWebSocket::textMessageReceived, this, &WebSocketConnector::onNewPacket);
+    connect(&webSocket, &QWebSocket::textMessageReceived, [this] (const QString& message) {
+		onNewPacket (message.toUtf8());
+	});
+
+    connect(&webSocket, &QWebSocket::binaryMessageReceived, this, &WebSocketConnector::onNewPacket);
 
     connect (&pingTimer, &QTimer::timeout, [this] {
 		//LOG_DEBUG ("WebSocket send ping");
@@ -110,6 +219,22 @@ WebSocketConnector::WebSocketConnector (WebSocketEventHandler& eventHandler)
 		LOG_DEBUG ("WebSocket ping timeout. Reconnecting");
 		webSocket.close();
 	});
+
+    reconnectTimer.setSingleShot (true);
+    connect (&reconnectTimer, &QTimer::timeout, this, &WebSocketConnector::reconnectNow);
+
+    stableConnectionTimer.setSingleShot (true);
+    stableConnectionTimer.setInterval (stableConnectionTime);
+    connect (&stableConnectionTimer, &QTimer::timeout, [this] {
+		reconnectAttempt = 0;
+	});
+
+#ifdef WEBSOCKET_ONLINE_STATE_HINT
+QT_WARNING_PUSH
+QT_WARNING_DISABLE_DEPRECATED
+    connect (&networkConfigurationManager, &QNetworkConfigurationManager::onlineStateChanged, this, &WebSocketConnector::onOnlineStateChanged);
+QT_WARNING_POP
+#endif
 }
 
 WebSocketConnector::~WebSocketConnector () = default;
@@ -117,17 +242,33 @@ WebSocketConnector::~WebSocketConnector () = default;
 void WebSocketConnector::open (const QString& urlString, const QString& token)
 {
 	QUrl url (urlString + "websocket");
-	url.setScheme("wss");
+
+	//plain HTTP is used only by local servers (for example, the stand-in server in tools/mock-server)
+	url.setScheme(url.scheme() == "http" ? "ws" : "wss");
 
 	//qDebug() << "WebSocket open: " << url << " " << token;
 
 	this->token = token;
+
+	//the recorded frames are received instead of connecting to the server
+	if (TrafficCapture::isReplaying()) {
+		TrafficCapture::replayWebSocket (this, [this] (const QByteArray& packet) {
+			onNewPacket (packet);
+		});
+
+		emit onConnect (false);
+		return;
+	}
+
+	TrafficCapture::recordWebSocketOpen ();
 	webSocket.open (url);
 }
 
 void WebSocketConnector::close ()
 {
 	token = "";
+	reconnectTimer.stop ();
+	reconnectAttempt = 0;
 	reset ();
 }
 
@@ -135,18 +276,61 @@ void WebSocketConnector::doReconnect ()
 {
 	pingTimer.stop();
 	pongTimer.stop();
-	QTimer::singleShot (2000, [this] {
+	stableConnectionTimer.stop();
 
-		if (token.isEmpty()) {
-			return;
-		}
+	//both the error and the disconnected signals request a reconnect. Schedule it only once
+	if (reconnectTimer.isActive()) {
+		return;
+	}
 
-		LOG_DEBUG ("WebSocket Reconnecting");
-		hasReconnect = true;
-		webSocket.open (webSocket.requestUrl());
-	});
+	/*
+	 * There is no check whether the network is up: the bearer management API (QNetworkConfigurationManager)
+	 * is unreliable and deprecated. While the network is down, the failed reconnects are retried with the capped backoff.
+	 * If the API reports that the network is up again, the pending reconnect is done earlier (see onOnlineStateChanged())
+	 */
+
+	int maxDelay = maxReconnectDelay;
+
+	if (reconnectAttempt < 16) {
+		maxDelay = std::min (initialReconnectDelay << reconnectAttempt, maxReconnectDelay);
+	}
+
+	int delay = QRandomGenerator::global()->bounded (maxDelay + 1);
+	++reconnectAttempt;
+
+	LOG_DEBUG ("WebSocket reconnect attempt " << reconnectAttempt << " in " << delay << " ms");
+	reconnectTimer.start (delay);
 }
 
+void WebSocketConnector::reconnectNow ()
+{
+	reconnectTimer.stop ();
+
+	if (token.isEmpty()) {
+		return;
+	}
+
+	LOG_DEBUG ("WebSocket Reconnecting");
+	hasReconnect = true;
+	webSocket.open (webSocket.requestUrl());
+}
+
+#ifdef WEBSOCKET_ONLINE_STATE_HINT
+void WebSocketConnector::onOnlineStateChanged (bool isOnline)
+{
+	LOG_DEBUG ("Network is " << (isOnline ? "up" : "down"));
+
+	//only a pending reconnect is affected. The backoff timer is still the fallback, if the hint is wrong
+	if (!isOnline || token.isEmpty() || !reconnectTimer.isActive()) {
+		return;
+	}
+
+	//the link is back. Do not wait for the backoff delay
+	reconnectAttempt = 0;
+	reconnectNow ();
+}
+#endif
+
 void WebSocketConnector::doHandshake ()
 {
 	QJsonObject  jsonData {
@@ -160,6 +344,7 @@ void WebSocketConnector::doHandshake ()
 	});
 
 	QByteArray data = json.toJson(QJsonDocument::Compact);
+	TrafficCapture::recordWebSocketFrame (true, data);
 	webSocket.sendTextMessage (data);
 }
 
@@ -170,28 +355,23 @@ void WebSocketConnector::reset ()
 	pongTimer.stop();
 }
 
-static bool printEvent (const QString& name)
+void WebSocketConnector::onNewPacket (const QByteArray& packet)
 {
-	if (	name == "channel_viewed" 	||
-			name == "channel_updated" 	||
-			name == "reaction_added" 	||
-			name == "status_change" 	||
-			name == "posted" 			||
-			name == "typing" 			||
-			name == "reaction_removed"	||
-			name == "user_removed"		||
-			name == "user_updated"		||
-			name == "leave_team"
-	) {
-		return false;
-	}
+	qCDebug (webSocketPayloadLog).noquote() << packet;
+	TrafficCapture::recordWebSocketFrame (false, packet);
 
-	return true;
-}
+	QJsonParseError parseError;
+	QJsonDocument doc;
 
-void WebSocketConnector::onNewPacket (const QString& string)
-{
-	QJsonDocument doc = QJsonDocument::fromJson(string.toUtf8());
+	{
+		TraceSpan span ("json", "parse");
+		doc = QJsonDocument::fromJson (packet, &parseError);
+	}
+
+	if (parseError.error != QJsonParseError::NoError) {
+		LOG_DEBUG ("Invalid WebSocket packet: " << parseError.errorString());
+		return;
+	}
 
 	const QJsonObject& jsonObject = doc.object();
 
@@ -204,34 +384,17 @@ void WebSocketConnector::onNewPacket (const QString& string)
 	}
 
 	//event from server
-	QJsonValue event = jsonObject.value("event");
-
-	auto it = eventHandlers.find(event.toString());
-
+	QString eventName (jsonObject.value("event").toString());
+	const EventHandlerEntry* entry = findEventHandler (eventName);
 
-	if (it == eventHandlers.end()) {
-		QString jsonString = doc.toJson(QJsonDocument::Indented);
-		std::cout << jsonString.toStdString();
-
-		LOG_DEBUG ("Unhandled WebSocket event '" << event.toString() << "'\n");
-		qDebug() << "========" << '\n';
+	if (!entry) {
+		LOG_DEBUG ("Unhandled WebSocket event '" << eventName << "'");
 		return;
 	}
 
-	if (printEvent (it.key())) {
-		qDebug() << "========" << '\n';
-		QString jsonString = doc.toJson(QJsonDocument::Indented);
-		std::cout << jsonString.toStdString();
-	}
-
-	it.value() (*this, 	jsonObject.value ("data").toObject(),
-						jsonObject.value ("broadcast").toObject());
-
-
-//	if (obj.value("seq_reply")) {
-//
-//	}
+	TraceSpan span ("websocket", entry->name);
+	entry->handler (*this, 	jsonObject.value ("data").toObject(),
+							jsonObject.value ("broadcast").toObject());
 }
 
 } /* namespace Mattermost */
-
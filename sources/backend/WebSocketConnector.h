@@ -28,6 +28,15 @@
 #include <QTimer>
 #include <QtWebSockets/QWebSocket>
 
+/*
+ * The bearer management API is deprecated in Qt 5.15 and removed in Qt 6. Where it is available,
+ * it is used only as a hint that the network is up again, to reconnect without waiting for the backoff delay
+ */
+#if QT_VERSION < QT_VERSION_CHECK(6,0,0)
+#define WEBSOCKET_ONLINE_STATE_HINT
+#include <QNetworkConfigurationManager>
+#endif
+
 namespace Mattermost {
 
 class WebSocketEventHandler;
@@ -42,12 +51,26 @@ public:
 	void close ();
 	void reset ();
 	void doHandshake ();
+
+	/**
+	 * Parse a received packet (text or binary frame) and pass the event to the event handler
+	 */
+	void onNewPacket (const QByteArray& packet);
 signals:
 	void onConnect (bool isReconnect);
 	void onDisconnect ();
 private:
-	void onNewPacket (const QString& string);
+	/**
+	 * Schedule a reconnect, with exponential backoff and full jitter: the delay is random,
+	 * between 0 and 2^attempt seconds (max 2 minutes), so that the clients of a restarted server
+	 * do not reconnect at the same time. The reconnect is retried the same way while the network is down
+	 */
 	void doReconnect ();
+	void reconnectNow ();
+
+#ifdef WEBSOCKET_ONLINE_STATE_HINT
+	void onOnlineStateChanged (bool isOnline);
+#endif
 public:
 	WebSocketEventHandler	&eventHandler;
 private:
@@ -55,7 +78,17 @@ private:
 	QString					token;
 	QTimer					pingTimer;
 	QTimer					pongTimer;
+	QTimer					reconnectTimer;
+	QTimer					stableConnectionTimer;
+	uint32_t				reconnectAttempt;
 	bool					hasReconnect;
+
+#ifdef WEBSOCKET_ONLINE_STATE_HINT
+QT_WARNING_PUSH
+QT_WARNING_DISABLE_DEPRECATED
+	QNetworkConfigurationManager	networkConfigurationManager;
+QT_WARNING_POP
+#endif
 };
 
 } /* namespace Mattermost */
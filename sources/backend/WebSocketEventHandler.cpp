@@ -27,14 +27,24 @@
 #include <QJsonDocument>
 #include "Backend.h"
 #include "Storage.h"
+#include "Trace.h"
 #include "log.h"
 
 namespace Mattermost {
 
+//status and typing events received within this time (in milliseconds) are applied together
+static constexpr int eventBatchInterval = 250;
+
 WebSocketEventHandler::WebSocketEventHandler (Backend& backend)
 :backend (backend)
 ,storage (backend.getStorage())
 {
+	batchTimer.setSingleShot (true);
+	batchTimer.setInterval (eventBatchInterval);
+
+	QObject::connect (&batchTimer, &QTimer::timeout, [this] {
+		flushBatchedEvents ();
+	});
 }
 
 
@@ -46,7 +56,7 @@ void WebSocketEventHandler::handleEvent (const ChannelViewedEvent& event)
 	QString channelName = channel ? channel->name : event.channelId;
 
 	if (channel) {
-		emit channel->onViewed ();
+		storage.observers.channel.viewed.notify (channel->id);
 		emit backend.onChannelViewed (*channel);
 	}
 }
@@ -63,7 +73,7 @@ void WebSocketEventHandler::handleEvent (const PostEvent& event)
 
 	LOG_DEBUG ("Post in '" << channel->getTeamAndChannelName() << "' by " << post->getDisplayAuthorName() << ": " << post->message);
 
-	emit channel->onNewPost (*post);
+	storage.observers.channel.newPost.notify (channel->id, *post);
 	emit backend.onNewPost (*channel, *post);
 }
 
@@ -90,7 +100,7 @@ void WebSocketEventHandler::handleEvent (const PostEditedEvent& event)
 
 	LOG_DEBUG ("Post edited in  '" << teamName << "' : '" << channelName << "' by " << post->getDisplayAuthorName() << ": " << post->message);
 	if (channel) {
-		emit channel->onNewPost (*post);
+		storage.observers.channel.newPost.notify (channel->id, *post);
 		emit backend.onNewPost (*channel, *post);
 	}
 #endif
@@ -103,7 +113,7 @@ void WebSocketEventHandler::handleEvent (const PostDeletedEvent& event)
 	LOG_DEBUG ("Delete post in  '" << (channel ? channel->name : event.channelId) << "' : '" << event.postId);
 
 	if (channel) {
-		emit channel->onPostDeleted (event.postId);
+		channel->markPostDeleted (event.postId);
 	}
 }
 
@@ -137,28 +147,74 @@ void WebSocketEventHandler::handleEvent (const PostReactionRemovedEvent& event)
 
 void WebSocketEventHandler::handleEvent (const TypingEvent& event)
 {
-	BackendChannel* channel = storage.getChannelById(event.channelID);
+	pendingTypingUsers[event.channelID].insert (event.userID);
+	scheduleBatchFlush ();
+}
 
-	BackendUser* user = storage.getUserById (event.userID);
+void WebSocketEventHandler::handleEvent (const StatusChangeEvent& event)
+{
+	//only the latest status of the user is applied
+	pendingStatuses[event.userId] = event.statusString;
+	scheduleBatchFlush ();
+}
 
-	if (!user || !channel) {
-		return;
+void WebSocketEventHandler::scheduleBatchFlush ()
+{
+	//the timer is not restarted, so that a continuous stream of events does not delay the batch forever
+	if (!batchTimer.isActive()) {
+		batchTimer.start ();
 	}
-
-	emit (channel->onUserTyping(*user));
 }
 
-void WebSocketEventHandler::handleEvent (const StatusChangeEvent& event)
+void WebSocketEventHandler::flushBatchedEvents ()
 {
-	BackendUser* user = storage.getUserById (event.userId);
+	TraceSpan span ("websocket", "flushBatchedEvents");
 
-	if (!user) {
-		return;
+	QHash<QString, QString> statuses;
+	QHash<QString, QSet<QString>> typingUsers;
+	statuses.swap (pendingStatuses);
+	typingUsers.swap (pendingTypingUsers);
+
+	QSet<QString> changedUsers;
+
+	for (auto it = statuses.cbegin(); it != statuses.cend(); ++it) {
+		BackendUser* user = storage.getUserById (it.key());
+
+		if (!user || user->status == it.value()) {
+			continue;
+		}
+
+		user->status = it.value();
+		changedUsers.insert (user->id);
+	}
+
+	if (!changedUsers.isEmpty()) {
+		LOG_DEBUG ("Status changed for " << changedUsers.size() << " users");
+		emit backend.onUserStatusesChanged (changedUsers);
+	}
+
+	for (auto it = typingUsers.cbegin(); it != typingUsers.cend(); ++it) {
+		BackendChannel* channel = storage.getChannelById (it.key());
+
+		if (!channel) {
+			continue;
+		}
+
+		for (const QString& userID: it.value()) {
+			BackendUser* user = storage.getUserById (userID);
+
+			if (user) {
+				storage.observers.channel.userTyping.notify (channel->id, *user);
+			}
+		}
 	}
+}
 
-	LOG_DEBUG ("User " << user->getDisplayName() << " is " << event.statusString);
-	user->status = event.statusString;
-	emit (user->onStatusChanged());
+void WebSocketEventHandler::reset ()
+{
+	batchTimer.stop ();
+	pendingStatuses.clear ();
+	pendingTypingUsers.clear ();
 }
 
 void WebSocketEventHandler::handleEvent (const NewDirectChannelEvent& event)
@@ -279,18 +335,18 @@ void WebSocketEventHandler::handleEvent (const UserLeaveTeamEvent& event)
 	//if the logged-in user is being removed, remove the team from the team list
 	if (user->id == storage.loginUser->id) {
 		for (auto &channel: team->channels) {
-			emit channel->onLeave ();
+			storage.observers.channel.leave.notify (channel->id);
 		}
 
-		emit (team->onLeave());
+		storage.observers.team.leave.notify (team->id);
 		storage.eraseTeam (team->id);
 	} else {
 		for (auto &channel: team->channels) {
 			channel->members.remove (user->id);
-			emit (channel->onUserRemoved (*user));
+			storage.observers.channel.userRemoved.notify (channel->id, *user);
 		}
 		team->members.remove (user->id);
-		emit (team->onUserRemoved (*user));
+		storage.observers.team.userRemoved.notify (team->id, *user);
 	}
 	//printTeams ();
 }
@@ -311,11 +367,11 @@ void WebSocketEventHandler::handleEvent (const UserRemovedFromChannelEvent& even
 
 	//if the logged-in user is being removed, remove the channel from the team's channel list
 	if (user->id == storage.loginUser->id) {
-		emit channel->onLeave ();
+		storage.observers.channel.leave.notify (channel->id);
 		storage.eraseChannel (*channel);
 	} else {
 		channel->members.remove (user->id);
-		emit (channel->onUserRemoved (*user));
+		storage.observers.channel.userRemoved.notify (channel->id, *user);
 	}
 }
 
@@ -348,7 +404,7 @@ void WebSocketEventHandler::handleEvent (const ChannelUpdatedEvent& event)
 	channel->header = event.header;
 	channel->purpose = event.purpose;
 
-	emit channel->onUpdated();
+	storage.observers.channel.updated.notify (channel->id);
 }
 
 void WebSocketEventHandler::handleEvent (const OpenDialogEvent& event)
@@ -356,4 +412,10 @@ void WebSocketEventHandler::handleEvent (const OpenDialogEvent& event)
 	backend.getServerDialogsMap().addEvent (event);
 }
 
+void WebSocketEventHandler::handleEvent (const CustomEmojiAddedEvent& event)
+{
+	LOG_DEBUG ("Custom emoji added " << event.emojiObject.value("name").toString());
+	backend.addNewCustomEmoji (event.emojiObject);
+}
+
 } /* namespace Mattermost */
@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <QHash>
+#include <QSet>
+#include <QTimer>
 #include "events/ChannelCreatedEvent.h"
 #include "events/ChannelUpdatedEvent.h"
 #include "events/ChannelViewedEvent.h"
@@ -41,6 +44,7 @@
 #include "events/UserAddedToChannelEvent.h"
 #include "events/UserRemovedFromChannelEvent.h"
 #include "events/OpenDialogEvent.h"
+#include "events/CustomEmojiAddedEvent.h"
 
 namespace Mattermost {
 
@@ -70,10 +74,29 @@ public:
 	void handleEvent (const ChannelCreatedEvent& event);
 	void handleEvent (const ChannelUpdatedEvent& event);
 	void handleEvent (const OpenDialogEvent& event);
+	void handleEvent (const CustomEmojiAddedEvent& event);
+
+	/**
+	 * Drop the status and typing events, which are not applied yet
+	 */
+	void reset ();
+
+	/**
+	 * Apply the status and typing events, accumulated during the last batch interval.
+	 * Each user gets at most one status change and one typing notification per channel.
+	 * Called by the batch timer
+	 */
+	void flushBatchedEvents ();
+private:
+	void scheduleBatchFlush ();
 private:
 	Backend& backend;
 	Storage& storage;
 
+	QTimer								batchTimer;
+	QHash<QString, QString>				pendingStatuses;		//user ID -> latest status
+	QHash<QString, QSet<QString>>		pendingTypingUsers;		//channel ID -> IDs of the typing users
+
 };
 
 } /* namespace Mattermost */
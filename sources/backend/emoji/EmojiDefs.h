@@ -149,5 +149,11 @@ using Emoji = NonSkinVariadicEmoji;
 
 static constexpr int SKINVARIADIC_START_INDEX = 2048;
 
+/**
+ * Custom emojis from the server have sequence numbers after the skin-variadic emojis,
+ * so that a large number of custom emojis does not overlap them
+ */
+static constexpr int CUSTOM_EMOJI_START_INDEX = 8192;
+
 } /* namespace Mattermost */
 
@@ -25,6 +25,7 @@
 #include "EmojiInfo.h"
 #include <QMap>
 #include <QDebug>
+#include <limits>
 
 namespace Mattermost {
 
@@ -32,7 +33,21 @@ extern uint32_t lastCategorySeq[EmojiCategory::COUNT];
 extern QVector<Emoji> emojiVecNoSkinVariadic[EmojiCategory::COUNT];
 extern QVector<SkinVariadicEmoji> emojiVecSkinVariadic;
 extern QMap<QString, EmojiSeq>  emojiMap;
-extern uint32_t nextEmojiSeq;
+
+struct CustomEmoji {
+	QString		name;
+	QString		id;
+	uint64_t	updateTime;
+	QString		imagePath;
+	bool		imageRequested;
+	bool		deleted;
+};
+
+/**
+ * Custom emojis from the server. The index in the vector is the sequence number - CUSTOM_EMOJI_START_INDEX
+ */
+static QVector<CustomEmoji> customEmojis;
+static EmojiInfo::CustomEmojiImageProvider customEmojiImageProvider;
 
 /**
  * Search for a skin tone string in the emoji name. Remove it, when performing lookup,
@@ -106,6 +121,17 @@ Emoji EmojiInfo::getEmoji (const EmojiID& emojiID)
 		return emojiVecNoSkinVariadic[category][emojiIndex];
 	}
 
+	if (emojiID.seq >= CUSTOM_EMOJI_START_INDEX) {
+		uint32_t emojiIndex = emojiID.seq - CUSTOM_EMOJI_START_INDEX;
+
+		if (emojiIndex < (uint32_t) customEmojis.size()) {
+			return getCustomEmoji (emojiIndex);
+		}
+
+		qDebug () << "No emoji with seq " << emojiID.seq << " found";
+		return Emoji {"",""};
+	}
+
 	if (emojiID.seq < SKINVARIADIC_START_INDEX) {
 		qDebug () << "No emoji with seq " << emojiID.seq << " found";
 		return Emoji {"",""};
@@ -139,15 +165,110 @@ QVector<Emoji> EmojiInfo::getAllEmojis (uint32_t category, uint32_t skinTone)
 		}
 	}
 
+	//custom emoji images are not requested here. The emoji picker requests them when they are shown
+	if (category == EmojiCategory::custom) {
+		for (int i = 0; i < customEmojis.size(); ++i) {
+			if (customEmojis[i].deleted) {
+				continue;
+			}
+
+			ret.push_back (getCustomEmoji (i, false));
+		}
+	}
+
 	return ret;
 }
 
-void EmojiInfo::addCustomEmoji (const QString& emojiName, const QString& emojiPath)
+void EmojiInfo::addCustomEmoji (const QString& emojiName, const QString& emojiID, uint64_t updateTime)
+{
+	auto it = emojiMap.find (emojiName);
+
+	if (it != emojiMap.end()) {
+
+		//built-in emojis with the same name are not replaced
+		if (it.value() < CUSTOM_EMOJI_START_INDEX) {
+			return;
+		}
+
+		CustomEmoji& emoji = customEmojis[it.value() - CUSTOM_EMOJI_START_INDEX];
+
+		//the emoji was deleted and created again, or its image was changed
+		if (emoji.id != emojiID || emoji.updateTime != updateTime) {
+			emoji = CustomEmoji {emojiName, emojiID, updateTime, "", false, false};
+		}
+
+		return;
+	}
+
+	if (CUSTOM_EMOJI_START_INDEX + customEmojis.size() > std::numeric_limits<EmojiSeq>::max()) {
+		qDebug () << "Too many custom emojis. " << emojiName << " is not added";
+		return;
+	}
+
+	emojiMap[emojiName] = CUSTOM_EMOJI_START_INDEX + customEmojis.size();
+	customEmojis.push_back (CustomEmoji {emojiName, emojiID, updateTime, "", false, false});
+}
+
+void EmojiInfo::setCustomEmojiImage (const QString& emojiName, const QString& emojiPath)
+{
+	auto it = emojiMap.find (emojiName);
+
+	if (it == emojiMap.end() || it.value() < CUSTOM_EMOJI_START_INDEX) {
+		return;
+	}
+
+	customEmojis[it.value() - CUSTOM_EMOJI_START_INDEX].imagePath = emojiPath;
+}
+
+void EmojiInfo::resetCustomEmojiImageRequest (const QString& emojiName)
+{
+	auto it = emojiMap.find (emojiName);
+
+	if (it == emojiMap.end() || it.value() < CUSTOM_EMOJI_START_INDEX) {
+		return;
+	}
+
+	customEmojis[it.value() - CUSTOM_EMOJI_START_INDEX].imageRequested = false;
+}
+
+void EmojiInfo::retainCustomEmojis (const QSet<QString>& emojiNames)
+{
+	for (CustomEmoji& emoji: customEmojis) {
+		if (emoji.deleted || emojiNames.contains (emoji.name)) {
+			continue;
+		}
+
+		/*
+		 * The entry is kept, because posts may still refer to its sequence number. Such emojis are shown by name.
+		 * If an emoji with the same name is created again, it gets a new sequence number
+		 */
+		emoji.deleted = true;
+		emoji.imagePath.clear ();
+		emojiMap.remove (emoji.name);
+	}
+}
+
+void EmojiInfo::setCustomEmojiImageProvider (CustomEmojiImageProvider provider)
 {
-	emojiVecNoSkinVariadic[EmojiCategory::custom].push_back (Emoji {emojiName, " <img src=\"" + emojiPath + "\" width=32 height=32> "});
-	emojiMap[emojiName] = nextEmojiSeq;
-	++nextEmojiSeq;
-	++lastCategorySeq[EmojiCategory::custom];
+	customEmojiImageProvider = provider;
+}
+
+Emoji EmojiInfo::getCustomEmoji (uint32_t index, bool requestImage)
+{
+	CustomEmoji& emoji = customEmojis[index];
+
+	//the image is obtained the first time the emoji is used
+	if (requestImage && !emoji.deleted && emoji.imagePath.isEmpty() && !emoji.imageRequested && customEmojiImageProvider) {
+		emoji.imageRequested = true;
+		emoji.imagePath = customEmojiImageProvider (emoji.name, emoji.id, emoji.updateTime);
+	}
+
+	//until the image is received, the emoji is shown by name
+	if (emoji.imagePath.isEmpty()) {
+		return Emoji {emoji.name, ":" + emoji.name + ":"};
+	}
+
+	return Emoji {emoji.name, " <img src=\"" + emoji.imagePath + "\" width=32 height=32> "};
 }
 
 } /* namespace Mattermost */
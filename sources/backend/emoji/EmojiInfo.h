@@ -25,6 +25,8 @@
 #pragma once
 
 #include <QVector>
+#include <QSet>
+#include <functional>
 #include "EmojiDefs.h"
 
 namespace Mattermost {
@@ -49,17 +51,57 @@ public:
 	 */
 	static Emoji getEmoji (const EmojiID& emojiID);
 
+	/**
+	 * Get all emojis in a category. The images of custom emojis are not requested,
+	 * custom emojis without image are returned as ':name:'. Use getEmoji() to request them
+	 */
 	static QVector<Emoji> getAllEmojis (uint32_t category, uint32_t skinTone);
 
 	/**
-	 * Add a custom emoji.
+	 * Called the first time a custom emoji without image is used (rendered, or shown in the current picker tab)
+	 * @param emojiName emoji name
+	 * @param emojiID custom emoji ID on the server
+	 * @param updateTime last update time of the custom emoji
+	 * @return path to the image, if it is available locally. Otherwise the image should be requested
+	 *         and set with setCustomEmojiImage() when it is received
+	 */
+	using CustomEmojiImageProvider = std::function<QString (const QString& emojiName, const QString& emojiID, uint64_t updateTime)>;
+
+	/**
+	 * Add a custom emoji. The image is not needed until the emoji is used, it is obtained using the image provider.
 	 * Custom emojis use image instead of unicode codepoints.
 	 * However, images can be represented as <img> tags in Qt's QLabel rich text.
-	 * This allows custom emojis also to use strings as values
+	 * This allows custom emojis also to use strings as values.
+	 * If an emoji with the same name exists, it is updated
+	 * @param emojiName emoji name
+	 * @param emojiID custom emoji ID on the server
+	 * @param updateTime last update time of the custom emoji
+	 */
+	static void addCustomEmoji (const QString& emojiName, const QString& emojiID, uint64_t updateTime);
+
+	/**
+	 * Set the image of a custom emoji, after it is received
 	 * @param emojiName emoji name
 	 * @param emojiPath path to the emoji image
 	 */
-	static void addCustomEmoji (const QString& emojiName, const QString& emojiPath);
+	static void setCustomEmojiImage (const QString& emojiName, const QString& emojiPath);
+
+	/**
+	 * The image of a custom emoji could not be received. It is requested again the next time the emoji is used
+	 * @param emojiName emoji name
+	 */
+	static void resetCustomEmojiImageRequest (const QString& emojiName);
+
+	/**
+	 * Remove the custom emojis, which are not in the list (they were deleted on the server).
+	 * Their sequence numbers are not reused, so EmojiIDs of the other emojis remain valid
+	 * @param emojiNames names of all custom emojis on the server
+	 */
+	static void retainCustomEmojis (const QSet<QString>& emojiNames);
+
+	static void setCustomEmojiImageProvider (CustomEmojiImageProvider provider);
+private:
+	static Emoji getCustomEmoji (uint32_t index, bool requestImage = true);
 };
 
 } /* namespace Mattermost */
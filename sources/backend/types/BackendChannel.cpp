@@ -25,9 +25,11 @@
 #include <QJsonObject>
 #include <QDebug>
 #include <QJsonArray>
+#include <algorithm>
 #include "BackendChannel.h"
 #include "BackendPoll.h"
 #include "backend/Storage.h"
+#include "backend/Trace.h"
 #include "log.h"
 
 namespace Mattermost {
@@ -101,33 +103,35 @@ BackendChannel::BackendChannel (Storage& storage, const QJsonObject& jsonObject)
 	referenceCount = 1;
 }
 
-BackendChannel::~BackendChannel () = default;
+BackendChannel::~BackendChannel ()
+{
+	//the search index refers to the posts of the channel
+	if (!posts.empty()) {
+		storage.searchIndex.removeChannel (*this);
+	}
+}
 
 BackendPost* BackendChannel::addPost (const QJsonObject& postObject)
 {
-	posts.emplace_back (postObject, storage);
-
-	BackendPost* newPost = &posts.back ();
+	BackendPost* newPost = posts.append (postObject, storage);
 	postIdToPost[newPost->id] = newPost;
+	addToThread (*newPost, false);
+	storage.searchIndex.addPost (*this, *newPost);
 	return newPost;
 }
 
-void BackendChannel::addPost (const QJsonObject& postObject, std::list<BackendPost>::iterator position, ChannelNewPostsChunk& currentChunk, QVector<QPair<QString, QString>>& rootIdAndPostList, bool initialLoad)
+void BackendChannel::addPost (const QJsonObject& postObject, size_t position, ChannelNewPostsChunk& currentChunk, bool initialLoad)
 {
 	/*
 	 * Add a post.
 	 * And add added post to the list of new posts
 	 */
-	BackendPost* newPost = &*posts.emplace (position, postObject, storage);
+	BackendPost* newPost = posts.insert (position, postObject, storage);
 	postIdToPost[newPost->id] = newPost;
 
 	currentChunk.postsToAdd.emplace_front (newPost);
-
-	QString rootId = postObject.value("root_id").toString();
-
-	if (!rootId.isEmpty()) {
-		rootIdAndPostList.push_back(QPair<QString,QString> (rootId, newPost->id));
-	}
+	addToThread (*newPost, false);
+	storage.searchIndex.addPost (*this, *newPost);
 
 	if (!initialLoad) {
 		qDebug() << newPost->create_at << " " << newPost->id << " " << newPost->getDisplayAuthorName() << " " << newPost->message;
@@ -137,6 +141,8 @@ void BackendChannel::addPost (const QJsonObject& postObject, std::list<BackendPo
 
 void BackendChannel::prependPosts (const QJsonArray& orderArray, const QJsonObject& postsObject)
 {
+	TraceSpan span ("storage", "prependPosts", display_name);
+
 	/*
 	 * A list of (sequential) groups of new posts
 	 */
@@ -147,14 +153,12 @@ void BackendChannel::prependPosts (const QJsonArray& orderArray, const QJsonObje
 	 */
 	ChannelNewPostsChunk currentNewPostsChunk;
 
-	QVector<QPair<QString, QString>> rootIdAndPostList;
-
 	bool initialLoad = true;
 
 	//add all posts to the beginning of the posts list
 	for (const auto& newPostEl: orderArray) {
 		QString newPostId = newPostEl.toString();
-		addPost (postsObject.find (newPostId).value().toObject(), posts.begin (), currentNewPostsChunk, rootIdAndPostList, initialLoad);
+		addPost (postsObject.find (newPostId).value().toObject(), 0, currentNewPostsChunk, initialLoad);
 	}
 
 	//if there are new posts left, add them to allMissingPosts
@@ -162,11 +166,15 @@ void BackendChannel::prependPosts (const QJsonArray& orderArray, const QJsonObje
 		allNewPosts.addChunk (std::move (currentNewPostsChunk));
 	}
 
-	emit onNewPosts (allNewPosts);
+	//the posts are shown by the observers of newPosts, which are traced separately
+	span.end ();
+	storage.observers.channel.newPosts.notify (id, allNewPosts);
 }
 
 void BackendChannel::addPosts (const QJsonArray& orderArray, const QJsonObject& postsObject)
 {
+	TraceSpan span ("storage", "addPosts", display_name);
+
 	/*
 	 * A list of (sequential) groups of new posts
 	 */
@@ -177,12 +185,11 @@ void BackendChannel::addPosts (const QJsonArray& orderArray, const QJsonObject&
 	 */
 	ChannelNewPostsChunk currentNewPostsChunk;
 
-	QVector<QPair<QString, QString>> rootIdAndPostList;
-
 	/* Position to add new posts (if any)
-	 * local posts are searched from newest to oldest
+	 * local posts are searched from newest to oldest. The current local post is posts[currentLocalPost - 1],
+	 * new posts are inserted at currentLocalPost (after the current local post)
 	 */
-	std::list<BackendPost>::reverse_iterator currentLocalPost = posts.rbegin();
+	size_t currentLocalPost = posts.size();
 
 #warning "Handle case of deleted post, that is not deleted locally"
 
@@ -196,8 +203,8 @@ void BackendChannel::addPosts (const QJsonArray& orderArray, const QJsonObject&
 		 * if a post is deleted, it will exist locally (with 'message deleted' text), but will not exist in the list of received posts.
 		 * Deleted posts are not affected. They will not be present after client restart
 		 */
-		while (currentLocalPost != posts.rend() && currentLocalPost->isDeleted) {
-			++currentLocalPost;
+		while (currentLocalPost != 0 && posts[currentLocalPost - 1].isDeleted) {
+			--currentLocalPost;
 		}
 
 		QString newPostId = newPostEl.toString();
@@ -206,9 +213,8 @@ void BackendChannel::addPosts (const QJsonArray& orderArray, const QJsonObject&
 		 * end of local posts list. Save the current missing post sequence and add all missing posts.
 		 * This is the case when scrolling up and getting older posts.
 		 */
-		if (currentLocalPost == posts.rend()) {
-			addPost (postsObject.find (newPostId).value().toObject(), posts.begin (), currentNewPostsChunk, rootIdAndPostList, initialLoad);
-			++currentLocalPost;
+		if (currentLocalPost == 0) {
+			addPost (postsObject.find (newPostId).value().toObject(), 0, currentNewPostsChunk, initialLoad);
 			continue;
 		}
 
@@ -217,8 +223,8 @@ void BackendChannel::addPosts (const QJsonArray& orderArray, const QJsonObject&
 		 */
 
 		//post already exists. No need to be added. Save the current missing posts chunk and start a new one
-		if (currentLocalPost->id == newPostId) {
-			++currentLocalPost;
+		if (posts[currentLocalPost - 1].id == newPostId) {
+			--currentLocalPost;
 
 			if (lastPostWasSkipped) {
 				currentNewPostsChunk.previousPostId = newPostId;
@@ -230,44 +236,20 @@ void BackendChannel::addPosts (const QJsonArray& orderArray, const QJsonObject&
 
 		//post not found. Add it to the list of new posts
 		qDebug () << "Add after currentLocalPost";
-		addPost (postsObject.find (newPostId).value().toObject(), currentLocalPost.base(), currentNewPostsChunk, rootIdAndPostList, initialLoad);
-		++currentLocalPost;
+		addPost (postsObject.find (newPostId).value().toObject(), currentLocalPost, currentNewPostsChunk, initialLoad);
 		lastPostWasSkipped = true;
 	}
 
 	//if there are new posts left, add them to allMissingPosts
 	if (!currentNewPostsChunk.postsToAdd.empty()) {
-		if (currentLocalPost != posts.rend()) {
-			currentNewPostsChunk.previousPostId = currentLocalPost->id;
+		if (currentLocalPost != 0) {
+			currentNewPostsChunk.previousPostId = posts[currentLocalPost - 1].id;
 		}
 		allNewPosts.addChunk (std::move (currentNewPostsChunk));
 	}
 
-	/**
-	 * Associate post with a root ID (if exists)
-	 */
-	for (auto& it: rootIdAndPostList) {
-		QString& rootID = it.first;
-		QString& postID = it.second;
-
-		BackendPost* rootPost = findPostById (rootID);
-		BackendPost* post = findPostById (postID);
-
-		if (!rootPost) {
-			LOG_DEBUG("root post " << rootID << " not found  (to be associated with post " << postID << ")");
-			continue;
-		}
-
-		if (!post) {
-			LOG_DEBUG("post " << postID << " not found (to be associated with root " << rootID << ")");
-			continue;
-		}
-
-		LOG_DEBUG("post " << postID << " add root " << rootID << ")");
-		post->rootPost = rootPost;
-	}
-
-	emit onNewPosts (allNewPosts);
+	span.end ();
+	storage.observers.channel.newPosts.notify (id, allNewPosts);
 }
 
 void BackendChannel::addPinnedPosts (const QJsonArray& orderArray, const QJsonObject& postsObject)
@@ -281,7 +263,7 @@ void BackendChannel::addPinnedPosts (const QJsonArray& orderArray, const QJsonOb
 	}
 
 	if (!pinnedPosts.empty()) {
-		emit onPinnedPostsReceived ();
+		storage.observers.channel.pinnedPostsReceived.notify (id);
 	}
 }
 
@@ -295,7 +277,8 @@ void BackendChannel::editPost (BackendPost& newPost)
 	}
 
 	existingPost->updatePostEdits (newPost);
-	emit onPostEdited (*existingPost);
+	storage.searchIndex.updatePost (*this, *existingPost);
+	storage.observers.channel.postEdited.notify (id, *existingPost);
 }
 
 void BackendChannel::addPostReaction (QString postId, QString userId, QString emojiName)
@@ -307,8 +290,8 @@ void BackendChannel::addPostReaction (QString postId, QString userId, QString em
 		return;
 	}
 
-	existingPost->addReaction (storage.getUserDisplayNameByUserId (userId, true), emojiName);
-	emit onPostReactionUpdated (*existingPost);
+	existingPost->addReaction (storage, userId, emojiName);
+	storage.observers.channel.postReactionUpdated.notify (id, *existingPost);
 }
 
 void BackendChannel::removePostReaction (QString postId, QString userId, QString emojiName)
@@ -320,8 +303,105 @@ void BackendChannel::removePostReaction (QString postId, QString userId, QString
 		return;
 	}
 
-	existingPost->removeReaction (storage.getUserDisplayNameByUserId (userId, true), emojiName);
-	emit onPostReactionUpdated (*existingPost);
+	existingPost->removeReaction (userId, emojiName);
+	storage.observers.channel.postReactionUpdated.notify (id, *existingPost);
+}
+
+void BackendChannel::markPostDeleted (const QString& postId)
+{
+	BackendPost* existingPost = findPostById (postId);
+
+	if (!existingPost) {
+		LOG_DEBUG ("BackendChannel::markPostDeleted: post with ID " << postId << " not found");
+		return;
+	}
+
+	existingPost->isDeleted = true;
+	removeFromThread (*existingPost);
+	storage.searchIndex.removePost (*existingPost);
+	storage.observers.channel.postDeleted.notify (id, postId);
+}
+
+void BackendChannel::addThreadPosts (const QJsonArray& orderArray, const QJsonObject& postsObject)
+{
+	for (const auto& postEl: orderArray) {
+		QString postId = postEl.toString();
+
+		//already loaded, either in the channel or with an earlier thread request
+		if (findPostById (postId)) {
+			continue;
+		}
+
+		BackendPost* post = threadPosts.append (postsObject.find (postId).value().toObject(), storage);
+		addToThread (*post, true);
+		threadPostIdToPost[post->id] = post;
+	}
+}
+
+BackendPost* BackendChannel::getThreadRoot (const QString& rootId)
+{
+	return findPostById (rootId);
+}
+
+QVector<BackendPost*> BackendChannel::getThreadReplies (const QString& rootId) const
+{
+	return threadReplies.value (rootId);
+}
+
+void BackendChannel::addToThread (BackendPost& post, bool isThreadPost)
+{
+	/*
+	 * A channel post may replace a post, which was loaded earlier with its thread
+	 * (scrolling up to it after the thread was opened)
+	 */
+	bool replacesThreadPost = !isThreadPost && threadPostIdToPost.remove (post.id) != 0;
+
+	//a root post (or a post, which can become one). Link the replies, which are loaded before it
+	if (post.root_id.isEmpty()) {
+		auto it = threadReplies.find (post.id);
+
+		if (it != threadReplies.end()) {
+			for (BackendPost* reply: it.value()) {
+				reply->rootPost = &post;
+			}
+		}
+		return;
+	}
+
+	QVector<BackendPost*>& replies = threadReplies[post.root_id];
+
+	auto byCreateTime = [] (uint64_t createAt, const BackendPost* reply) {
+		return createAt < reply->create_at;
+	};
+
+	if (replacesThreadPost) {
+		auto existing = std::find_if (replies.begin(), replies.end(), [&post] (const BackendPost* reply) {
+			return reply->id == post.id;
+		});
+
+		if (existing != replies.end()) {
+			replies.erase (existing);
+		}
+	}
+
+	//replies mostly come in order, so the insert position is usually the end
+	replies.insert (std::upper_bound (replies.begin(), replies.end(), post.create_at, byCreateTime), &post);
+	post.rootPost = findPostById (post.root_id);
+}
+
+void BackendChannel::removeFromThread (const BackendPost& post)
+{
+	if (post.root_id.isEmpty()) {
+		return;
+	}
+
+	auto it = threadReplies.find (post.root_id);
+
+	if (it == threadReplies.end()) {
+		return;
+	}
+
+	it.value().removeOne (const_cast<BackendPost*> (&post));
 }
 
 QSet<const BackendUser*> BackendChannel::getAllMembers () const
@@ -351,7 +431,7 @@ BackendPost* BackendChannel::findPostById (QString postID)
 	auto it = postIdToPost.find (postID);
 
 	if (it == postIdToPost.end()) {
-		return nullptr;
+		return threadPostIdToPost.value (postID, nullptr);
 	}
 
 	return it.value();
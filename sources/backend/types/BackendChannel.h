@@ -25,9 +25,12 @@
 #pragma once
 
 #include <QVariant>
+#include <QHash>
 #include "BackendPost.h"
+#include "BackendChannelPosts.h"
 #include "BackendChannelMember.h"
 #include "BackendChannelProperties.h"
+#include "backend/HTTPConnector.h"
 #include "fwd.h"
 
 class QJsonObject;
@@ -56,8 +59,10 @@ struct ChannelNewPosts {
 };
 
 
-class BackendChannel: public QObject {
-	Q_OBJECT
+/**
+ * Plain value type. Changes are observed through Storage::observers.channel, keyed by the channel ID
+ */
+class BackendChannel {
 public:
 	enum type {
 		unknown,
@@ -85,89 +90,30 @@ public:
 	void editPost (BackendPost& newPost);
 	void addPostReaction (QString postId, QString userId, QString emojiName);
 	void removePostReaction (QString postId, QString userId, QString emojiName);
-signals:
-
-	/**
-	 * Called when a channel is being viewed, either from this or from another Mattermost instance.
-	 * Same notification as Backend::onChannelViewed()
-	 */
-	void onViewed ();
-
-	/**
-	 * Called when a channel is being updated. For example, changing the channel title or image
-	 */
-	void onUpdated ();
-
-	/**
-	 * Called when new posts are received.
-	 * Either after init or after WebSocket disconnect.
-	 *
-	 * @param posts Collection of the missing posts only
-	 */
-	void onNewPosts (const ChannelNewPosts& collection);
-
-	/**
-	 * Called when pinned posts are received.
-	 * Either after init or after WebSocket disconnect.
-	 */
-	void onPinnedPostsReceived ();
-
-	/**
-	 * Called when a new post has arrived in the channel
-	 * Same notification as Backend::onNewPost()
-	 * @param post post
-	 */
-	void onNewPost (BackendPost& post);
-
-	/**
-	 * Called when a post is being edited
-	 * @param post post
-	 */
-	void onPostEdited (BackendPost& post);
-
-	/**
-	 * Called when a post reaction is being updated (added or removed)
-	 * @param post post
-	 */
-	void onPostReactionUpdated (BackendPost& post);
-
-	/**
-	 * Called when a post is being deleted
-	 * @param postId postId
-	 */
-	void onPostDeleted (const QString& postId);
-
-	/**
-	 * Called when someone is typing in the channel.
-	 * Typing notifications are sent ~every 5 seconds, while the user is typing
-	 * @param user user, who is typing
-	 */
-	void onUserTyping (const BackendUser& user);
-
-	/**
-	 * Called when there were missed posts - for example, because of a disconnect
-	 */
-	void onMissedPosts ();
+	void markPostDeleted (const QString& postId);
 
 	/**
-	 * Called when the logged-in user is removed from the channel, or has left the channel
+	 * Add the posts of a thread (posts/{post_id}/thread). Posts, which are not loaded
+	 * in the channel are kept aside, only for the thread view
 	 */
-	void onLeave ();
+	void addThreadPosts (const QJsonArray& orderArray, const QJsonObject& postsObject);
 
 	/**
-	 * Called when a user has been added to the channel
+	 * Root post of a thread, either loaded in the channel or with its thread. nullptr if not loaded
 	 */
-	void onUserAdded (const BackendUser& user);
+	BackendPost* getThreadRoot (const QString& rootId);
 
 	/**
-	 * Called when a user (other than the logged-in user) has been removed from the channel
+	 * Replies of a thread, ordered by creation time
 	 */
-	void onUserRemoved (const BackendUser& user);
+	QVector<BackendPost*> getThreadReplies (const QString& rootId) const;
 private:
-	void addPost (const QJsonObject& postObject, std::list<BackendPost>::iterator position, ChannelNewPostsChunk& currentChunk, QVector<QPair<QString, QString>>& rootIdAndPostList, bool initialLoad);
+	void addPost (const QJsonObject& postObject, size_t position, ChannelNewPostsChunk& currentChunk, bool initialLoad);
 	BackendPost* findPostById (QString postID);
+	void addToThread (BackendPost& post, bool isThreadPost);
+	void removeFromThread (const BackendPost& post);
 public:
-	const Storage&					storage;
+	Storage&						storage;
     QString							id;
     uint64_t						create_at;
     uint64_t						update_at;
@@ -188,9 +134,21 @@ public:
     uint32_t						referenceCount;
 
     QMap<QString, BackendPost*>		postIdToPost;
-    std::list<BackendPost>			posts;
+    BackendChannelPosts				posts;
     std::list<BackendPost>			pinnedPosts;
+
+    //root post ID -> replies, ordered by creation time. Updated on every added or deleted post
+    QHash<QString, QVector<BackendPost*>>	threadReplies;
+
+    //posts, received with a thread, which are older than the loaded channel posts
+    BackendChannelPosts				threadPosts;
+    QHash<QString, BackendPost*>	threadPostIdToPost;
+
+    //requests, whose callbacks refer to the channel. Cancelled when the channel is destroyed
+    HttpRequestList					requests;
 };
 
 } /* namespace Mattermost */
 
+Q_DECLARE_METATYPE (Mattermost::BackendChannel*)
+
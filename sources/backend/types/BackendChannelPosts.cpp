@@ -0,0 +1,80 @@
+/**
+ * @file BackendChannelPosts.cpp
+ * @brief Posts of a channel, allocated in per-channel chunks
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "BackendChannelPosts.h"
+
+#include <new>
+
+namespace Mattermost {
+
+BackendChannelPosts::BackendChannelPosts () = default;
+
+BackendChannelPosts::~BackendChannelPosts ()
+{
+	clear ();
+}
+
+BackendPost* BackendChannelPosts::allocate ()
+{
+	if (chunks.empty() || chunks.back()->used == postsPerChunk) {
+		//not value-initialized: the slots are not zeroed
+		chunks.push_back (std::unique_ptr<Chunk> (new Chunk));
+	}
+
+	Chunk& chunk = *chunks.back();
+	return reinterpret_cast<BackendPost*> (&chunk.slots[chunk.used]);
+}
+
+BackendPost* BackendChannelPosts::insert (size_t position, const QJsonObject& postObject, const Storage& storage)
+{
+	BackendPost* post = new (allocate ()) BackendPost (postObject, storage);
+
+	//the slot is taken only when the post is constructed
+	++chunks.back()->used;
+
+	order.insert (order.begin() + position, post);
+	return post;
+}
+
+BackendPost* BackendChannelPosts::append (const QJsonObject& postObject, const Storage& storage)
+{
+	return insert (order.size(), postObject, storage);
+}
+
+void BackendChannelPosts::clear ()
+{
+	for (BackendPost* post: order) {
+		post->~BackendPost ();
+	}
+
+	order.clear ();
+	chunks.clear ();
+}
+
+size_t BackendChannelPosts::getCapacityBytes () const
+{
+	return chunks.size() * sizeof (Chunk) + order.capacity() * sizeof (BackendPost*);
+}
+
+} /* namespace Mattermost */
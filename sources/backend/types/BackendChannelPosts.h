@@ -0,0 +1,127 @@
+/**
+ * @file BackendChannelPosts.h
+ * @brief Posts of a channel, allocated in per-channel chunks
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "BackendPost.h"
+
+namespace Mattermost {
+
+/**
+ * Posts of a channel, ordered from the oldest to the newest.
+ *
+ * Instead of a heap node per post, the posts are created in chunks, owned by the channel.
+ * A post never moves once created, so the BackendPost pointers (postIdToPost, rootPost, new posts chunks)
+ * and the references, held by the post widgets, stay valid until the posts are cleared.
+ * The order is kept in a separate array of pointers, so inserting older or missing posts does not move posts
+ */
+class BackendChannelPosts {
+public:
+	template <typename Post, typename BaseIterator>
+	class Iterator {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = BackendPost;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Post*;
+		using reference = Post&;
+
+		explicit Iterator (BaseIterator it)
+		:it (it)
+		{
+		}
+
+		Post& operator* () const		{ return **it; }
+		Post* operator-> () const		{ return *it; }
+		Iterator& operator++ ()			{ ++it; return *this; }
+		Iterator& operator-- ()			{ --it; return *this; }
+
+		bool operator== (const Iterator& other) const	{ return it == other.it; }
+		bool operator!= (const Iterator& other) const	{ return it != other.it; }
+	private:
+		BaseIterator		it;
+	};
+
+	using iterator = Iterator<BackendPost, std::vector<BackendPost*>::const_iterator>;
+	using const_iterator = Iterator<const BackendPost, std::vector<BackendPost*>::const_iterator>;
+
+	static constexpr size_t postsPerChunk = 64;
+
+	BackendChannelPosts ();
+	~BackendChannelPosts ();
+
+	BackendChannelPosts (const BackendChannelPosts&) = delete;
+	BackendChannelPosts& operator= (const BackendChannelPosts&) = delete;
+public:
+
+	/**
+	 * Create a post and insert it in the given position
+	 * @param position index of the post, before which the new one is inserted. size() to append
+	 * @return the new post
+	 */
+	BackendPost* insert (size_t position, const QJsonObject& postObject, const Storage& storage);
+
+	BackendPost* append (const QJsonObject& postObject, const Storage& storage);
+
+	/**
+	 * Destroy all posts and release the chunks at once
+	 */
+	void clear ();
+
+	size_t size () const				{ return order.size(); }
+	bool empty () const					{ return order.empty(); }
+
+	BackendPost& operator[] (size_t index)				{ return *order[index]; }
+	const BackendPost& operator[] (size_t index) const	{ return *order[index]; }
+
+	BackendPost& front ()				{ return *order.front(); }
+	BackendPost& back ()				{ return *order.back(); }
+
+	iterator begin ()					{ return iterator (order.cbegin()); }
+	iterator end ()						{ return iterator (order.cend()); }
+	const_iterator begin () const		{ return const_iterator (order.cbegin()); }
+	const_iterator end () const			{ return const_iterator (order.cend()); }
+
+	/**
+	 * Memory, reserved for posts (used or not), in bytes
+	 */
+	size_t getCapacityBytes () const;
+private:
+	BackendPost* allocate ();
+private:
+	struct Chunk {
+		typename std::aligned_storage<sizeof (BackendPost), alignof (BackendPost)>::type	slots[postsPerChunk];
+		size_t																			used = 0;
+	};
+
+	std::vector<std::unique_ptr<Chunk>>		chunks;
+	std::vector<BackendPost*>				order;
+};
+
+} /* namespace Mattermost */
@@ -27,7 +27,8 @@
 
 namespace Mattermost {
 
-BackendDirectChannelsTeam::BackendDirectChannelsTeam ()
+BackendDirectChannelsTeam::BackendDirectChannelsTeam (const QString& id)
+:id (id)
 {
 }
 
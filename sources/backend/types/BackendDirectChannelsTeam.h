@@ -32,16 +32,18 @@
 
 namespace Mattermost {
 
-class BackendDirectChannelsTeam: public QObject {
-	Q_OBJECT
+/**
+ * Direct or group channels, which do not belong to any team.
+ * Observed through Storage::observers.team, keyed by the fixed 'id'
+ */
+class BackendDirectChannelsTeam {
 public:
-	BackendDirectChannelsTeam ();
+	BackendDirectChannelsTeam (const QString& id);
 	virtual ~BackendDirectChannelsTeam ();
 public:
 	QSet<const BackendUser*> getAllMembers () const;
-signals:
-	void onNewChannel (BackendChannel& channel);
 public:
+	const QString										id;
 	QList<BackendUser*>		 							members;
 	std::list<BackendChannel>							allPublicChannels;
 	std::vector<std::unique_ptr<BackendChannel>>		channels;
@@ -35,6 +35,9 @@ BackendFile::BackendFile (const QJsonObject& jsonObject)
 	size = jsonObject.value ("size").toVariant().toULongLong ();
 	extension = jsonObject.value ("extension").toString();
 	mini_preview = QByteArray::fromBase64 (jsonObject.value ("mini_preview").toString().toUtf8());
+	has_preview_image = jsonObject.value ("has_preview_image").toBool();
+	width = jsonObject.value ("width").toInt();
+	height = jsonObject.value ("height").toInt();
 }
 
 BackendFile::~BackendFile () = default;
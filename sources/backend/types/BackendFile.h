@@ -28,6 +28,18 @@
 
 namespace Mattermost {
 
+/**
+ * Versions of a file, which can be retrieved from the server.
+ * Thumbnails and previews are generated by the server for image files only (see BackendFile::has_preview_image)
+ */
+namespace FileTier {
+enum type {
+	original,		//!< the file itself (files/{file_id})
+	preview,		//!< image, scaled down by the server (files/{file_id}/preview). Used for the inline view of image attachments
+	thumbnail,		//!< small image (files/{file_id}/thumbnail). Used where images are displayed as lists of small icons
+};
+}
+
 class BackendFile {
 public:
 	BackendFile (const QJsonObject& jsonObject);
@@ -39,6 +51,9 @@ public:
 	size_t				size;
 	QString				extension;
 	QByteArray			mini_preview;
+	bool				has_preview_image;
+	int					width;		//!< image width. 0 if not an image, or not known
+	int					height;		//!< image height
 };
 
 } /* namespace Mattermost */
@@ -24,7 +24,9 @@
 
 #include "BackendPost.h"
 
+#include <algorithm>
 #include <QJsonArray>
+#include <QJsonDocument>
 #include "backend/emoji/EmojiInfo.h"
 #include "BackendPoll.h"
 #include "backend/Storage.h"
@@ -32,6 +34,36 @@
 
 namespace Mattermost {
 
+namespace {
+
+/**
+ * Find the reactions with the given emoji, or the position where they should be inserted
+ */
+BackendPostReactions::iterator findReaction (BackendPostReactions& reactions, EmojiID emojiId)
+{
+	return std::lower_bound (reactions.begin(), reactions.end(), emojiId, [] (const QPair<EmojiID, BackendPostReaction>& reaction, EmojiID emojiId) {
+		return reaction.first < emojiId;
+	});
+}
+
+bool isSameEmoji (BackendPostReactions::iterator it, BackendPostReactions& reactions, EmojiID emojiId)
+{
+	return it != reactions.end() && !(emojiId < it->first);
+}
+
+QVector<QString>::iterator findUserId (QVector<QString>& userIds, const QString& userId)
+{
+	return std::lower_bound (userIds.begin(), userIds.end(), userId);
+}
+
+}
+
+bool BackendPostExtra::isEmpty () const
+{
+	return edit_at == 0 && delete_at == 0 && parent_id.isEmpty() && original_id.isEmpty() && type.isEmpty()
+			&& hashtags.isEmpty() && pending_post_id.isEmpty() && props.isEmpty();
+}
+
 BackendPost::BackendPost (const QJsonObject& jsonObject, const Storage& storage)
 :rootPost (nullptr)
 ,isDeleted (false)
@@ -39,37 +71,53 @@ BackendPost::BackendPost (const QJsonObject& jsonObject, const Storage& storage)
 	id = jsonObject.value("id").toString();
 	create_at = jsonObject.value("create_at").toVariant().toULongLong();
 	update_at = jsonObject.value("update_at").toVariant().toULongLong();
-	edit_at = jsonObject.value("edit_at").toVariant().toULongLong();
-	delete_at = jsonObject.value("delete_at").toVariant().toULongLong();
 	is_pinned = jsonObject.value("is_pinned").toBool();
 	user_id = jsonObject.value("user_id").toString();
 	author = storage.getUserById (user_id);
 	channel_id = jsonObject.value("channel_id").toString();
 	root_id = jsonObject.value("root_id").toString();
-	parent_id = jsonObject.value("parent_id").toString();
-	original_id = jsonObject.value("original_id").toString();
 	message = jsonObject.value("message").toString();
-	type = jsonObject.value("type").toString();
-	props = jsonObject.value("props");
-	hashtags = jsonObject.value("hashtags").toString();
-	pending_post_id = jsonObject.value("pending_post_id").toString();
+
+	QJsonObject props = jsonObject.value("props").toObject();
+
+	BackendPostExtra postExtra;
+	postExtra.edit_at = jsonObject.value("edit_at").toVariant().toULongLong();
+	postExtra.delete_at = jsonObject.value("delete_at").toVariant().toULongLong();
+	postExtra.parent_id = jsonObject.value("parent_id").toString();
+	postExtra.original_id = jsonObject.value("original_id").toString();
+	postExtra.type = jsonObject.value("type").toString();
+	postExtra.hashtags = jsonObject.value("hashtags").toString();
+	postExtra.pending_post_id = jsonObject.value("pending_post_id").toString();
+
+	if (!props.isEmpty()) {
+		postExtra.props = QJsonDocument (props).toJson (QJsonDocument::Compact);
+	}
+
+	//most posts are plain text, without any of the extra fields
+	if (!postExtra.isEmpty()) {
+		extra = std::make_unique<BackendPostExtra> (std::move (postExtra));
+	}
 
 	QJsonObject metadata = jsonObject.value("metadata").toObject();
+	QJsonArray filesArray = metadata.value("files").toArray();
 
-	for (const auto &fileElement: metadata.value("files").toArray()) {
-		files.emplace_back (fileElement.toObject());
+	if (!filesArray.isEmpty()) {
+		files.reserve (filesArray.size());
+
+		for (const auto &fileElement: filesArray) {
+			files.append (BackendFile (fileElement.toObject()));
+		}
 	}
 
 	for (const auto &reactionElement: metadata.value("reactions").toArray()) {
-
-		QString userName = storage.getUserDisplayNameByUserId (reactionElement.toObject().value ("user_id").toString(), true);
-		addReaction (userName, reactionElement.toObject().value ("emoji_name").toString());
+		QJsonObject reactionObject = reactionElement.toObject();
+		addReaction (storage, reactionObject.value ("user_id").toString(), reactionObject.value ("emoji_name").toString());
 	}
 
 	/**
 	 * If there are attachments to the post, it is either a poll or a call
 	 */
-	QJsonValue attachments (props.toObject().value("attachments"));
+	QJsonValue attachments (props.value("attachments"));
 	if (attachments.isArray()) {
 		auto pollObject = attachments.toArray()[0].toObject();
 
@@ -80,12 +128,32 @@ BackendPost::BackendPost (const QJsonObject& jsonObject, const Storage& storage)
 			return;
 		}
 
-		poll = std::make_unique<BackendPoll> (props.toObject().value("poll_id").toString(), pollObject);
+		poll = std::make_unique<BackendPoll> (props.value("poll_id").toString(), pollObject);
 	}
 }
 
 BackendPost::~BackendPost () = default;
 
+const BackendPostExtra& BackendPost::getExtra () const
+{
+	static const BackendPostExtra emptyExtra;
+
+	if (!extra) {
+		return emptyExtra;
+	}
+
+	return *extra;
+}
+
+QJsonObject BackendPost::getProps () const
+{
+	if (!extra || extra->props.isEmpty()) {
+		return QJsonObject ();
+	}
+
+	return QJsonDocument::fromJson (extra->props).object();
+}
+
 bool BackendPost::isOwnPost () const
 {
 	if (!author) {
@@ -122,7 +190,7 @@ QString BackendPost::getDisplayAuthorName () const
 	return getAuthorName();
 }
 
-void BackendPost::addReaction (QString userName, QString emojiName)
+void BackendPost::addReaction (const Storage& storage, const QString& userId, const QString& emojiName)
 {
 	EmojiID emojiId = EmojiInfo::findByName(emojiName);
 
@@ -131,27 +199,35 @@ void BackendPost::addReaction (QString userName, QString emojiName)
 		return;
 	}
 
-	auto& vec = reactions[emojiId];
+	auto reaction = findReaction (reactions, emojiId);
+
+	if (!isSameEmoji (reaction, reactions, emojiId)) {
+		reaction = reactions.insert (reaction, qMakePair (emojiId, BackendPostReaction ()));
+	}
+
+	auto& userIds = reaction->second.userIds;
 
 	/**
 	 * If the same reaction from the same user already exists, remove it.
 	 * The official Mattermost client sends 'reaction added' on each reaction add,
 	 * but the reaction is removed if it already exists
 	 */
-	auto it = std::find (vec.begin(), vec.end(), userName);
-	if (it != vec.end()) {
-		vec.erase (it);
+	auto it = findUserId (userIds, userId);
+	if (it != userIds.end() && *it == userId) {
+		userIds.erase (it);
 
 		//if this was the only user used this reaction, remove the reaction
-		if (vec.isEmpty()) {
-			reactions.erase (emojiId);
+		if (userIds.isEmpty()) {
+			reactions.erase (reaction);
 		}
 	} else {
-		vec.push_back (userName);
+		//share the ID string of the user, instead of keeping a copy for each reaction
+		const BackendUser* user = storage.getUserById (userId);
+		userIds.insert (it, user ? user->id : userId);
 	}
 }
 
-void BackendPost::removeReaction (QString userName, QString emojiName)
+void BackendPost::removeReaction (const QString& userId, const QString& emojiName)
 {
 	EmojiID emojiId = EmojiInfo::findByName(emojiName);
 
@@ -160,13 +236,22 @@ void BackendPost::removeReaction (QString userName, QString emojiName)
 		return;
 	}
 
-	auto& vec = reactions[emojiId];
+	auto reaction = findReaction (reactions, emojiId);
 
-	vec.erase(std::remove(vec.begin(), vec.end(), userName), vec.end());
+	if (!isSameEmoji (reaction, reactions, emojiId)) {
+		return;
+	}
+
+	auto& userIds = reaction->second.userIds;
+	auto it = findUserId (userIds, userId);
+
+	if (it != userIds.end() && *it == userId) {
+		userIds.erase (it);
+	}
 
 	//if this was the only user used this reaction, remove the reaction
-	if (vec.isEmpty()) {
-		reactions.erase (emojiId);
+	if (userIds.isEmpty()) {
+		reactions.erase (reaction);
 	}
 }
 
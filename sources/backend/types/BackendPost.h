@@ -27,7 +27,8 @@
 #include <QJsonObject>
 #include <QVariant>
 #include <QDateTime>
-#include <list>
+#include <QPair>
+#include <QVector>
 #include <memory>
 #include "BackendUser.h"
 #include "BackendFile.h"
@@ -38,7 +39,41 @@ namespace Mattermost {
 class BackendPoll;
 class Storage;
 
-using BackendPostReaction = QVector<QString>;
+/**
+ * Users, who reacted to a post with the same emoji.
+ * Only the user IDs are kept (sorted), shared with the BackendUser instances when the users are known.
+ * The display names are resolved when they are shown
+ */
+struct BackendPostReaction {
+	int count () const
+	{
+		return userIds.size();
+	}
+
+	QVector<QString>			userIds;
+};
+
+/**
+ * Reactions of a post, sorted by emoji. Empty for most posts, so a QVector (a single pointer) is used instead of a map
+ */
+using BackendPostReactions = QVector<QPair<EmojiID, BackendPostReaction>>;
+
+/**
+ * Fields of a post, which are empty (or zero) for most posts and are not needed for displaying it.
+ * Allocated only if at least one of them is set
+ */
+struct BackendPostExtra {
+	bool isEmpty () const;
+
+	uint64_t					edit_at = 0;
+	uint64_t					delete_at = 0;
+	QString						parent_id;
+	QString						original_id;
+	QString						type;
+	QString						hashtags;
+	QString						pending_post_id;
+	QByteArray					props;			//compact UTF-8 JSON. Empty if the post has no props
+};
 
 class BackendPost {
 public:
@@ -65,36 +100,36 @@ public:
 	QString getDisplayAuthorName () const;
 	QDateTime getCreationTime () const;
 	void updatePostEdits (BackendPost& editedPost);
-	void addReaction (QString userName, QString emojiName);
-	void removeReaction (QString userName, QString emojiName);
+	void addReaction (const Storage& storage, const QString& userId, const QString& emojiName);
+	void removeReaction (const QString& userId, const QString& emojiName);
+
+	/**
+	 * Returns the rarely used fields. If the post has none of them, an empty instance is returned
+	 */
+	const BackendPostExtra& getExtra () const;
+
+	/**
+	 * Decode the post props. They are kept as compact JSON text, because they are rarely needed
+	 */
+	QJsonObject getProps () const;
 private:
 	QString getAuthorName () const;
 public:
 	QString						id;
 	uint64_t					create_at;
 	uint64_t					update_at;
-	uint64_t					edit_at;
-	uint64_t					delete_at;
-	bool						is_pinned;
 	QString						user_id;
 	QString						channel_id;
-#if 1
 	QString						root_id;
-	QString						parent_id;
-	QString						original_id;
-#endif
 	BackendPost*				rootPost;
 	QString						message;
-	QString						type;
-	QJsonValue					props;
-	QString						hashtags;
-	QString						pending_post_id;
-	std::list<BackendFile>		files;
-	std::map<EmojiID, BackendPostReaction> reactions;
-
+	QVector<BackendFile>		files;
+	BackendPostReactions		reactions;
+	std::unique_ptr<BackendPostExtra> extra;
 
 	std::unique_ptr<BackendPoll> poll;
 	const BackendUser*			author;
+	bool						is_pinned;
 	bool						isDeleted;
 };
 
@@ -34,28 +34,16 @@
 
 namespace Mattermost {
 
-class BackendTeam: public QObject {
-	Q_OBJECT
+/**
+ * Plain value type. Changes are observed through Storage::observers.team, keyed by the team ID
+ */
+class BackendTeam {
 public:
 	BackendTeam (const QJsonObject& jsonObject);
 	virtual ~BackendTeam ();
 public:
 	QSet<const BackendUser*> getAllMembers () const;
 	void addMember (const Storage& storage, const QJsonObject& jsonObject);
-signals:
-	void onLeave ();
-	void onNewChannel (BackendChannel& channel);
-	void onChannelDeleted (BackendChannel& channel);
-
-	/**
-	 * Called when a user has been added to the team
-	 */
-	void onUserAdded (const BackendUser& user);
-
-	/**
-	 * Called when a user (other than the logged-in user) has been removed from the team
-	 */
-	void onUserRemoved (const BackendUser& user);
 public:
 	QString			id;
 	uint64_t		create_at;
@@ -75,6 +63,9 @@ public:
 	QMap<QString, BackendTeamMember> 					members;
 	std::list<BackendChannel>							allPublicChannels;
 	std::vector<std::unique_ptr<BackendChannel>>		channels;
+
+	//requests, whose callbacks refer to the team. Cancelled when the team is destroyed
+	HttpRequestList										requests;
 };
 
 } /* namespace Mattermost */
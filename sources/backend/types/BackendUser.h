@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <QMetaType>
 #include "BackendTimeZone.h"
 #include "BackendNotifyPreps.h"
 #include "BackendUserProps.h"
@@ -42,20 +43,13 @@ struct BackendUserPreferences {
 	QString	value;
 };
 
-class BackendUser: public QObject {
-	Q_OBJECT
+/**
+ * Plain value type. Changes are observed through Storage::observers.user, keyed by the user ID
+ */
+class BackendUser {
 public:
 	BackendUser (const QJsonObject& jsonObject);
 	virtual ~BackendUser ();
-signals:
-
-	/**
-	 * Called when the user's avatar is obtained (after login)
-	 * or when the user changes it's avatar
-	 */
-	void onAvatarChanged ();
-
-	void onStatusChanged ();
 public:
 	QString getDisplayName () const;
 	void updateFrom (const BackendUser& other, QString& resultString);
@@ -78,6 +72,7 @@ public:
 	BackendNotifyPreps 	notify_preps;
 	BackendUserProps	props;
 	uint64_t 			last_password_update;
+	uint64_t 			last_picture_update;
 	QString 			locale;
 	BackendTimeZone		timezone;
 	bool				isLoginUser;
@@ -88,3 +83,5 @@ public:
 };
 
 } /* namespace Mattermost */
+
+Q_DECLARE_METATYPE (Mattermost::BackendUser*)
@@ -32,6 +32,7 @@
 #include "backend/types/BackendTeamMember.h"
 #include "backend/types/BackendChannelMember.h"
 #include "info-dialogs/UserProfileDialog.h"
+#include "image-decoder/ImageDecoder.h"
 #include "ui_FilterListDialog.h"
 
 namespace Mattermost {
@@ -143,7 +144,12 @@ UserListDialog::UserListDialog (const FilterListDialogConfig& cfg, const std::ve
     create (cfg, entrySet, {"Full Name", "Status"});
 }
 
-UserListDialog::~UserListDialog () = default;
+UserListDialog::~UserListDialog ()
+{
+	for (ImageDecodeToken& token: avatarDecodeTokens) {
+		token.cancel ();
+	}
+}
 
 const BackendUser* UserListDialog::getSelectedUser ()
 {
@@ -175,7 +181,17 @@ void UserListDialog::create (const FilterListDialogConfig& cfg, const std::set<U
 
 	for (const UserListEntry& entry: users) {
 
-		QTableWidgetItem* nameItem = new QTableWidgetItem (QIcon(QPixmap::fromImage(QImage::fromData (*entry.userAvatar))), entry.fields[0]);
+		QTableWidgetItem* nameItem = new QTableWidgetItem (entry.fields[0]);
+
+		//the icon is set when the avatar is decoded. The row may be removed until then
+		const BackendUser* user = entry.dataPointer;
+		avatarDecodeTokens.push_back (ImageDecoder::decode (*entry.userAvatar, QSize (64, 64), ImageScaleMode::fitInside, this, [this, user] (const QImage& img) {
+			auto it = dataToItemMap.find (user);
+
+			if (it != dataToItemMap.end()) {
+				it.value()->setIcon (QIcon(QPixmap::fromImage(img)));
+			}
+		}));
 		nameItem->setData (Qt::UserRole, QVariant::fromValue (const_cast<BackendUser*> (entry.dataPointer)));
 
 		ui->tableWidget->setItem (usersCount, 0, nameItem);
@@ -247,5 +263,27 @@ void UserListDialog::removeRowByData (const BackendUser& user)
 	dataToItemMap.erase (it);
 }
 
+void UserListDialog::updateUserStatuses (const QSet<QString>& userIDs)
+{
+	//update all rows, then repaint the table once
+	ui->tableWidget->setUpdatesEnabled (false);
+
+	for (auto it = dataToItemMap.cbegin(); it != dataToItemMap.cend(); ++it) {
+		const BackendUser* user = it.key();
+
+		if (!userIDs.contains (user->id)) {
+			continue;
+		}
+
+		QTableWidgetItem* statusItem = ui->tableWidget->item (it.value()->row(), UserListEntry::userStatus);
+
+		if (statusItem) {
+			statusItem->setText (user->status);
+		}
+	}
+
+	ui->tableWidget->setUpdatesEnabled (true);
+}
+
 } /* namespace Mattermost */
 
@@ -26,8 +26,10 @@
 
 #include <array>
 #include <set>
+#include <vector>
 #include <QVariant>
 #include "FilterListDialog.h"
+#include "image-decoder/ImageDecoder.h"
 
 class QTableWidgetItem;
 
@@ -51,10 +53,18 @@ public:
     void addContextMenuActions (QMenu& menu, const QVariant& selectedItemData)	override;
     void setItemCountLabel (uint32_t count) 								override;
     void removeRowByData (const BackendUser& user);
+
+    /**
+     * Update the status column of the given users
+     */
+    void updateUserStatuses (const QSet<QString>& userIDs);
 protected:
     void create (const FilterListDialogConfig& cfg, const std::set<UserListEntry>& users, const QStringList& columnNames);
 
     QMap<const BackendUser*, QTableWidgetItem*> dataToItemMap;
+
+    //avatars of the listed users, decoded in worker threads
+    std::vector<ImageDecodeToken> avatarDecodeTokens;
 };
 
 using ViewTeamMembersDialog = UserListDialog;
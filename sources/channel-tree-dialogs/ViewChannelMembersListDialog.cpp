@@ -54,11 +54,14 @@ ViewChannelMembersListDialog::ViewChannelMembersListDialog (Backend& backend, co
 
 	create (dialogCfg, entrySet, {"Full Name", "Status", "Channel was last viewed"});
 
-//	connect (&channel, &BackendChannel::onUserAdded, [this] (const BackendUser&) {
+//	backend.getStorage().observers.channel.userAdded.subscribe (channel.id, [this] (const BackendUser&) {
 //
 //	});
 
-	connect (&channel, &BackendChannel::onUserRemoved, this, &UserListDialog::removeRowByData);
+	userRemovedSubscription = backend.getStorage().observers.channel.userRemoved.subscribe (channel.id, [this] (const BackendUser& user) {
+		removeRowByData (user);
+	});
+	connect (&backend, &Backend::onUserStatusesChanged, this, &UserListDialog::updateUserStatuses);
 }
 
 ViewChannelMembersListDialog::~ViewChannelMembersListDialog () = default;
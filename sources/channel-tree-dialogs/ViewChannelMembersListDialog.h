@@ -25,6 +25,7 @@
 #pragma once
 
 #include "UserListDialog.h"
+#include "backend/ObserverRegistry.h"
 
 namespace Mattermost {
 
@@ -39,6 +40,7 @@ private:
 private:
 	const BackendChannel& 	channel;
 	Backend& 				backend;
+	Subscription			userRemovedSubscription;
 };
 
 } /* namespace Mattermost */
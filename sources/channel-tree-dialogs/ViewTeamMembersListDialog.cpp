@@ -53,11 +53,14 @@ ViewTeamMembersListDialog::ViewTeamMembersListDialog (Backend& backend, const Ba
 
 	create (dialogCfg, entrySet, {"Full Name", "Status"});
 
-//	connect (&team, &BackendTeam::onUserAdded, [this] (const BackendUser&) {
+//	backend.getStorage().observers.team.userAdded.subscribe (team.id, [this] (const BackendUser&) {
 //
 //	});
 
-	connect (&team, &BackendTeam::onUserRemoved, this, &UserListDialog::removeRowByData);
+	userRemovedSubscription = backend.getStorage().observers.team.userRemoved.subscribe (team.id, [this] (const BackendUser& user) {
+		removeRowByData (user);
+	});
+	connect (&backend, &Backend::onUserStatusesChanged, this, &UserListDialog::updateUserStatuses);
 }
 
 ViewTeamMembersListDialog::~ViewTeamMembersListDialog () = default;
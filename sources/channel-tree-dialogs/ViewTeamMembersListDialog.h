@@ -25,6 +25,7 @@
 #pragma once
 
 #include "UserListDialog.h"
+#include "backend/ObserverRegistry.h"
 
 namespace Mattermost {
 
@@ -37,6 +38,7 @@ private:
 private:
 	const BackendTeam&		team;
 	Backend& 				backend;
+	Subscription			userRemovedSubscription;
 };
 
 } /* namespace Mattermost */
@@ -92,11 +92,13 @@ void ChannelTree::addTeam (Backend& backend, BackendTeam& team)
 	header()->setSectionResizeMode(0, QHeaderView::Stretch);
 	header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
 
-	connect (&team, &BackendTeam::onNewChannel, [this, teamList] (BackendChannel& channel) {
+	TeamObservers& teamObservers = backend.getStorage().observers.team;
+
+	teamList->subscriptions.push_back (teamObservers.newChannel.subscribe (team.id, [this, teamList] (BackendChannel& channel) {
 		teamList->addChannel (channel, parentWidget(), chatAreaStackedWidget);
-	});
+	}));
 
-	connect (&team, &BackendTeam::onLeave, [this, &team, teamList] {
+	teamList->subscriptions.push_back (teamObservers.leave.subscribe (team.id, [this, &team, teamList] {
 		int index = indexOfTopLevelItem (teamList);
 
 		if (index == -1) {
@@ -107,8 +109,9 @@ void ChannelTree::addTeam (Backend& backend, BackendTeam& team)
 		qDebug() << "delete() team " << team.id;
 		QTreeWidgetItem* item = takeTopLevelItem (index);
 
+		//also removes the subscriptions of the item, including this one
 		delete (item);
-	});
+	}));
 
 	backend.retrieveOwnChannelMembershipsForTeam (team, [this, teamList] (BackendChannel& channel) {
 		teamList->addChannel (channel, parentWidget(), chatAreaStackedWidget);
@@ -132,9 +135,9 @@ void ChannelTree::addGroupChannelsList (Backend& backend)
 	header()->setSectionResizeMode(0, QHeaderView::Stretch);
 	header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
 
-	connect (&team, &BackendDirectChannelsTeam::onNewChannel, [this, teamList] (BackendChannel& channel) {
+	teamList->subscriptions.push_back (backend.getStorage().observers.team.newChannel.subscribe (team.id, [this, teamList] (BackendChannel& channel) {
 		teamList->addChannel (channel, parentWidget(), chatAreaStackedWidget);
-	});
+	}));
 
 	for (auto &channel: team.channels) {
 		teamList->addChannel (*channel, parentWidget(), chatAreaStackedWidget);
@@ -151,9 +154,9 @@ void ChannelTree::addDirectChannelsList (Backend& backend)
 	header()->setSectionResizeMode(0, QHeaderView::Stretch);
 	header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
 
-	connect (&team, &BackendDirectChannelsTeam::onNewChannel, [this, teamList] (BackendChannel& channel) {
+	teamList->subscriptions.push_back (backend.getStorage().observers.team.newChannel.subscribe (team.id, [this, teamList] (BackendChannel& channel) {
 		teamList->addChannel (channel, this, chatAreaStackedWidget);
-	});
+	}));
 
 	for (auto &channel: team.channels) {
 		teamList->addChannel (*channel, this, chatAreaStackedWidget);
@@ -64,7 +64,7 @@ void TeamItem::addChannel (BackendChannel& channel, QWidget *parent, QStackedWid
 
 	treeWidget()->setItemWidget (item, 0, itemWidget);
 
-	connect (&channel, &BackendChannel::onLeave, [this, &channel, item, chatAreaParent, chatArea] {
+	auto onLeave = [this, &channel, item, chatAreaParent, chatArea] {
 		qDebug() << "delete channel " << channel.name;
 		ChannelTree* treeWidget = static_cast<ChannelTree*> (this->treeWidget());
 
@@ -73,7 +73,10 @@ void TeamItem::addChannel (BackendChannel& channel, QWidget *parent, QStackedWid
 		removeChild (item);
 		delete (item);
 		treeWidget->removeChannelToItem (channel.id);
-	});
+		channelLeaveSubscriptions.erase (channel.id);
+	};
+
+	channelLeaveSubscriptions[channel.id] = backend.getStorage().observers.channel.leave.subscribe (channel.id, onLeave);
 
 	ChannelTree* treeWidget = static_cast<ChannelTree*> (this->treeWidget());
 	treeWidget->addChannelToItem (channel.id, item);
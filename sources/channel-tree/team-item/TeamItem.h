@@ -24,8 +24,11 @@
 
 #pragma once
 
-#include "channel-tree/ChannelTreeItem.h"
+#include <map>
+#include <vector>
 #include <QObject>
+#include "channel-tree/ChannelTreeItem.h"
+#include "backend/ObserverRegistry.h"
 
 class QListWidget;
 class QTreeWidgetItem;
@@ -57,6 +60,11 @@ private:
 public:
 	Backend&							backend;
 	QString								teamId;
+
+	//observers of the team (or the direct / group channels), removed with the item
+	std::vector<Subscription>			subscriptions;
+private:
+	std::map<QString, Subscription>		channelLeaveSubscriptions;
 };
 
 } /* namespace Mattermost */
@@ -20,6 +20,7 @@
 #include "ChatArea.h"
 
 #include <QDockWidget>
+#include <QPointer>
 #include "channel-tree/ChannelItem.h"
 #include "ui_ChatArea.h"
 #include "post/PostWidget.h"
@@ -27,6 +28,8 @@
 #include "channel-tree/ChannelItemWidget.h"
 #include "channel-tree-dialogs/ViewChannelMembersListDialog.h"
 #include "PinnedPostsList.h"
+#include "image-decoder/ImageDecoder.h"
+#include "backend/Trace.h"
 #include "log.h"
 
 namespace Mattermost {
@@ -44,10 +47,14 @@ ChatArea::ChatArea (Backend& backend, BackendChannel& channel, ChannelItem* tree
 ,channel (channel)
 ,treeItem (treeItem)
 ,pinnedPostsDockWidget (nullptr)
+,threadDockWidget (nullptr)
+,threadPostsList (nullptr)
 ,unreadMessagesCount (0)
 ,texteditDefaultHeight (70)
 ,gettingOlderPosts (false)
 {
+	TraceSpan span ("ui", "ChatArea", channel.display_name);
+
 	//accept drag&drop attachments
 	setAcceptDrops(true);
 
@@ -63,20 +70,39 @@ ChatArea::ChatArea (Backend& backend, BackendChannel& channel, ChannelItem* tree
 
 	setTextEditWidgetHeight (texteditDefaultHeight);
 
+	connect (&backend, &Backend::onCustomEmojiImagesChanged, this, [this] (const QSet<QString>& emojiNames) {
+		ui->listWidget->updateCustomEmojis (emojiNames);
+
+		if (threadPostsList) {
+			threadPostsList->updateCustomEmojis (emojiNames);
+		}
+	});
+
+	EntityObservers& observers = backend.getStorage().observers;
 	const BackendUser* user = backend.getStorage().getUserById (channel.name);
 
 	if (user) {
 
-		connect (user, &BackendUser::onAvatarChanged, [this, user] {
-			setUserAvatar (*user);
-		});
+		subscriptions.push_back (observers.user.avatarChanged.subscribe (user->id, [this] (const BackendUser& channelUser) {
+			setUserAvatar (channelUser);
+		}));
 
 		if (!user->avatar.isEmpty()) {
 			setUserAvatar (*user);
 		}
 
-		connect (user, &BackendUser::onStatusChanged, [this, user] {
-			ui->statusLabel->setText (user->status);
+		QString userID (user->id);
+
+		connect (&backend, &Backend::onUserStatusesChanged, this, [this, userID] (const QSet<QString>& userIDs) {
+			if (!userIDs.contains (userID)) {
+				return;
+			}
+
+			const BackendUser* channelUser = this->backend.getStorage().getUserById (userID);
+
+			if (channelUser) {
+				ui->statusLabel->setText (channelUser->status);
+			}
 		});
 
 		if (ui->statusLabel->text().isEmpty()) {
@@ -108,22 +134,26 @@ ChatArea::ChatArea (Backend& backend, BackendChannel& channel, ChannelItem* tree
 		});
 	}
 
-	connect (&channel, &BackendChannel::onViewed, [this] {
+	ChannelObservers& channelObservers = observers.channel;
+
+	subscriptions.push_back (channelObservers.viewed.subscribe (channel.id, [this] {
 		LOG_DEBUG ("Channel viewed: " << this->channel.display_name);
 		setUnreadMessagesCount (0);
 		ui->listWidget->removeNewMessagesSeparatorAfterTimeout (1000);
-	});
+	}));
 
-	connect (&channel, &BackendChannel::onUpdated, [this] {
+	subscriptions.push_back (channelObservers.updated.subscribe (channel.id, [this] {
 		ui->titleLabel->setText (this->channel.display_name);
 		this->treeItem->setLabel (this->channel.display_name);
 		ui->statusLabel->setText (this->channel.getChannelDescription ());
-	});
+	}));
 
 
-	connect (&channel, &BackendChannel::onNewPosts, this,  &ChatArea::fillChannelPosts);
+	subscriptions.push_back (channelObservers.newPosts.subscribe (channel.id, [this] (const ChannelNewPosts& newPosts) {
+		fillChannelPosts (newPosts);
+	}));
 
-	connect (&channel, &BackendChannel::onPinnedPostsReceived, [this] () {
+	subscriptions.push_back (channelObservers.pinnedPostsReceived.subscribe (channel.id, [this] () {
 		ui->pinnedPostsButton->show();
 		uint32_t pinnedPostCount = this->channel.pinnedPosts.size();
 		const char* pinnedPostsString[2] = {
@@ -132,50 +162,55 @@ ChatArea::ChatArea (Backend& backend, BackendChannel& channel, ChannelItem* tree
 		};
 
 		ui->pinnedPostsButton->setText (QString::number (pinnedPostCount) + pinnedPostsString[pinnedPostCount > 1]);
-	});
+	}));
 
-	connect (&channel, &BackendChannel::onNewPost, this, &ChatArea::appendChannelPost);
+	subscriptions.push_back (channelObservers.newPost.subscribe (channel.id, [this] (BackendPost& post) {
+		appendChannelPost (post);
 
-	//let the post creator know that the last sent / edited post has appeared so that the input box can be cleared
-	connect (&channel, &BackendChannel::onNewPost, ui->outgoingPostCreator, &OutgoingPostCreator::onPostReceived);
-	connect (&channel, &BackendChannel::onPostEdited, ui->outgoingPostCreator, &OutgoingPostCreator::onPostReceived);
+		//let the post creator know that the last sent / edited post has appeared so that the input box can be cleared
+		ui->outgoingPostCreator->onPostReceived (post);
+	}));
 
-	connect (&channel, &BackendChannel::onUserTyping, this, &ChatArea::handleUserTyping);
+	subscriptions.push_back (channelObservers.userTyping.subscribe (channel.id, [this] (const BackendUser& user) {
+		handleUserTyping (user);
+	}));
+
+	subscriptions.push_back (channelObservers.postEdited.subscribe (channel.id, [this] (BackendPost& post) {
+		ui->outgoingPostCreator->onPostReceived (post);
 
-	connect (&channel, &BackendChannel::onPostEdited, [this] (BackendPost& post) {
 		PostWidget* postWidget = ui->listWidget->findPost (post.id);
 
 		if (postWidget) {
 			postWidget->setEdited (post.message);
 			ui->listWidget->adjustSize();
 		}
-	});
+	}));
 
-	connect (&channel, &BackendChannel::onPostReactionUpdated, [this] (BackendPost& post) {
+	subscriptions.push_back (channelObservers.postReactionUpdated.subscribe (channel.id, [this] (BackendPost& post) {
 		PostWidget* postWidget = ui->listWidget->findPost (post.id);
 
 		if (postWidget) {
 			postWidget->updateReactions ();
 			ui->listWidget->adjustSize();
 		}
-	});
+	}));
 
-	connect (&channel, &BackendChannel::onPostDeleted, [this] (const QString& postId) {
+	subscriptions.push_back (channelObservers.postDeleted.subscribe (channel.id, [this] (const QString& postId) {
 		PostWidget* postWidget = ui->listWidget->findPost (postId);
 
 		if (postWidget) {
 			postWidget->markAsDeleted ();
 			ui->listWidget->adjustSize();
 		}
-	});
+	}));
 
-	connect (&channel, &BackendChannel::onUserAdded, [this] (const BackendUser&) {
+	subscriptions.push_back (channelObservers.userAdded.subscribe (channel.id, [this] (const BackendUser&) {
 		ui->usersButton->setText (QString::number (this->channel.members.size()) + " members");
-	});
+	}));
 
-	connect (&channel, &BackendChannel::onUserRemoved, [this] (const BackendUser&) {
+	subscriptions.push_back (channelObservers.userRemoved.subscribe (channel.id, [this] (const BackendUser&) {
 		ui->usersButton->setText (QString::number (this->channel.members.size()) + " members");
-	});
+	}));
 
 	//initiate editing of post, when edit is selected from the context menu
 	connect (ui->listWidget, &PostsListWidget::postEditInitiated, ui->outgoingPostCreator, &OutgoingPostCreator::postEditInitiated);
@@ -205,6 +240,8 @@ ChatArea::ChatArea (Backend& backend, BackendChannel& channel, ChannelItem* tree
 		}
 	});
 
+	connect (ui->listWidget, &PostsListWidget::threadViewRequested, this, &ChatArea::showThread);
+
 	connect (ui->usersButton, &QPushButton::clicked, [this] {
 		ViewChannelMembersListDialog* dialog = new ViewChannelMembersListDialog (this->backend, this->channel, this);
 		dialog->show ();
@@ -248,17 +285,26 @@ ChatArea::ChatArea (Backend& backend, BackendChannel& channel, ChannelItem* tree
 
 ChatArea::~ChatArea()
 {
+	//no notifications after the ui is gone
+	subscriptions.clear ();
+	threadSubscriptions.clear ();
+	avatarDecodeToken.cancel ();
     delete ui;
 }
 
 void ChatArea::setUserAvatar (const BackendUser& user)
 {
-	QImage img = QImage::fromData (user.avatar).scaled (64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-	ui->userAvatar->setPixmap (QPixmap::fromImage(img));
-
-	if (channel.type == BackendChannel::directChannel) {
-		treeItem->setIcon (QIcon(QPixmap::fromImage(QImage::fromData(user.avatar))));
-	}
+	//a newer avatar replaces the one being decoded
+	avatarDecodeToken.cancel ();
+	avatarDecodeToken = ImageDecoder::decode (user.avatar, QSize (64, 64), ImageScaleMode::exact, this, [this] (const QImage& img) {
+		QPixmap pixmap (QPixmap::fromImage(img));
+		ui->userAvatar->setPixmap (pixmap);
+
+		//the tree item icon is much smaller than 64x64, no need to decode the full avatar for it
+		if (channel.type == BackendChannel::directChannel) {
+			treeItem->setIcon (QIcon(pixmap));
+		}
+	});
 }
 
 Ui::ChatArea* ChatArea::getUi ()
@@ -278,6 +324,8 @@ BackendChannel& ChatArea::getChannel ()
 
 void ChatArea::fillChannelPosts (const ChannelNewPosts& newPosts)
 {
+	TraceSpan span ("ui", "fillChannelPosts", channel.display_name);
+
 	QDate currentDate = QDateTime::currentDateTime().date();
 	int insertPos = 0;
 	int startPos = 0;
@@ -423,6 +471,8 @@ void ChatArea::onDeactivate ()
 		delete pinnedPostsDockWidget;
 		pinnedPostsDockWidget = nullptr;
 	}
+
+	closeThread ();
 }
 
 void ChatArea::onMainWindowActivate ()
@@ -433,6 +483,10 @@ void ChatArea::onMainWindowActivate ()
 
 void ChatArea::onMove (QPoint)
 {
+	if (threadDockWidget) {
+		threadDockWidget->move (mapToGlobal (QPoint (width() - threadDockWidget->width(), ui->listWidget->y())));
+	}
+
 	if (!pinnedPostsDockWidget) {
 		return;
 	}
@@ -440,6 +494,86 @@ void ChatArea::onMove (QPoint)
 	pinnedPostsDockWidget->move (mapToGlobal(ui->pinnedPostsButton->pos()) + QPoint (0,40));
 }
 
+void ChatArea::showThread (const QString& rootId)
+{
+	closeThread ();
+
+	BackendPost* rootPost = channel.getThreadRoot (rootId);
+
+	//the root post is older than the loaded posts. Get the whole thread and show it when received
+	if (!rootPost) {
+		QPointer<ChatArea> self (this);
+
+		backend.retrievePostThread (channel, rootId, [self, rootId] {
+			if (self && self->channel.getThreadRoot (rootId)) {
+				self->showThread (rootId);
+			}
+		});
+		return;
+	}
+
+	threadDockWidget = new QDockWidget (this);
+	threadDockWidget->setFloating (true);
+	threadDockWidget->setFeatures (QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable);
+	threadDockWidget->setWindowTitle ("Thread");
+
+	//a posts list, so the attached images are loaded only when scrolled near the visible area
+	threadPostsList = new PostsListWidget (threadDockWidget);
+	threadPostsList->backend = &backend;
+	threadPostsList->setContextMenuPolicy (Qt::CustomContextMenu);
+	threadPostsList->setVerticalScrollMode (QAbstractItemView::ScrollPerPixel);
+	threadDockWidget->setWidget (threadPostsList);
+
+	//the replies are indexed by the channel, no need to search the posts list
+	threadPostsList->insertPost (new PostWidget (backend, *rootPost, threadPostsList, this, nullptr));
+
+	for (BackendPost* reply: channel.getThreadReplies (rootId)) {
+		threadPostsList->insertPost (new PostWidget (backend, *reply, threadPostsList, this, rootPost));
+	}
+
+	ChannelObservers& channelObservers = backend.getStorage().observers.channel;
+
+	//keep the open thread up to date
+	threadSubscriptions.push_back (channelObservers.newPost.subscribe (channel.id, [this, rootPost] (BackendPost& post) {
+		if (post.root_id == rootPost->id) {
+			threadPostsList->insertPost (new PostWidget (backend, post, threadPostsList, this, rootPost));
+		}
+	}));
+
+	threadSubscriptions.push_back (channelObservers.postEdited.subscribe (channel.id, [this] (BackendPost& post) {
+		PostWidget* postWidget = threadPostsList->findPost (post.id);
+
+		if (postWidget) {
+			postWidget->setEdited (post.message);
+			threadPostsList->adjustSize();
+		}
+	}));
+
+	threadSubscriptions.push_back (channelObservers.postDeleted.subscribe (channel.id, [this] (const QString& postId) {
+		PostWidget* postWidget = threadPostsList->findPost (postId);
+
+		if (postWidget) {
+			postWidget->markAsDeleted ();
+		}
+	}));
+
+	threadDockWidget->setFixedWidth (width() / 2);
+	threadDockWidget->setFixedHeight (ui->listWidget->height());
+	threadDockWidget->move (mapToGlobal (QPoint (width() - threadDockWidget->width(), ui->listWidget->y())));
+	threadDockWidget->show ();
+}
+
+void ChatArea::closeThread ()
+{
+	threadSubscriptions.clear ();
+
+	if (threadDockWidget) {
+		delete threadDockWidget;
+		threadDockWidget = nullptr;
+		threadPostsList = nullptr;
+	}
+}
+
 void ChatArea::moveOnListTop ()
 {
 	QTreeWidgetItem* parent = treeItem->parent();
@@ -24,6 +24,8 @@
 #include <QTreeWidgetItem>
 
 #include "outgoing-post/OutgoingPostCreator.h"
+#include "backend/ObserverRegistry.h"
+#include "image-decoder/ImageDecoder.h"
 
 namespace Ui {
 class ChatArea;
@@ -43,6 +45,7 @@ class BackendUser;
 class ChannelItem;
 class ChannelNewPosts;
 class OutgoingAttachmentList;
+class PostsListWidget;
 
 class ChatArea: public QWidget {
 	Q_OBJECT
@@ -81,6 +84,13 @@ public:
 	void onMainWindowActivate ();
 
 	void onMove (QPoint pos);
+
+	/**
+	 * Show a thread (root post and its replies) in a side panel.
+	 * If the root post is not loaded, the thread is retrieved first
+	 * @param rootId ID of the thread's root post
+	 */
+	void showThread (const QString& rootId);
 private:
 	void resizeEvent (QResizeEvent* event)		override;
 	void dragEnterEvent (QDragEnterEvent* event) override;
@@ -91,6 +101,7 @@ private:
 	void moveOnListTop ();
 	void setUnreadMessagesCount (uint32_t count);
 	void setTextEditWidgetHeight (int height);
+	void closeThread ();
 public:
 	Ui::ChatArea 					*ui;
 	Backend& 						backend;
@@ -98,11 +109,18 @@ public:
 	ChannelItem* 					treeItem;
 	QString 						lastReadPostId;
 	QDockWidget*					pinnedPostsDockWidget;
+	QDockWidget*					threadDockWidget;
+	PostsListWidget*				threadPostsList;
 
 	uint32_t						unreadMessagesCount;
 	int 							texteditDefaultHeight;
 	QDate							lastPostDate;
 	bool							gettingOlderPosts;
+	std::vector<Subscription>		subscriptions;
+
+	//updates of the thread, shown in threadDockWidget
+	std::vector<Subscription>		threadSubscriptions;
+	ImageDecodeToken				avatarDecodeToken;
 };
 
 } /* namespace Mattermost */
@@ -47,6 +47,9 @@ void PinnedPostsList::addPost (PostWidget* postWidget)
 	QListWidgetItem* newItem = new QListWidgetItem();
 	ui->listWidget->addItem (newItem);
 	ui->listWidget->setItemWidget (newItem, postWidget);
+
+	//the pinned posts list is small. Load all attached images immediately
+	postWidget->setNearViewport (true);
 }
 
 } /* namespace Mattermost */
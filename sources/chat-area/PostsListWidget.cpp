@@ -25,16 +25,19 @@
 #include <QScrollBar>
 #include <QDebug>
 #include <set>
+#include <QSet>
 #include <QMenu>
 #include <QApplication>
 #include <QClipboard>
 #include <QResizeEvent>
+#include <QSettings>
 #include "post-separator/PostDaySeparatorWidget.h"
 #include "backend/Backend.h"
 #include "backend/types/BackendPost.h"
 #include "info-dialogs/UserProfileDialog.h"
 #include "PostsListWidget.h"
 #include "choose-emoji-dialog/ChooseEmojiDialogWrapper.h"
+#include "Settings.h"
 
 namespace Mattermost {
 
@@ -55,7 +58,21 @@ PostsListWidget::PostsListWidget (QWidget* parent)
 		if (value == 0) {
 			emit scrolledToTop ();
 		}
+
+		scheduleViewportCheck ();
 	});
+
+	connect (verticalScrollBar(), &QAbstractSlider::rangeChanged, this, &PostsListWidget::scheduleViewportCheck);
+
+	QSettings settings;
+	imagePreloadDistance = settings.value (IMAGE_PRELOAD_DISTANCE, 1000).toInt();
+
+	/*
+	 * Scrolling produces many events. Check the posts near the visible area
+	 * only when the scrolling settles down a bit
+	 */
+	viewportCheckTimer.setSingleShot (true);
+	connect (&viewportCheckTimer, &QTimer::timeout, this, &PostsListWidget::updatePostsNearViewport);
 }
 
 PostsListWidget::~PostsListWidget () = default;
@@ -80,6 +97,8 @@ void PostsListWidget::insertPost (int position, PostWidget* postWidget)
 		newItem->setSizeHint (postWidget->sizeHint());
 		scrollToItem(firstPost, QAbstractItemView::PositionAtTop);
 	});
+
+	scheduleViewportCheck ();
 }
 
 void PostsListWidget::insertPost (PostWidget* postWidget)
@@ -130,6 +149,24 @@ PostWidget* PostsListWidget::findPost (const QString& postId)
 	return nullptr;
 }
 
+void PostsListWidget::updateCustomEmojis (const QSet<QString>& emojiNames)
+{
+	bool updated = false;
+
+	for (int i = 0; i < count(); ++i) {
+		PostWidget* postWidget = qobject_cast<PostWidget*> (itemWidget (item (i)));
+
+		if (postWidget && postWidget->updateCustomEmojis (emojiNames)) {
+			updated = true;
+		}
+	}
+
+	//the images may have a different size than the emoji names, which were shown until now
+	if (updated) {
+		adjustSize ();
+	}
+}
+
 void PostsListWidget::scrollToUnreadPostsOrBottom ()
 {
 	if (newMessagesSeparator) {
@@ -351,6 +388,16 @@ void PostsListWidget::showContextMenu (const QPoint& pos)
 		dialog->show ();
 	});
 
+	BackendChannel* postChannel = backend->getStorage().getChannelById (post->post.channel_id);
+
+	if (postChannel && selectedItemsCount == 1 && (!post->post.root_id.isEmpty() || !postChannel->getThreadReplies (post->post.id).isEmpty())) {
+		QString rootId = post->post.root_id.isEmpty() ? post->post.id : post->post.root_id;
+
+		myMenu.addAction ("View thread", [this, rootId] {
+			emit threadViewRequested (rootId);
+		});
+	}
+
 #if 0
 	if (selectedItemsCount == 1) {
 		myMenu.addAction ("Reply", [post] {
@@ -376,6 +423,89 @@ void PostsListWidget::resizeToBottom ()
 	}
 }
 
+void PostsListWidget::scheduleViewportCheck ()
+{
+	if (!viewportCheckTimer.isActive()) {
+		viewportCheckTimer.start (50);
+	}
+}
+
+void PostsListWidget::updatePostsNearViewport ()
+{
+	QList<QPointer<PostWidget>> newPostsNearViewport;
+
+	/*
+	 * Hidden lists (chat areas of channels, which are not currently shown) request nothing.
+	 * They are checked again when shown
+	 */
+	QListWidgetItem* firstVisibleItem = isVisible() ? itemAt (QPoint (0, 0)) : nullptr;
+
+	if (firstVisibleItem) {
+		int top = -imagePreloadDistance;
+		int bottom = viewport()->height() + imagePreloadDistance;
+		int firstVisibleRow = row (firstVisibleItem);
+
+		auto addPostNearViewport = [this, &newPostsNearViewport] (QListWidgetItem* item) {
+			PostWidget* postWidget = qobject_cast<PostWidget*> (itemWidget (item));
+
+			if (postWidget) {
+				postWidget->setNearViewport (true);
+				newPostsNearViewport.push_back (postWidget);
+			}
+		};
+
+		//walk from the first visible item up, until the preload distance is exceeded
+		for (int i = firstVisibleRow; i >= 0; --i) {
+			QListWidgetItem* currentItem = item (i);
+
+			if (visualItemRect (currentItem).bottom() < top) {
+				break;
+			}
+
+			addPostNearViewport (currentItem);
+		}
+
+		//and down
+		for (int i = firstVisibleRow + 1; i < count(); ++i) {
+			QListWidgetItem* currentItem = item (i);
+
+			if (visualItemRect (currentItem).top() > bottom) {
+				break;
+			}
+
+			addPostNearViewport (currentItem);
+		}
+	}
+
+	//cancel the pending requests of posts that went away from the visible area
+	QSet<PostWidget*> stillNearViewport;
+	stillNearViewport.reserve (newPostsNearViewport.size());
+
+	for (auto& postWidget: newPostsNearViewport) {
+		stillNearViewport.insert (postWidget);
+	}
+
+	for (auto& postWidget: postsNearViewport) {
+		if (postWidget && !stillNearViewport.contains (postWidget)) {
+			postWidget->setNearViewport (false);
+		}
+	}
+
+	postsNearViewport = std::move (newPostsNearViewport);
+}
+
+void PostsListWidget::showEvent (QShowEvent* event)
+{
+	ResizableListWidget::showEvent (event);
+	scheduleViewportCheck ();
+}
+
+void PostsListWidget::resizeEvent (QResizeEvent* event)
+{
+	ResizableListWidget::resizeEvent (event);
+	scheduleViewportCheck ();
+}
+
 void PostsListWidget::focusOutEvent (QFocusEvent* event)
 {
 	//qDebug() << "FocusOutEvent";
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <QTimer>
+#include <QPointer>
 #include "ResizableListWidget.h"
 #include "post/PostWidget.h"
 
@@ -60,15 +61,29 @@ public:
 	void initiatePostEdit (QListWidgetItem& postItem);
 	void postEditFinished ();
 
+	/**
+	 * Render the posts, which contain any of the custom emojis, again
+	 * @param emojiNames names of the custom emojis, whose images were received
+	 */
+	void updateCustomEmojis (const QSet<QString>& emojiNames);
+
 	/**
 	 * If the widget is near the bottom when being resized,
 	 * keep it at the bottom
 	 */
 	void resizeToBottom ();
+
+	/**
+	 * Schedule a check which posts are near the visible area.
+	 * Posts that are near it get their attached images downloaded,
+	 * posts that went away have their pending image downloads cancelled
+	 */
+	void scheduleViewportCheck ();
 	Backend*						backend;
 signals:
 	void postEditInitiated (BackendPost& post);
 	void scrolledToTop ();
+	void threadViewRequested (const QString& rootId);
 private:
 	QList<QListWidgetItem*> sortedSelectedItems () const;
 
@@ -76,8 +91,14 @@ private:
 	void keyPressEvent (QKeyEvent* event)		override;
 	void focusOutEvent (QFocusEvent* event)		override;
 	void showContextMenu (const QPoint &pos);
+	void showEvent (QShowEvent* event)			override;
+	void resizeEvent (QResizeEvent* event)		override;
+	void updatePostsNearViewport ();
 private:
 	QTimer							removeNewMessagesSeparatorTimer;
+	QTimer							viewportCheckTimer;
+	QList<QPointer<PostWidget>>		postsNearViewport;
+	int								imagePreloadDistance;
 	QListWidgetItem*				newMessagesSeparator;
 	QListWidgetItem*				lastOwnPost;
 	QListWidgetItem*				currentEditedItem;
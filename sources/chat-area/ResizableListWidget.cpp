@@ -26,6 +26,7 @@
 #include <QResizeEvent>
 #include <QScrollBar>
 #include <QDebug>
+#include "backend/Trace.h"
 
 /**
  * Overriding resizeEvent is needed, so that
@@ -38,6 +39,8 @@
  */
 void ResizableListWidget::resizeEvent (QResizeEvent* event)
 {
+	TraceSpan span ("ui", "ResizableListWidget::resizeEvent");
+
 	for (int i = 0; i < count(); ++i) {
 		QListWidgetItem* item = this->item(i);
 		QWidget* widget = (QWidget*)itemWidget (item);
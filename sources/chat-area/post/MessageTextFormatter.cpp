@@ -0,0 +1,124 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "MessageTextFormatter.h"
+
+#include "backend/emoji/EmojiInfo.h"
+
+namespace Mattermost {
+
+static void replaceEmojis (QString& str)
+{
+	int emojiStart = 0;
+	int emojiEnd = 0;
+
+	do {
+
+		//find a substring enclosed in ':' - for example - :wave:
+		emojiStart = str.indexOf (':', emojiEnd);
+		if (emojiStart == -1) {
+			break;
+		}
+
+		emojiEnd = str.indexOf (':', emojiStart + 1);
+		if (emojiEnd == -1) {
+			break;
+		}
+
+		if (emojiEnd - emojiStart == 1) {
+			++emojiEnd;
+			continue;
+		}
+
+		int emojiNameSize = emojiEnd - emojiStart - 1;
+
+		//get the substring enclosed in ':' (without the ':'). This is the emoji name
+		QString emojiName = str.mid (emojiStart + 1, emojiNameSize);
+
+		EmojiID emojiID = EmojiInfo::findByName (emojiName);
+
+		if (!emojiID) {
+			continue;
+		}
+
+		Emoji emoji = EmojiInfo::getEmoji (emojiID);
+
+		//replace the emoji name (together with ':') with it's corresponding value
+		str.replace (emojiStart, emojiNameSize + 2, emoji.unicodeString);
+
+		emojiEnd -= emojiName.size() + 2 - emoji.unicodeString.size();
+		++emojiEnd;
+
+	} while (emojiStart != -1);
+
+}
+
+QString MessageTextFormatter::format (const QString& str)
+{
+	QString ret (str.toHtmlEscaped ());
+	ret.replace("\n", "<br>");
+
+	int linkStart = 0;
+	int linkEnd = 0;
+
+	replaceEmojis (ret);
+
+	do {
+
+		QLatin1String lookups[2] = { QLatin1String ("http://"), QLatin1String ("https://") };
+		QLatin1String* useLookup = nullptr;
+
+		for (auto& lookup: lookups) {
+			linkStart = ret.indexOf (lookup, linkEnd);
+
+			if (linkStart != -1) {
+				useLookup = &lookup;
+				break;
+			}
+		}
+
+		if (!useLookup) {
+			break;
+		}
+
+		//poor man's find_first_of - there is no such thing in QT, and std::string is not aware of multibyte characters
+		for (linkEnd = linkStart + useLookup->size(); linkEnd < ret.size(); ++linkEnd) {
+			if (ret.at (linkEnd) == ' ' || ret.at (linkEnd) == '<') {
+				break;
+			}
+		}
+
+		if (linkEnd == -1) {
+			linkEnd = ret.size();
+		}
+
+		size_t size = linkEnd - linkStart;
+
+		ret.insert (linkEnd, "\">" + QStringRef (&ret, linkStart,  size) + "</a>");
+		ret.insert (linkStart, "<a href=\"");
+
+		linkEnd += size + 15;
+	} while (linkStart != -1);
+
+	//std::cout << str.toStdString() << std::endl;
+	//std::cout << ret.toStdString() << std::endl;
+	return ret;
+}
+
+} /* namespace Mattermost */
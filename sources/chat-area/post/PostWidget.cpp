@@ -28,16 +28,19 @@
 #include "backend/emoji/EmojiInfo.h"
 #include "chat-area/ChatArea.h"
 #include "PostQuoteFrame.h"
+#include "MessageTextFormatter.h"
 #include "attachments/PostAttachmentList.h"
 #include "attachments/PostPoll.h"
 #include "reactions/PostReactionList.h"
 #include "ui_PostWidget.h"
+#include "image-decoder/ImageDecoder.h"
 
 namespace Mattermost {
 
 PostWidget::PostWidget (Backend& backend, BackendPost &post, QWidget *parent, ChatArea* chatArea, BackendPost* lastRootPost)
 :QWidget(parent)
 ,post (post)
+,backend (backend)
 ,ui(new Ui::PostWidget)
 {
 	ui->setupUi(this);
@@ -55,8 +58,9 @@ PostWidget::PostWidget (Backend& backend, BackendPost &post, QWidget *parent, Ch
 		//qDebug() << "Avatar for " << ui->authorName->text() << " is missing";
 	} else {
 		//load the author's avatar, with same size as the ui label
-		QImage img = QImage::fromData (post.author->avatar).scaled (ui->authorAvatar->geometry().size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-		ui->authorAvatar->setPixmap (QPixmap::fromImage(img));
+		avatarDecodeToken = ImageDecoder::decode (post.author->avatar, ui->authorAvatar->geometry().size(), ImageScaleMode::exact, this, [this] (const QImage& img) {
+			ui->authorAvatar->setPixmap (QPixmap::fromImage(img));
+		});
 	}
 
 	/**
@@ -86,7 +90,7 @@ PostWidget::PostWidget (Backend& backend, BackendPost &post, QWidget *parent, Ch
 
 	//Add reactions, if any
 	if (!post.reactions.empty()) {
-		reactions = std::make_unique<PostReactionList> (this);
+		reactions = std::make_unique<PostReactionList> (backend.getStorage(), this);
 
 		for (auto& it: post.reactions) {
 			EmojiID emojiID = it.first;
@@ -112,6 +116,7 @@ PostWidget::PostWidget (Backend& backend, BackendPost &post, QWidget *parent, Ch
 
 PostWidget::~PostWidget()
 {
+	avatarDecodeToken.cancel ();
     delete ui;
 }
 
@@ -139,7 +144,7 @@ void PostWidget::updateReactions ()
 
 	//Add reactions, if any
 	if (!post.reactions.empty()) {
-		reactions = std::make_unique<PostReactionList> (this);
+		reactions = std::make_unique<PostReactionList> (backend.getStorage(), this);
 
 		for (auto& it: post.reactions) {
 			EmojiID emojiID = it.first;
@@ -151,6 +156,32 @@ void PostWidget::updateReactions ()
 	}
 }
 
+bool PostWidget::updateCustomEmojis (const QSet<QString>& emojiNames)
+{
+	bool updated = false;
+
+	//deleted posts and polls have no message text with emojis
+	if (!post.isDeleted && !post.poll) {
+		for (const QString& emojiName: emojiNames) {
+			if (post.message.contains (':' + emojiName + ':')) {
+				ui->message->setText (formatMessageText (post.message));
+				updated = true;
+				break;
+			}
+		}
+	}
+
+	for (auto& it: post.reactions) {
+		if (it.first.seq >= CUSTOM_EMOJI_START_INDEX && emojiNames.contains (EmojiInfo::getEmoji (it.first).name)) {
+			updateReactions ();
+			updated = true;
+			break;
+		}
+	}
+
+	return updated;
+}
+
 void PostWidget::markAsDeleted ()
 {
 	attachments.reset (nullptr);
@@ -166,108 +197,21 @@ void PostWidget::markAsDeleted ()
 	}
 }
 
-
-QString PostWidget::getSelectedText ()
+void PostWidget::setNearViewport (bool nearViewport)
 {
-	return ui->message->selectedText();
+	if (attachments) {
+		attachments->setNearViewport (nearViewport);
+	}
 }
 
-static void replaceEmojis (QString& str)
+QString PostWidget::getSelectedText ()
 {
-	int emojiStart = 0;
-	int emojiEnd = 0;
-
-	do {
-
-		//find a substring enclosed in ':' - for example - :wave:
-		emojiStart = str.indexOf (':', emojiEnd);
-		if (emojiStart == -1) {
-			break;
-		}
-
-		emojiEnd = str.indexOf (':', emojiStart + 1);
-		if (emojiEnd == -1) {
-			break;
-		}
-
-		if (emojiEnd - emojiStart == 1) {
-			++emojiEnd;
-			continue;
-		}
-
-		int emojiNameSize = emojiEnd - emojiStart - 1;
-
-		//get the substring enclosed in ':' (without the ':'). This is the emoji name
-		QString emojiName = str.mid (emojiStart + 1, emojiNameSize);
-
-		EmojiID emojiID = EmojiInfo::findByName (emojiName);
-
-		if (!emojiID) {
-			continue;
-		}
-
-		Emoji emoji = EmojiInfo::getEmoji (emojiID);
-
-		//replace the emoji name (together with ':') with it's corresponding value
-		str.replace (emojiStart, emojiNameSize + 2, emoji.unicodeString);
-
-		emojiEnd -= emojiName.size() + 2 - emoji.unicodeString.size();
-		++emojiEnd;
-
-	} while (emojiStart != -1);
-
+	return ui->message->selectedText();
 }
 
 QString PostWidget::formatMessageText (const QString& str)
 {
-	QString ret (str.toHtmlEscaped ());
-	ret.replace("\n", "<br>");
-
-	int linkStart = 0;
-	int linkEnd = 0;
-
-	replaceEmojis (ret);
-
-	do {
-
-		QLatin1String lookups[2] = { QLatin1String ("http://"), QLatin1String ("https://") };
-		QLatin1String* useLookup = nullptr;
-
-		for (auto& lookup: lookups) {
-			linkStart = ret.indexOf (lookup, linkEnd);
-
-			if (linkStart != -1) {
-				useLookup = &lookup;
-				break;
-			}
-		}
-
-		if (!useLookup) {
-			break;
-		}
-
-		//poor man's find_first_of - there is no such thing in QT, and std::string is not aware of multibyte characters
-		for (linkEnd = linkStart + useLookup->size(); linkEnd < ret.size(); ++linkEnd) {
-			if (ret.at (linkEnd) == ' ' || ret.at (linkEnd) == '<') {
-				break;
-			}
-		}
-
-		if (linkEnd == -1) {
-			linkEnd = ret.size();
-		}
-
-		size_t size = linkEnd - linkStart;
-
-		ret.insert (linkEnd, "\">" + QStringRef (&ret, linkStart,  size) + "</a>");
-		ret.insert (linkStart, "<a href=\"");
-
-		linkEnd += size + 15;
-	} while (linkStart != -1);
-
-	//std::cout << str.toStdString() << std::endl;
-	//std::cout << ret.toStdString() << std::endl;
-	return ret;
+	return MessageTextFormatter::format (str);
 }
 
 QString PostWidget::getMessageTimeString (uint64_t timestamp)
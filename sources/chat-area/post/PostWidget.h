@@ -19,8 +19,10 @@
 
 #pragma once
 
+#include <QSet>
 #include <QWidget>
 #include <memory>
+#include "image-decoder/ImageDecoder.h"
 
 namespace Ui {
 class PostWidget;
@@ -53,8 +55,22 @@ public:
     void setEdited (const QString& message);
     void updateReactions ();
 
+    /**
+     * Render the message and the reactions again, if they contain any of the custom emojis
+     * @param emojiNames names of the custom emojis, whose images were received
+     * @return true if the post was rendered again
+     */
+    bool updateCustomEmojis (const QSet<QString>& emojiNames);
+
     void markAsDeleted ();
 
+    /**
+     * Called by the posts list when the post gets near the visible area, or away from it.
+     * Attached images are downloaded only while the post is near the visible area
+     * @param nearViewport whether the post is within the preload distance of the visible area
+     */
+    void setNearViewport (bool nearViewport);
+
     QString getSelectedText ();
 
     QString getMessageTimeString (uint64_t timestamp);
@@ -68,11 +84,13 @@ public:
 signals:
 	void dimensionsChanged ();
 private:
+    Backend&							backend;
     Ui::PostWidget*						ui;
     std::unique_ptr<PostQuoteFrame>		quoteFrame;
     std::unique_ptr<PostAttachmentList>	attachments;
     std::unique_ptr<PostPoll>			poll;
     std::unique_ptr<PostReactionList>	reactions;
+    ImageDecodeToken					avatarDecodeToken;
 };
 
 } /* namespace Mattermost */
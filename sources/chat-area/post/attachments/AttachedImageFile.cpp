@@ -27,47 +27,65 @@
 #include "backend/types/BackendFile.h"
 #include "backend/Backend.h"
 #include "Settings.h"
+#include "image-decoder/ImageDecoder.h"
 
 namespace Mattermost {
 
 std::map <const QWidget*, FilePreview*> AttachedImageFile::currentlyOpenFiles;
 
-AttachedImageFile::AttachedImageFile (Backend& backend, const BackendFile& file, const QString& authorName, QWidget *parent)
-:QWidget(parent)
-,ui(new Ui::AttachedImageFile)
+/**
+ * Get the version of the file, used for the inline view of the image.
+ * The smallest version, which is not smaller than the displayed image is used.
+ * The original file is requested only if the server can not provide a scaled-down version
+ */
+static FileTier::type getInlineViewTier (const BackendFile& file)
 {
-    ui->setupUi(this);
-
-    QImage img = QImage::fromData (file.mini_preview);
-    ui->imageName->setText (file.name);
-    ui->imagePreview->setPixmap (QPixmap::fromImage(img));
+	if (!file.has_preview_image) {
+		return FileTier::original;
+	}
 
-    backend.retrieveFile (file.id, [&file, authorName, this] (const QByteArray& fileContents){
+	//the image size is not known, so neither is the displayed size
+	if (file.width <= 0 || file.height <= 0) {
+		return FileTier::preview;
+	}
 
-		QSettings settings;
+	QSettings settings;
 
-		int maxWidth = settings.value(DOWNLOAD_IMAGE_MAX_WIDTH, 500).toInt();
-		int maxHeight = settings.value(DOWNLOAD_IMAGE_MAX_HEIGHT, 500).toInt();
+	QSize maxSize (settings.value(DOWNLOAD_IMAGE_MAX_WIDTH, 500).toInt(), settings.value(DOWNLOAD_IMAGE_MAX_HEIGHT, 500).toInt());
+	QSize displayedSize (file.width, file.height);
 
-		QImage img = QImage::fromData (fileContents);
-		if (img.width() > maxWidth) {
-			img = img.scaledToWidth (maxWidth, Qt::SmoothTransformation);
-		}
-
-		if (img.height() > maxHeight) {
-			img = img.scaledToHeight (maxHeight, Qt::SmoothTransformation);
-		}
+	//the image is scaled down to fit in the maximum size, but is not enlarged (same as ImageScaleMode::fitInside)
+	if (displayedSize.width() > maxSize.width() || displayedSize.height() > maxSize.height()) {
+		displayedSize.scale (maxSize, Qt::KeepAspectRatio);
+	}
 
-		ui->imagePreview->setPixmap (QPixmap::fromImage(img));
-		ui->imagePreview->adjustSize();
+	//thumbnails generated by the Mattermost server are at most 120x100
+	if (displayedSize.width() <= 120 && displayedSize.height() <= 100) {
+		return FileTier::thumbnail;
+	}
 
-		adjustSize();
+	return FileTier::preview;
+}
 
-		filePreviewData = FilePreviewData {fileContents, file.name, authorName};
+AttachedImageFile::AttachedImageFile (Backend& backend, const BackendFile& file, const QString& authorName, QWidget *parent)
+:QWidget(parent)
+,ui(new Ui::AttachedImageFile)
+,backend (backend)
+,file (file)
+,authorName (authorName)
+,imageRequested (false)
+,imageDecoding (false)
+,openPreviewOnLoad (false)
+{
+    ui->setupUi(this);
 
-		emit dimensionsChanged ();
-		//parentWidget()->adjustSize();
-	});
+    /*
+     * Show the mini preview until the real image is requested and received.
+     * The real image is requested by the posts list, when the post gets near the visible area
+     */
+    QImage img = QImage::fromData (file.mini_preview);
+    ui->imageName->setText (file.name);
+    ui->imagePreview->setPixmap (QPixmap::fromImage(img));
 
 	connect (this, &QWidget::customContextMenuRequested, [this, &backend, &file] (const QPoint& pos) {
 		QMenu menu (this);
@@ -97,12 +115,105 @@ AttachedImageFile::AttachedImageFile (Backend& backend, const BackendFile& file,
 
 AttachedImageFile::~AttachedImageFile()
 {
+	cancelImageRequest ();
+	imageDecodeToken.cancel ();
     delete ui;
 }
 
+void AttachedImageFile::requestImage ()
+{
+	if (imageRequested) {
+		return;
+	}
+
+	imageRequested = true;
+
+	//the widget may be destroyed before the file arrives (cached files are delivered on the next event loop iteration)
+	QPointer<AttachedImageFile> self (this);
+
+	imageRequest = backend.retrieveFile (file.id, [self] (const QByteArray& fileContents){
+
+		if (!self) {
+			return;
+		}
+
+		self->setImage (fileContents);
+	}, getInlineViewTier (file));
+}
+
+void AttachedImageFile::cancelImageRequest ()
+{
+	//the full-size decoding is not needed while the image is away. The image is taken from the cache next time
+	if (imageDecoding) {
+		imageDecodeToken.cancel ();
+		imageDecoding = false;
+		imageRequested = false;
+		return;
+	}
+
+	if (!imageRequest.isPending()) {
+		return;
+	}
+
+	//if the same file is requested from elsewhere (for example, for saving), the download continues for it
+	imageRequest.cancel ();
+	imageRequest = HttpRequestHandle ();
+
+	//allow the image to be requested again, when it gets near the visible area
+	imageRequested = false;
+}
+
+void AttachedImageFile::setImage (const QByteArray& fileContents)
+{
+	imageRequest = HttpRequestHandle ();
+
+	QSettings settings;
+
+	int maxWidth = settings.value(DOWNLOAD_IMAGE_MAX_WIDTH, 500).toInt();
+	int maxHeight = settings.value(DOWNLOAD_IMAGE_MAX_HEIGHT, 500).toInt();
+
+	//the mini preview stays visible until the image is decoded
+	imageDecodeToken.cancel ();
+	imageDecoding = true;
+
+	imageDecodeToken = ImageDecoder::decode (fileContents, QSize (maxWidth, maxHeight), ImageScaleMode::fitInside, this, [this] (const QImage& img) {
+		imageDecoding = false;
+		ui->imagePreview->setPixmap (QPixmap::fromImage(img));
+		ui->imagePreview->adjustSize();
+
+		adjustSize();
+
+		emit dimensionsChanged ();
+		//parentWidget()->adjustSize();
+	});
+
+	filePreviewData = FilePreviewData {fileContents, file.name, authorName};
+
+	if (openPreviewOnLoad) {
+		openPreviewOnLoad = false;
+		openPreview ();
+	}
+}
+
 void AttachedImageFile::mouseReleaseEvent (QMouseEvent*)
 {
 	qDebug() << "mouseRelease";
+
+	/*
+	 * The image is not received yet (it may not even be requested, if the list is scrolled quickly).
+	 * Open the preview when it arrives
+	 */
+	if (filePreviewData.fileContents.isEmpty()) {
+		openPreviewOnLoad = true;
+		requestImage ();
+		return;
+	}
+
+	openPreview ();
+}
+
+void AttachedImageFile::openPreview ()
+{
 	auto openFile = currentlyOpenFiles.find (this);
 
 	FilePreview* filePreview;
@@ -117,6 +228,20 @@ void AttachedImageFile::mouseReleaseEvent (QMouseEvent*)
 		filePreview->setAttribute (Qt::WA_DeleteOnClose);
 		filePreview->show ();
 
+		/*
+		 * The preview window shows the scaled-down image first.
+		 * Only the preview window needs the original image
+		 */
+		if (getInlineViewTier (file) != FileTier::original) {
+			QPointer<FilePreview> filePreviewPtr (filePreview);
+
+			backend.retrieveFile (file.id, [filePreviewPtr] (const QByteArray& fileContents) {
+				if (filePreviewPtr) {
+					filePreviewPtr->setFileContents (fileContents);
+				}
+			});
+		}
+
 		connect (filePreview, &QDialog::rejected, [this] {
 				qDebug() << "Rejected";
 				currentlyOpenFiles.erase (this);
@@ -20,8 +20,10 @@
 #pragma once
 
 #include <QWidget>
+#include <QPointer>
 #include <map>
 #include "preview-window/FilePreview.h"
+#include "backend/HTTPConnector.h"
 
 namespace Ui {
 class AttachedImageFile;
@@ -40,14 +42,37 @@ class AttachedImageFile: public QWidget {
 public:
     explicit AttachedImageFile (Backend& backend, const BackendFile& file, const QString& authorName, QWidget *parent = nullptr);
     ~AttachedImageFile();
+public:
+
+    /**
+     * Request the full image. Until it is received, the file's mini_preview is shown.
+     * Does nothing if the image is already received or requested
+     */
+    void requestImage ();
+
+    /**
+     * Abort the image request or the image decoding, if it is still in progress.
+     * Called when the image is scrolled away from the visible area, before being shown
+     */
+    void cancelImageRequest ();
 private:
     void mouseReleaseEvent(QMouseEvent *event) override;
+    void setImage (const QByteArray& fileContents);
+    void openPreview ();
 signals:
 	void dimensionsChanged ();
 
 private:
     Ui::AttachedImageFile*	ui;
+    Backend&				backend;
+    const BackendFile&		file;
+    QString					authorName;
+    HttpRequestHandle		imageRequest;
+    ImageDecodeToken		imageDecodeToken;
     FilePreviewData			filePreviewData;
+    bool					imageRequested;
+    bool					imageDecoding;
+    bool					openPreviewOnLoad;
     static std::map <const QWidget*, FilePreview*>	currentlyOpenFiles;
 };
 
@@ -60,7 +60,9 @@ void PostAttachmentList::addFile (const BackendFile& file, const QString& author
 	if (file.mini_preview.isEmpty()) {
 		fileWidget = new AttachedBinaryFile (backend, file, this);
 	} else {
-		fileWidget = new AttachedImageFile (backend, file, authorName, this);
+		AttachedImageFile* imageFile = new AttachedImageFile (backend, file, authorName, this);
+		imageFiles.push_back (imageFile);
+		fileWidget = imageFile;
 		sizeKnown = false;
 		connect ((AttachedImageFile*)fileWidget, &AttachedImageFile::dimensionsChanged, [newItem, fileWidget, this] {
 			newItem->setSizeHint(QSize (fileWidget->width(), fileWidget->height() + 10));
@@ -84,5 +86,16 @@ void PostAttachmentList::addFile (const BackendFile& file, const QString& author
 	}
 }
 
+void PostAttachmentList::setNearViewport (bool nearViewport)
+{
+	for (AttachedImageFile* imageFile: imageFiles) {
+		if (nearViewport) {
+			imageFile->requestImage ();
+		} else {
+			imageFile->cancelImageRequest ();
+		}
+	}
+}
+
 } /* namespace Mattermost */
 
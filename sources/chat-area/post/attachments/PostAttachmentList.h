@@ -33,6 +33,7 @@ namespace Mattermost {
 
 class Backend;
 class BackendFile;
+class AttachedImageFile;
 
 class PostAttachmentList: public QWidget
 {
@@ -43,9 +44,16 @@ public:
 public:
     void addFile (const BackendFile& file, const QString& authorName);
     void updateDimensions ();
+
+    /**
+     * Called by the posts list when the post gets near the visible area (or away from it).
+     * Images are requested only when they are about to be shown
+     */
+    void setNearViewport (bool nearViewport);
 private:
     Backend& 						backend;
     Ui::PostAttachmentList*			ui;
+    QList<AttachedImageFile*>		imageFiles;
 };
 
 } /* namespace Mattermost */
@@ -18,31 +18,28 @@
  */
 
 #include "PostReaction.h"
+
+#include <QHelpEvent>
+#include <QToolTip>
 #include "backend/types/BackendPost.h"
+#include "backend/Storage.h"
 #include "ui_PostReaction.h"
 
 namespace Mattermost {
 
-PostReaction::PostReaction (const QString& emojiName, const QString& emojiValue, const BackendPostReaction& reactionData, QWidget *parent)
+PostReaction::PostReaction (const Storage& storage, const QString& emojiName, const QString& emojiValue, const BackendPostReaction& reactionData, QWidget *parent)
 :QWidget(parent)
 ,ui(new Ui::PostReaction)
+,storage (storage)
+,toolTipHeader (emojiName + "  " + emojiValue)
+,userIds (reactionData.userIds)
 {
     ui->setupUi (this);
 
     QString emojiWidgetValue (emojiValue);
     emojiWidgetValue.replace("width=32 height=32", "width=20 height=20");
     ui->emoji->setText (emojiWidgetValue);
-    ui->count->setText (QString::number (reactionData.size()));
-
-    QString tooltip (emojiName + "  " + emojiValue + "\n");
-
-    for (auto& it: reactionData) {
-    	tooltip += it + "\n";
-    }
-
-    //remove the last '\n'
-    tooltip.chop (1);
-    setToolTip (tooltip);
+    ui->count->setText (QString::number (reactionData.count()));
 
 	QPalette pal = palette();
 	pal.setColor(QPalette::Base, QColor (230,230,230));
@@ -55,4 +52,27 @@ PostReaction::~PostReaction()
     delete ui;
 }
 
+bool PostReaction::event (QEvent* event)
+{
+	//the user names are resolved only when the tooltip is shown, so they are always up to date
+	if (event->type() == QEvent::ToolTip) {
+		QHelpEvent* helpEvent = static_cast<QHelpEvent*> (event);
+		QToolTip::showText (helpEvent->globalPos(), getToolTipText (), this);
+		return true;
+	}
+
+	return QWidget::event (event);
+}
+
+QString PostReaction::getToolTipText () const
+{
+	QString tooltip (toolTipHeader);
+
+	for (const QString& userId: userIds) {
+		tooltip += "\n" + storage.getUserDisplayNameByUserId (userId, true);
+	}
+
+	return tooltip;
+}
+
 } /* namespace Mattermost */
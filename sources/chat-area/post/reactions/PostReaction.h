@@ -21,6 +21,7 @@
 #define POSTREACTION_H
 
 #include <QWidget>
+#include <QVector>
 
 namespace Ui {
 class PostReaction;
@@ -28,17 +29,23 @@ class PostReaction;
 
 namespace Mattermost {
 
-using BackendPostReaction = QVector<QString>;
+class Storage;
+struct BackendPostReaction;
 
 class PostReaction: public QWidget
 {
     Q_OBJECT
 public:
-    explicit PostReaction (const QString& emojiName, const QString& emojiValue, const BackendPostReaction& reactionData, QWidget *parent = nullptr);
+    explicit PostReaction (const Storage& storage, const QString& emojiName, const QString& emojiValue, const BackendPostReaction& reactionData, QWidget *parent = nullptr);
     ~PostReaction();
-
+private:
+    bool event (QEvent* event) override;
+    QString getToolTipText () const;
 private:
     Ui::PostReaction *ui;
+    const Storage&		storage;
+    QString				toolTipHeader;
+    QVector<QString>	userIds;
 };
 
 } /* namespace Mattermost */
@@ -25,9 +25,10 @@
 
 namespace Mattermost {
 
-PostReactionList::PostReactionList(QWidget *parent) :
+PostReactionList::PostReactionList(const Storage& storage, QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::PostReactionList)
+    ui(new Ui::PostReactionList),
+    storage(storage)
 {
     ui->setupUi(this);
 }
@@ -39,7 +40,7 @@ PostReactionList::~PostReactionList()
 
 void PostReactionList::addReaction (const QString& emojiName, const QString& emojiValue, const BackendPostReaction& reactionData)
 {
-	PostReaction* reaction = new PostReaction (emojiName, emojiValue, reactionData, this);
+	PostReaction* reaction = new PostReaction (storage, emojiName, emojiValue, reactionData, this);
 	ui->horizontalLayout_2->addWidget (reaction, 0, Qt::AlignLeft);
 }
 
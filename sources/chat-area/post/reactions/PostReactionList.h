@@ -28,19 +28,21 @@ class PostReactionList;
 
 namespace Mattermost {
 
-using BackendPostReaction = QVector<QString>;
+class Storage;
+struct BackendPostReaction;
 
 class PostReactionList: public QWidget
 {
     Q_OBJECT
 public:
-    explicit PostReactionList(QWidget *parent = nullptr);
+    explicit PostReactionList(const Storage& storage, QWidget *parent = nullptr);
     ~PostReactionList();
 public:
     void addReaction (const QString& emojiName, const QString& emojiValue, const BackendPostReaction& reactionData);
 
 private:
     Ui::PostReactionList *ui;
+    const Storage& storage;
 };
 
 #endif // POSTREACTIONLIST_H
@@ -18,6 +18,7 @@
  */
 
 #include "ChooseEmojiDialog.h"
+#include <algorithm>
 
 #include <QLabel>
 #include <QMenu>
@@ -26,6 +27,7 @@
 #include <QSettings>
 #include <QComboBox>
 #include "backend/emoji/EmojiInfo.h"
+#include "backend/Trace.h"
 #include "ui_ChooseEmojiDialog.h"
 
 namespace Mattermost {
@@ -53,9 +55,13 @@ static const uint32_t indexForCategoryTab[EmojiCategory::COUNT] = {
 ChooseEmojiDialog::ChooseEmojiDialog(QWidget *parent)
 :QDialog(parent)
 ,ui(new Ui::ChooseEmojiDialog)
+,customTabIndex (-1)
 {
 	ui->setupUi(this);
 
+	connect (ui->tabWidget, &QTabWidget::currentChanged, [this] {
+		requestCustomEmojiImages ();
+	});
 }
 
 ChooseEmojiDialog::~ChooseEmojiDialog()
@@ -72,6 +78,73 @@ void ChooseEmojiDialog::show ()
 {
 	createEmojiTabs ();
 	QDialog::show ();
+	requestCustomEmojiImages ();
+}
+
+void ChooseEmojiDialog::updateCustomEmojiImages (const QSet<QString>& emojiNames)
+{
+	for (const QPointer<QPushButton>& pushButton: customEmojiButtons) {
+		if (pushButton && emojiNames.contains (pushButton->toolTip())) {
+			setEmojiIcon (pushButton, EmojiInfo::getEmoji (EmojiInfo::findByName (pushButton->toolTip())));
+		}
+	}
+
+	//forget the buttons, which already show their image or were deleted together with their tab
+	customEmojiButtons.erase (std::remove_if (customEmojiButtons.begin(), customEmojiButtons.end(), [] (const QPointer<QPushButton>& pushButton) {
+		return !pushButton || !pushButton->icon().isNull();
+	}), customEmojiButtons.end());
+}
+
+void ChooseEmojiDialog::requestCustomEmojiImages ()
+{
+	QWidget* currentTab = ui->tabWidget->currentWidget ();
+
+	if (!isVisible() || !currentTab) {
+		return;
+	}
+
+	for (const QPointer<QPushButton>& pushButton: customEmojiButtons) {
+		if (pushButton && pushButton->icon().isNull() && currentTab->isAncestorOf (pushButton)) {
+			//requests the image, if it is not available yet. If it is cached, it is returned immediately
+			setEmojiIcon (pushButton, EmojiInfo::getEmoji (EmojiInfo::findByName (pushButton->toolTip())));
+		}
+	}
+}
+
+bool ChooseEmojiDialog::setEmojiIcon (QPushButton* pushButton, const Emoji& emoji)
+{
+	/**
+	 * Replace the unicode string with icon for custom emojis
+	 * This is how they work, when on a button in the dialog.
+	 */
+	QString str (emoji.unicodeString);
+	int found1 = str.indexOf ('"');
+
+	if (found1 == -1) {
+		return false;
+	}
+
+	++found1;
+	int found2 = str.indexOf ('"', found1);
+
+	if (found2 == -1) {
+		return false;
+	}
+
+	QString path (str.mid (found1, found2-found1));
+	path.replace("qrc://",":/");
+	qDebug() << "Use path " << path;
+	QIcon icon (QPixmap::fromImage(QImage(path)));
+	pushButton->setText ("");
+	pushButton->setIcon (icon);
+	pushButton->setIconSize(QSize(24,24));
+
+	//Use the 'mattermost' emoji for the 'custom' category's icon
+	if (customTabIndex != -1 && emoji.name == "mattermost" && ui->tabWidget->widget (customTabIndex)->isAncestorOf (pushButton)) {
+		ui->tabWidget->setTabIcon (customTabIndex, icon);
+	}
+
+	return true;
 }
 
 QGridLayout* ChooseEmojiDialog::createTab (uint32_t categoryIdx, int tabIndex)
@@ -165,6 +238,8 @@ void ChooseEmojiDialog::createEmojiTabs ()
 		return;
 	}
 
+	TraceSpan span ("ui", "ChooseEmojiDialog::createEmojiTabs");
+
 	restoreEmojiFavorites ();
 	uint32_t tabIndex = 0;
 
@@ -200,6 +275,10 @@ void ChooseEmojiDialog::createTabForCategory (uint32_t categoryIndex, uint32_t t
 
 	QGridLayout *gridLayout = createTab (categoryIndex, tabIndex);
 
+	if (categoryIndex == EmojiCategory::custom) {
+		customTabIndex = tabIndex;
+	}
+
 	/**
 	 * For the 'people' category, add a combobox for settings skin tone
 	 */
@@ -252,29 +331,19 @@ void ChooseEmojiDialog::createTabForCategory (uint32_t categoryIndex, uint32_t t
 		});
 
 
+		gridLayout->addWidget(pushButton, row, column, 1, 1);
+
 		/**
-		 * Replace the unicode string with icon for custom emojis
-		 * This is how they work, when on a button in the dialog.
+		 * Custom emojis without image are shown by name. Their images are requested when the tab is shown.
+		 * The 'mattermost' emoji is the custom category's icon, so its image is requested right away
 		 */
-		QString str (emoji.unicodeString);
-		int found1 = str.indexOf ('"');
-
-		if (found1 != -1) {
-			++found1;
-			int found2 = str.indexOf ('"', found1);
-			if (found2 != -1) {
-				QString path (str.mid (found1, found2-found1));
-				path.replace("qrc://",":/");
-				qDebug() << "Use path " << path;
-				QIcon icon (QPixmap::fromImage(QImage(path)));
-				pushButton->setText ("");
-				pushButton->setIcon (icon);
-				pushButton->setIconSize(QSize(24,24));
-
-				//Use the 'mattermost' emoji for the 'custom' category's icon
-				if (categoryIndex == EmojiCategory::custom && emoji.name == "mattermost") {
-					ui->tabWidget->setTabIcon (tabIndex, icon);
-				}
+		if (!setEmojiIcon (pushButton, emoji) && emoji.unicodeString == ':' + emoji.name + ':') {
+			if (categoryIndex == EmojiCategory::custom && emoji.name == "mattermost") {
+				setEmojiIcon (pushButton, EmojiInfo::getEmoji (EmojiInfo::findByName (emoji.name)));
+			}
+
+			if (pushButton->icon().isNull()) {
+				customEmojiButtons.push_back (pushButton);
 			}
 		}
 
@@ -284,8 +353,6 @@ void ChooseEmojiDialog::createTabForCategory (uint32_t categoryIndex, uint32_t t
 			accept ();
 		});
 
-		gridLayout->addWidget(pushButton, row, column, 1, 1);
-
 		if (categoryIndex == EmojiCategory::people) {
 			peopleEmojiButtons.push_back(pushButton);
 		}
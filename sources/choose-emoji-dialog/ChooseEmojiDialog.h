@@ -22,6 +22,8 @@
 
 #include <QDialog>
 #include <QMap>
+#include <QPointer>
+#include <QSet>
 #include "backend/emoji/EmojiDefs.h"
 
 class QGridLayout;
@@ -39,6 +41,12 @@ private:
     ~ChooseEmojiDialog();
 public:
     void show ();
+
+    /**
+     * Show the received images of custom emojis, which were shown by name until now
+     * @param emojiNames names of the custom emojis
+     */
+    void updateCustomEmojiImages (const QSet<QString>& emojiNames);
 private:
     void createEmojiTabs ();
     void createTabForCategory (uint32_t categoryIndex, uint32_t tabIndex, const QString& tabName, const QVector<Emoji>& emojis);
@@ -48,6 +56,18 @@ private:
     void restoreEmojiFavorites ();
     void saveEmojiFavorites ();
     void updateFavoritesTab ();
+
+    /**
+     * Request the images of the custom emojis in the current tab. The images of the other tabs
+     * are not downloaded, until the tabs are shown
+     */
+    void requestCustomEmojiImages ();
+
+    /**
+     * Show the emoji image on the button, if the emoji has an image
+     * @return false if the emoji is not an image
+     */
+    bool setEmojiIcon (QPushButton* pushButton, const Emoji& emoji);
 private:
     friend class ChooseEmojiDialogWrapper;
     Ui::ChooseEmojiDialog*	ui;
@@ -55,6 +75,10 @@ private:
     QVector<QPushButton*>	peopleEmojiButtons;
     Emoji					selectedEmoji;
     QMap<EmojiID, Emoji>	favorites;
+
+    //buttons of custom emojis, which are shown by name until their images are received
+    QVector<QPointer<QPushButton>>	customEmojiButtons;
+    int						customTabIndex;
 };
 
 } /* namespace Mattermost */
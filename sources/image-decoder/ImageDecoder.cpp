@@ -0,0 +1,172 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "ImageDecoder.h"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QImageReader>
+#include <QPointer>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+
+namespace Mattermost {
+
+void ImageDecodeToken::cancel ()
+{
+	if (cancelled) {
+		*cancelled = true;
+	}
+}
+
+bool ImageDecodeToken::isCancelled () const
+{
+	return cancelled && *cancelled;
+}
+
+/**
+ * Get the size of the decoded image
+ * @param size original image size
+ */
+static QSize getScaledSize (QSize size, QSize targetSize, ImageScaleMode::type scaleMode)
+{
+	switch (scaleMode) {
+	case ImageScaleMode::exact:
+		return targetSize;
+
+	case ImageScaleMode::fitInside:
+		if (size.width() > targetSize.width() || size.height() > targetSize.height()) {
+			return size.scaled (targetSize, Qt::KeepAspectRatio);
+		}
+		return size;
+
+	default:
+		return size;
+	}
+}
+
+class ImageDecodeTask: public QRunnable {
+public:
+	ImageDecodeTask (const QByteArray& data, QSize targetSize, ImageScaleMode::type scaleMode, const ImageDecodeToken& token, std::function<void(const QImage&)> callback)
+	:data (data)
+	,targetSize (targetSize)
+	,scaleMode (scaleMode)
+	,token (token)
+	,callback (callback)
+	{
+	}
+
+	void run () override
+	{
+		if (token.isCancelled()) {
+			return;
+		}
+
+		QImage image = ImageDecoder::decodeImage (data, targetSize, scaleMode);
+		callback (image);
+	}
+private:
+	QByteArray						data;
+	QSize							targetSize;
+	ImageScaleMode::type			scaleMode;
+	ImageDecodeToken				token;
+	std::function<void(const QImage&)>	callback;
+};
+
+ImageDecodeToken ImageDecoder::decode (const QByteArray& data, QSize targetSize, ImageScaleMode::type scaleMode, QObject* context, std::function<void(const QImage&)> callback)
+{
+	ImageDecodeToken token;
+	token.cancelled = std::make_shared<std::atomic<bool>> (false);
+
+	/*
+	 * No connection to the context's destroyed() signal: it would stay for the lifetime of the context,
+	 * piling up on long lived widgets. The owners keep the tokens of their pending requests and cancel them in their destructors.
+	 * The context object may be destroyed at any time in the GUI thread, so it is checked only there.
+	 * The result is posted to the application object, which lives in the GUI thread
+	 */
+	QPointer<QObject> contextPtr (context);
+
+	auto deliverImage = [token, contextPtr, callback] (const QImage& image) {
+		QMetaObject::invokeMethod (QCoreApplication::instance(), [token, contextPtr, callback, image] {
+			if (token.isCancelled() || !contextPtr) {
+				return;
+			}
+
+			callback (image);
+		}, Qt::QueuedConnection);
+	};
+
+	getThreadPool().start (new ImageDecodeTask (data, targetSize, scaleMode, token, deliverImage));
+	return token;
+}
+
+QImage ImageDecoder::decodeImage (const QByteArray& data, QSize targetSize, ImageScaleMode::type scaleMode)
+{
+	QBuffer buffer;
+	buffer.setData (data);
+	buffer.open (QIODevice::ReadOnly);
+
+	QImageReader reader (&buffer);
+
+	//the size is read from the image header, without decoding the image
+	QSize originalSize (reader.size());
+
+	if (originalSize.isValid()) {
+		QSize scaledSize (getScaledSize (originalSize, targetSize, scaleMode));
+
+		if (scaledSize != originalSize) {
+			reader.setScaledSize (scaledSize);
+		}
+
+		return reader.read ();
+	}
+
+	//the format does not provide the image size before decoding. Decode it and scale it afterwards
+	QImage image (reader.read());
+
+	if (image.isNull()) {
+		return image;
+	}
+
+	QSize scaledSize (getScaledSize (image.size(), targetSize, scaleMode));
+
+	if (scaledSize != image.size()) {
+		image = image.scaled (scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+	}
+
+	return image;
+}
+
+QThreadPool& ImageDecoder::getThreadPool ()
+{
+	static QThreadPool threadPool;
+	static bool initialized = false;
+
+	if (!initialized) {
+		//leave one core for the GUI thread
+		threadPool.setMaxThreadCount (std::max (QThread::idealThreadCount() - 1, 1));
+		initialized = true;
+	}
+
+	return threadPool;
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,85 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QObject;
+class QThreadPool;
+
+namespace Mattermost {
+
+namespace ImageScaleMode {
+enum type {
+	original,		///< decode the image with its original size
+	fitInside,		///< scale down (keeping the aspect ratio), so that the image fits inside the target size. Smaller images are not enlarged
+	exact,			///< scale to the target size, ignoring the aspect ratio (used for avatars)
+};
+}
+
+/**
+ * Cancellation token of an image decode request.
+ * A cancelled request is not decoded (if it has not started yet) and its callback is not called.
+ * An empty (default constructed) token does nothing
+ */
+class ImageDecodeToken {
+public:
+	ImageDecodeToken () = default;
+	void cancel ();
+	bool isCancelled () const;
+private:
+	friend class ImageDecoder;
+	std::shared_ptr<std::atomic<bool>>	cancelled;
+};
+
+/**
+ * Decodes images in a pool of worker threads, so that large images do not block the GUI thread.
+ * Images are decoded directly at the target size (with QImageReader::setScaledSize), when the format supports it
+ */
+class ImageDecoder {
+public:
+
+	/**
+	 * Decode (and scale) an image in a worker thread.
+	 * The callback is called in the GUI thread, unless the request is cancelled or the context object is destroyed.
+	 * Destroying the context object does not stop the decoding. The owner keeps the token and cancels it
+	 * when the image is no longer needed (at the latest, in its destructor)
+	 * @param data encoded image (any format supported by QImageReader)
+	 * @param targetSize size of the decoded image. Ignored for ImageScaleMode::original
+	 * @param scaleMode how the image is scaled to targetSize
+	 * @param context the object (usually widget), which receives the image
+	 * @param callback called with the decoded image. The image is null if decoding failed
+	 * @return token, which can be used to cancel the request
+	 */
+	static ImageDecodeToken decode (const QByteArray& data, QSize targetSize, ImageScaleMode::type scaleMode, QObject* context, std::function<void(const QImage&)> callback);
+
+	/**
+	 * Decode (and scale) an image in the calling thread
+	 */
+	static QImage decodeImage (const QByteArray& data, QSize targetSize, ImageScaleMode::type scaleMode);
+private:
+	static QThreadPool& getThreadPool ();
+};
+
+} /* namespace Mattermost */
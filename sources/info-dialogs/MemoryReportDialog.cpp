@@ -0,0 +1,171 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "MemoryReportDialog.h"
+
+#include <algorithm>
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include "backend/Backend.h"
+#include "backend/types/BackendChannel.h"
+#include "chat-area/ChatArea.h"
+#include "chat-area/post/PostWidget.h"
+
+namespace Mattermost {
+
+namespace {
+
+/**
+ * Rough size of a widget with its private data. Used only to compare the chat areas with each other
+ */
+constexpr qint64 widgetSizeEstimate = 1024;
+
+qint64 getPixmapSize (const QLabel& label)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5,15,0)
+	QPixmap pixmap (label.pixmap (Qt::ReturnByValue));
+#else
+	QPixmap pixmap (label.pixmap() ? *label.pixmap() : QPixmap());
+#endif
+
+	return qint64 (pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+/**
+ * Sum of the decoded images, shown in the labels
+ */
+void addPixmapsSize (const QWidget& widget, uint64_t& count, qint64& size)
+{
+	for (const QLabel* label: widget.findChildren<QLabel*>()) {
+		qint64 labelPixmapSize = getPixmapSize (*label);
+
+		if (labelPixmapSize) {
+			++count;
+			size += labelPixmapSize;
+		}
+	}
+}
+
+} /* namespace */
+
+MemoryReportDialog::MemoryReportDialog (Backend& backend, const QWidget& mainWindow, QWidget* parent)
+:QDialog (parent)
+,backend (backend)
+,mainWindow (mainWindow)
+,summaryLabel (new QLabel (this))
+,usageTree (new QTreeWidget (this))
+{
+	setWindowTitle ("Memory usage - Mattermost");
+	resize (700, 500);
+
+	usageTree->setHeaderLabels ({"Category", "Objects", "Size"});
+	usageTree->header()->setSectionResizeMode (0, QHeaderView::Stretch);
+	usageTree->header()->setSectionResizeMode (1, QHeaderView::ResizeToContents);
+	usageTree->header()->setSectionResizeMode (2, QHeaderView::ResizeToContents);
+	usageTree->header()->setStretchLastSection (false);
+
+	QDialogButtonBox* buttonBox = new QDialogButtonBox (QDialogButtonBox::Close, this);
+	QPushButton* refreshButton = buttonBox->addButton ("Refresh", QDialogButtonBox::ActionRole);
+
+	connect (buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+	connect (refreshButton, &QPushButton::clicked, this, &MemoryReportDialog::refresh);
+
+	QVBoxLayout* layout = new QVBoxLayout (this);
+	layout->addWidget (summaryLabel);
+	layout->addWidget (usageTree);
+	layout->addWidget (buttonBox);
+
+	refresh ();
+}
+
+MemoryReportDialog::~MemoryReportDialog () = default;
+
+QVector<MemoryUsage> MemoryReportDialog::collect (Backend& backend, const QWidget& mainWindow)
+{
+	QVector<MemoryUsage> usage (MemoryAccounting::collect (backend.getStorage(), backend.getCacheManager()));
+
+	uint64_t otherPixmapsCount = 0;
+	qint64 otherPixmapsSize = 0;
+	addPixmapsSize (mainWindow, otherPixmapsCount, otherPixmapsSize);
+
+	for (const ChatArea* chatArea: mainWindow.findChildren<ChatArea*>()) {
+		QString channelName (chatArea->channel.display_name);
+
+		uint64_t postWidgetsCount = chatArea->findChildren<PostWidget*>().size();
+		uint64_t widgetsCount = chatArea->findChildren<QWidget*>().size();
+
+		if (postWidgetsCount) {
+			usage.append (MemoryUsage {"Post widgets", channelName, postWidgetsCount, qint64 (widgetsCount) * widgetSizeEstimate});
+		}
+
+		uint64_t pixmapsCount = 0;
+		qint64 pixmapsSize = 0;
+		addPixmapsSize (*chatArea, pixmapsCount, pixmapsSize);
+
+		if (pixmapsCount) {
+			usage.append (MemoryUsage {"Decoded images", channelName, pixmapsCount, pixmapsSize});
+		}
+
+		//the images in the chat areas are already counted
+		otherPixmapsCount -= pixmapsCount;
+		otherPixmapsSize -= pixmapsSize;
+	}
+
+	if (otherPixmapsCount) {
+		usage.append (MemoryUsage {"Decoded images", "Other widgets", otherPixmapsCount, otherPixmapsSize});
+	}
+
+	return usage;
+}
+
+void MemoryReportDialog::refresh ()
+{
+	QVector<MemoryUsage> usage (collect (backend, mainWindow));
+	QVector<MemoryUsage> totals (MemoryAccounting::getCategoryTotals (usage));
+
+	std::sort (usage.begin(), usage.end(), [] (const MemoryUsage& lhs, const MemoryUsage& rhs) {
+		return lhs.bytes > rhs.bytes;
+	});
+
+	usageTree->clear ();
+	qint64 totalSize = 0;
+
+	for (const MemoryUsage& total: totals) {
+		totalSize += total.bytes;
+
+		QTreeWidgetItem* categoryItem = new QTreeWidgetItem (usageTree, {
+			total.category, QString::number (total.count), MemoryAccounting::formatSize (total.bytes)
+		});
+
+		for (const MemoryUsage& entry: usage) {
+			if (entry.category == total.category && !entry.name.isEmpty()) {
+				new QTreeWidgetItem (categoryItem, {entry.name, QString::number (entry.count), MemoryAccounting::formatSize (entry.bytes)});
+			}
+		}
+	}
+
+	summaryLabel->setText ("Estimated memory usage: " + MemoryAccounting::formatSize (totalSize)
+			+ ". The sizes are approximate and are meant for comparison");
+}
+
+} /* namespace Mattermost */
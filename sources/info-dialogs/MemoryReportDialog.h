@@ -0,0 +1,55 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QDialog>
+#include "backend/MemoryAccounting.h"
+
+class QLabel;
+class QTreeWidget;
+
+namespace Mattermost {
+
+class Backend;
+
+/**
+ * Shows the estimated memory usage of the backend data and of the chat areas, by category
+ */
+class MemoryReportDialog: public QDialog {
+	Q_OBJECT
+public:
+	MemoryReportDialog (Backend& backend, const QWidget& mainWindow, QWidget* parent = nullptr);
+	~MemoryReportDialog ();
+
+	void refresh ();
+
+	/**
+	 * Collect the memory usage of the backend data and of the widgets in the main window
+	 * (post widgets and decoded images for each chat area)
+	 */
+	static QVector<MemoryUsage> collect (Backend& backend, const QWidget& mainWindow);
+private:
+	Backend&		backend;
+	const QWidget&	mainWindow;
+	QLabel*			summaryLabel;
+	QTreeWidget*	usageTree;
+};
+
+} /* namespace Mattermost */
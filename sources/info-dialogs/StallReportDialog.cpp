@@ -0,0 +1,106 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "StallReportDialog.h"
+
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include "backend/StallMonitor.h"
+
+namespace Mattermost {
+
+StallReportDialog::StallReportDialog (QWidget* parent)
+:QDialog (parent)
+,summaryLabel (new QLabel (this))
+,stallsTree (new QTreeWidget (this))
+{
+	setWindowTitle ("Event loop stalls - Mattermost");
+	resize (800, 500);
+
+	stallsTree->setHeaderLabels ({"Time", "Duration", "Handlers"});
+	stallsTree->header()->setSectionResizeMode (0, QHeaderView::ResizeToContents);
+	stallsTree->header()->setSectionResizeMode (1, QHeaderView::ResizeToContents);
+
+	QDialogButtonBox* buttonBox = new QDialogButtonBox (QDialogButtonBox::Close, this);
+	QPushButton* refreshButton = buttonBox->addButton ("Refresh", QDialogButtonBox::ActionRole);
+	QPushButton* saveButton = buttonBox->addButton ("Save...", QDialogButtonBox::ActionRole);
+
+	connect (buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+	connect (refreshButton, &QPushButton::clicked, this, &StallReportDialog::refresh);
+	connect (saveButton, &QPushButton::clicked, this, &StallReportDialog::save);
+
+	QVBoxLayout* layout = new QVBoxLayout (this);
+	layout->addWidget (summaryLabel);
+	layout->addWidget (stallsTree);
+	layout->addWidget (buttonBox);
+
+	refresh ();
+}
+
+StallReportDialog::~StallReportDialog () = default;
+
+void StallReportDialog::refresh ()
+{
+	if (!StallMonitor::isEnabled()) {
+		summaryLabel->setText ("The event loop is not monitored (the threshold setting is 0)");
+		stallsTree->clear ();
+		return;
+	}
+
+	QVector<EventLoopStall> stalls (StallMonitor::getWorstStalls());
+
+	summaryLabel->setText (QString ("Stalls longer than %1 ms: %2. The last %3 are shown, the longest first")
+			.arg (StallMonitor::getThreshold()).arg (StallMonitor::getStallsCount()).arg (stalls.size()));
+
+	stallsTree->clear ();
+
+	for (const EventLoopStall& stall: stalls) {
+		QTreeWidgetItem* item = new QTreeWidgetItem (stallsTree, {
+			stall.time.toString ("HH:mm:ss.zzz"),
+			QString::number (stall.duration, 'f', 1) + " ms",
+			stall.handlers.value (0)
+		});
+
+		//the first handler is shown in the stall row, the others - as its children
+		for (int i = 1; i < stall.handlers.size(); ++i) {
+			new QTreeWidgetItem (item, {QString(), QString(), stall.handlers[i]});
+		}
+	}
+}
+
+void StallReportDialog::save ()
+{
+	QString fileName = QFileDialog::getSaveFileName (this, "Save stalls report", "mattermost-stalls.txt");
+
+	if (fileName.isEmpty()) {
+		return;
+	}
+
+	if (!StallMonitor::saveReport (fileName)) {
+		QMessageBox::warning (this, "Save stalls report", "Cannot write " + fileName);
+	}
+}
+
+} /* namespace Mattermost */
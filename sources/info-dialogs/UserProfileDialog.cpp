@@ -21,6 +21,7 @@
 #include "ui_UserProfileDialog.h"
 
 #include "backend/types/BackendUser.h"
+#include "image-decoder/ImageDecoder.h"
 
 namespace Mattermost {
 
@@ -37,8 +38,10 @@ UserProfileDialog::UserProfileDialog (const BackendUser& user, QWidget *parent)
 
     setWindowTitle ("Profile for " + user.getDisplayName() + " - Mattermost");
 
-	QImage img = QImage::fromData (user.avatar).scaled (128, 128, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-    ui->avatar->setPixmap (QPixmap::fromImage(img));
+	avatarDecodeToken = ImageDecoder::decode (user.avatar, QSize (128, 128), ImageScaleMode::exact, this, [this] (const QImage& img) {
+		ui->avatar->setPixmap (QPixmap::fromImage(img));
+	});
+
     ui->fullnameValue->setText (user.first_name + " " + user.last_name);
     ui->nicknameValue->setText (getString (user.nickname));
     ui->usernameValue->setText (user.username);
@@ -50,6 +53,7 @@ UserProfileDialog::UserProfileDialog (const BackendUser& user, QWidget *parent)
 
 UserProfileDialog::~UserProfileDialog()
 {
+	avatarDecodeToken.cancel ();
     delete ui;
 }
 
@@ -22,6 +22,7 @@
 
 #include <QDialog>
 #include "fwd.h"
+#include "image-decoder/ImageDecoder.h"
 
 namespace Ui {
 class UserProfileDialog;
@@ -39,6 +40,7 @@ public:
 
 private:
     Ui::UserProfileDialog *ui;
+    ImageDecodeToken avatarDecodeToken;
 };
 
 } /* namespace Mattermost */
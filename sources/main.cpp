@@ -25,7 +25,10 @@
 #include "login/LoginDialog.h"
 #include "mainwindow.h"
 #include "backend/Backend.h"
+#include "backend/Trace.h"
+#include "backend/TrafficCapture.h"
 #include "config/Config.h"
+#include "Settings.h"
 
 namespace Mattermost {
 
@@ -37,6 +40,11 @@ public:
 	void showWindow ();
 	void toggleShowWindow ();
 	void reopen ();
+private:
+	QString getArgumentValue (const QString& name) const;
+	void startTrace ();
+	void startStallMonitor ();
+	void startTrafficCapture ();
 private:
 	std::unique_ptr<MainWindow>			mainWindow;
 	std::unique_ptr<QSystemTrayIcon> 	trayIcon;
@@ -53,6 +61,9 @@ inline MattermostApplication::MattermostApplication (int& argc, char *argv[])
 ,currentWindow (nullptr)
 {
     Config::init ();
+    startTrace ();
+    startStallMonitor ();
+    startTrafficCapture ();
 	trayIcon->setToolTip(tr("Mattermost Qt"));
 	trayIcon->setContextMenu (trayIconMenu.get());
 	trayIcon->show();
@@ -70,6 +81,81 @@ inline MattermostApplication::MattermostApplication (int& argc, char *argv[])
 	trayIconMenu->addAction ("Quit", qApp, &QApplication::quit);
 }
 
+/**
+ * Get the value of a command line option, given as '--option value'
+ * @return the value, or empty string if the option is not given
+ */
+inline QString MattermostApplication::getArgumentValue (const QString& name) const
+{
+	QStringList args (arguments());
+	int index = args.indexOf (name);
+
+	if (index > 0 && index + 1 < args.size()) {
+		return args[index + 1];
+	}
+
+	return QString();
+}
+
+/**
+ * The timeline is written to the file given with '--trace <file>',
+ * or to the file in the TRACE_FILE setting (if set)
+ */
+inline void MattermostApplication::startTrace ()
+{
+	QString traceFile (getArgumentValue ("--trace"));
+
+	if (traceFile.isEmpty()) {
+		traceFile = QSettings().value (TRACE_FILE).toString();
+	}
+
+	if (traceFile.isEmpty()) {
+		return;
+	}
+
+	Trace::start (traceFile);
+	connect (this, &QCoreApplication::aboutToQuit, [] {
+		Trace::stop ();
+	});
+}
+
+/**
+ * Stalls of the event loop are monitored, unless the STALL_THRESHOLD setting is 0
+ */
+inline void MattermostApplication::startStallMonitor ()
+{
+	int threshold = QSettings().value (STALL_THRESHOLD, StallMonitor::defaultThreshold).toInt();
+
+	if (threshold > 0) {
+		StallMonitor::start (threshold);
+	}
+}
+
+/**
+ * '--record <file>' records the HTTP and WebSocket traffic.
+ * '--replay <file>' replays a recording instead of using the network. '--replay-speed <factor>'
+ * accelerates the replay (0 - without delays)
+ */
+inline void MattermostApplication::startTrafficCapture ()
+{
+	QString recordFile (getArgumentValue ("--record"));
+	QString replayFile (getArgumentValue ("--replay"));
+
+	if (!replayFile.isEmpty()) {
+		bool speedIsValid;
+		double speed = getArgumentValue ("--replay-speed").toDouble (&speedIsValid);
+		TrafficCapture::startReplay (replayFile, speedIsValid ? speed : 1);
+	} else if (!recordFile.isEmpty()) {
+		TrafficCapture::startRecording (recordFile);
+	} else {
+		return;
+	}
+
+	connect (this, &QCoreApplication::aboutToQuit, [] {
+		TrafficCapture::stop ();
+	});
+}
+
 void MattermostApplication::openLoginWindow ()
 {
 	loginDialog = new LoginDialog (nullptr, backend);
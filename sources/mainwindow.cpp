@@ -23,10 +23,16 @@
 #include <QCloseEvent>
 #include <QMessageBox>
 #include <QSystemTrayIcon>
+#include <QShortcut>
 #include "./ui_mainwindow.h"
 #include "chat-area/ChatArea.h"
 #include "backend/Backend.h"
 #include "SettingsWindow.h"
+#include "image-decoder/ImageDecoder.h"
+#include "info-dialogs/MemoryReportDialog.h"
+#include "info-dialogs/StallReportDialog.h"
+#include "search-dialog/PostSearchDialog.h"
+#include "Settings.h"
 #include "build-config.h"
 #include "log.h"
 
@@ -39,6 +45,7 @@ MainWindow::MainWindow (QWidget *parent, QSystemTrayIcon& trayIcon, Backend& _ba
 ,chooseEmojiDialog (this)
 ,backend (_backend)
 ,currentTeamRestoredFromSettings (false)
+,searchDialog (nullptr)
 ,doDeinit (false)
 {
 	LOG_DEBUG ("MainWindow create start");
@@ -49,6 +56,13 @@ MainWindow::MainWindow (QWidget *parent, QSystemTrayIcon& trayIcon, Backend& _ba
 
 	createMenu ();
 
+	QShortcut* searchShortcut = new QShortcut (QKeySequence::Find, this);
+	connect (searchShortcut, &QShortcut::activated, this, &MainWindow::showSearchDialog);
+
+	connect (&backend, &Backend::onCustomEmojiImagesChanged, this, [this] (const QSet<QString>& emojiNames) {
+		chooseEmojiDialog.dialog.updateCustomEmojiImages (emojiNames);
+	});
+
 	const BackendUser& currentUser = backend.getLoginUser();
 
 	if (currentUser.id.isEmpty()) {
@@ -57,17 +71,26 @@ MainWindow::MainWindow (QWidget *parent, QSystemTrayIcon& trayIcon, Backend& _ba
 		return;
 	}
 
-	connect (&currentUser, &BackendUser::onStatusChanged, [this, &currentUser] {
-		ui->statusLabel->setText (currentUser.status);
+	UserObservers& userObservers = backend.getStorage().observers.user;
+
+	connect (&backend, &Backend::onUserStatusesChanged, this, [this] (const QSet<QString>& userIDs) {
+		const BackendUser& currentUser = backend.getLoginUser();
+
+		if (userIDs.contains (currentUser.id)) {
+			ui->statusLabel->setText (currentUser.status);
+		}
 	});
 
 	ui->usernameLabel->setText (currentUser.username);
 
-	connect (&currentUser, &BackendUser::onAvatarChanged, [this, &currentUser] {
+	subscriptions.push_back (userObservers.avatarChanged.subscribe (currentUser.id, [this] (const BackendUser& user) {
 		LOG_DEBUG ("Got User Image");
-		QImage img = QImage::fromData (currentUser.avatar).scaled(42, 42, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-		ui->usericon_label->setPixmap (QPixmap::fromImage(img));
-	});
+		//a newer avatar replaces the one being decoded
+		avatarDecodeToken.cancel ();
+		avatarDecodeToken = ImageDecoder::decode (user.avatar, QSize (42, 42), ImageScaleMode::exact, this, [this] (const QImage& img) {
+			ui->usericon_label->setPixmap (QPixmap::fromImage(img));
+		});
+	}));
 
 	/*
 	 * Gets the LoginUser's image for the user icon
@@ -150,11 +173,13 @@ MainWindow::MainWindow (QWidget *parent, QSystemTrayIcon& trayIcon, Backend& _ba
 	restoreGeometry (settings.value( "geometry", saveGeometry()).toByteArray());
 
 	connect (qApp, &QApplication::aboutToQuit, this, &MainWindow::saveState);
+	startMemoryReports ();
 	LOG_DEBUG ("MainWindow create finish");
 }
 
 MainWindow::~MainWindow()
 {
+	avatarDecodeToken.cancel ();
 }
 
 static QString infoText (QString ("Version " PROJECT_VER "<br/>"
@@ -190,8 +215,10 @@ void MainWindow::createMenu ()
 		});
 	});
 
+	mainMenu->addAction ("Search posts", this, &MainWindow::showSearchDialog);
+
 	mainMenu->addAction ("Settings", [this] {
-		settingsWindow = new SettingsWindow (this);
+		settingsWindow = new SettingsWindow (backend.getCacheManager(), this);
 
 		connect (settingsWindow, &QDialog::accepted, [this] {
 
@@ -223,9 +250,53 @@ void MainWindow::createMenu ()
 		QMessageBox::aboutQt (this, "About QT");
 	});
 
+	helpMenu->addAction ("Memory usage", [this] {
+		MemoryReportDialog* dialog = new MemoryReportDialog (backend, *this, this);
+		dialog->setAttribute (Qt::WA_DeleteOnClose);
+		dialog->open ();
+	});
+
+	helpMenu->addAction ("Event loop stalls", [this] {
+		StallReportDialog* dialog = new StallReportDialog (this);
+		dialog->setAttribute (Qt::WA_DeleteOnClose);
+		dialog->open ();
+	});
+
 	ui->toolButton->setMenu(mainMenu);
 }
 
+/**
+ * The estimated memory usage is logged periodically, unless the MEMORY_REPORT_INTERVAL setting (in minutes) is 0
+ */
+void MainWindow::startMemoryReports ()
+{
+	int interval = QSettings().value (MEMORY_REPORT_INTERVAL, 10).toInt();
+
+	if (interval <= 0) {
+		return;
+	}
+
+	connect (&memoryReportTimer, &QTimer::timeout, [this] {
+		MemoryAccounting::log (MemoryReportDialog::collect (backend, *this));
+	});
+
+	memoryReportTimer.start (interval * 60 * 1000);
+}
+
+/**
+ * The search dialog is kept, so the last query and its results are shown when it is opened again
+ */
+void MainWindow::showSearchDialog ()
+{
+	if (!searchDialog) {
+		searchDialog = new PostSearchDialog (backend, *this, this);
+	}
+
+	searchDialog->show ();
+	searchDialog->raise ();
+	searchDialog->activateWindow ();
+}
+
 void MainWindow::moveEvent (QMoveEvent*)
 {
 
@@ -20,9 +20,13 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <QMainWindow>
 #include <QSet>
+#include <QTimer>
 #include "choose-emoji-dialog/ChooseEmojiDialogWrapper.h"
+#include "backend/ObserverRegistry.h"
+#include "image-decoder/ImageDecoder.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -39,6 +43,7 @@ class BackendChannel;
 class BackendPost;
 class BackendTeam;
 class SettingsWindow;
+class PostSearchDialog;
 
 class MainWindow: public QMainWindow {
 	Q_OBJECT
@@ -81,6 +86,8 @@ public:
 private:
 	void createMenu ();
 	void reload ();
+	void startMemoryReports ();
+	void showSearchDialog ();
 private:
 	std::unique_ptr<Ui::MainWindow>		ui;
 	QSystemTrayIcon&					trayIcon;
@@ -90,6 +97,10 @@ private:
 	bool								currentTeamRestoredFromSettings;
 	QMenu*								mainMenu;
 	SettingsWindow*						settingsWindow;
+	PostSearchDialog*					searchDialog;
+	QTimer								memoryReportTimer;
+	std::vector<Subscription>			subscriptions;
+	ImageDecodeToken					avatarDecodeToken;
 	bool								doDeinit;
 };
 
@@ -23,6 +23,7 @@
 #include <QResizeEvent>
 #include <QDesktopWidget>
 #include <QDebug>
+#include "image-decoder/ImageDecoder.h"
 
 namespace Mattermost  {
 
@@ -33,13 +34,8 @@ FilePreview::FilePreview (const FilePreviewData& file, QWidget *parent)
 	ui->setupUi(this);
 	setWindowTitle(file.fileName + " [" + file.fileAuthor + "] - Mattermost");
 
-	QImage img = QImage::fromData (file.fileContents);
-	pixmap = QPixmap::fromImage(img);
-	ui->fileContents->setPixmap (pixmap);
-	ui->fileContents->setMinimumSize (getMinimumSize (pixmap));
-
 	ui->fileInfo->setText (file.fileName);
-	adjustSize();
+	setFileContents (file.fileContents);
 
 	resizeTimer.setSingleShot (true);
 	connect (&resizeTimer, &QTimer::timeout, [this] {
@@ -52,6 +48,19 @@ FilePreview::~FilePreview()
     delete ui;
 }
 
+void FilePreview::setFileContents (const QByteArray& fileContents)
+{
+	//if the previous contents are still being decoded, they are outdated
+	decodeToken.cancel ();
+
+	decodeToken = ImageDecoder::decode (fileContents, QSize(), ImageScaleMode::original, this, [this] (const QImage& img) {
+		pixmap = QPixmap::fromImage(img);
+		ui->fileContents->setPixmap (pixmap);
+		ui->fileContents->setMinimumSize (getMinimumSize (pixmap));
+		adjustSize();
+	});
+}
+
 QSize FilePreview::getMinimumSize (const QPixmap& pixmap)
 {
 	QSize ret = pixmap.size();
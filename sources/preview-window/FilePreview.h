@@ -22,6 +22,7 @@
 
 #include <QDialog>
 #include <QTimer>
+#include "image-decoder/ImageDecoder.h"
 
 namespace Ui {
 class FilePreview;
@@ -43,6 +44,13 @@ public:
 public:
     QSize getMinimumSize (const QPixmap& pixmap);
 
+    /**
+     * Show new file contents. Used to replace the initially shown (scaled-down) preview
+     * with the original image, when it is received
+     * @param fileContents image data
+     */
+    void setFileContents (const QByteArray& fileContents);
+
     void resizeEvent(QResizeEvent* event) override;
 
 private:
@@ -50,6 +58,7 @@ private:
     QPixmap				pixmap;
     QTimer				resizeTimer;
     QSize				newWindowSize;
+    ImageDecodeToken	decodeToken;
 };
 
 } /* namespace Mattermost */
@@ -0,0 +1,270 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "PostSearchDialog.h"
+
+#include <QDateTime>
+#include <QDialogButtonBox>
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPointer>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include "backend/Backend.h"
+#include "chat-area/ChatArea.h"
+#include "channel-tree/ChannelItem.h"
+
+namespace Mattermost {
+
+namespace {
+
+constexpr int maxLocalResults = 100;
+
+enum ItemRole {
+	channelIdRole = Qt::UserRole,
+	postIdRole,
+	rootIdRole
+};
+
+QString getChannelName (const BackendChannel& channel)
+{
+	return channel.display_name.isEmpty() ? channel.name : channel.display_name;
+}
+
+}
+
+PostSearchDialog::PostSearchDialog (Backend& backend, QWidget& mainWindow, QWidget* parent)
+:QDialog (parent)
+,backend (backend)
+,mainWindow (mainWindow)
+,queryEdit (new QLineEdit (this))
+,summaryLabel (new QLabel (this))
+,resultsTree (new QTreeWidget (this))
+,serverSearchID (0)
+,pendingServerSearches (0)
+,failedServerSearches (0)
+{
+	setWindowTitle ("Search posts - Mattermost");
+	resize (900, 500);
+
+	queryEdit->setPlaceholderText ("Search the loaded posts. Press Enter to search the server too");
+	queryEdit->setClearButtonEnabled (true);
+
+	resultsTree->setHeaderLabels ({"Channel", "Author", "Time", "Message"});
+	resultsTree->setRootIsDecorated (false);
+	resultsTree->header()->setSectionResizeMode (0, QHeaderView::ResizeToContents);
+	resultsTree->header()->setSectionResizeMode (1, QHeaderView::ResizeToContents);
+	resultsTree->header()->setSectionResizeMode (2, QHeaderView::ResizeToContents);
+
+	QDialogButtonBox* buttonBox = new QDialogButtonBox (QDialogButtonBox::Close, this);
+	QPushButton* serverSearchButton = buttonBox->addButton ("Search server", QDialogButtonBox::ActionRole);
+	serverSearchButton->setAutoDefault (false);
+
+	//Enter in the query field starts a server search, it should not close the dialog
+	buttonBox->button (QDialogButtonBox::Close)->setAutoDefault (false);
+
+	connect (buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+	connect (serverSearchButton, &QPushButton::clicked, this, &PostSearchDialog::searchServer);
+	connect (queryEdit, &QLineEdit::textChanged, this, &PostSearchDialog::searchLocal);
+	connect (queryEdit, &QLineEdit::returnPressed, this, &PostSearchDialog::searchServer);
+	connect (resultsTree, &QTreeWidget::itemActivated, this, &PostSearchDialog::openResult);
+
+	/*
+	 * Failed requests get no reply callback, only the backend's error notification.
+	 * While the server is searched, an error is taken as a failed search, so the summary does not wait forever
+	 */
+	auto onError = [this] (uint32_t, const QString&) {
+		onServerSearchFinished (true);
+	};
+
+	connect (&backend, &Backend::onHttpError, this, onError);
+	connect (&backend, &Backend::onNetworkError, this, onError);
+
+	QVBoxLayout* layout = new QVBoxLayout (this);
+	layout->addWidget (queryEdit);
+	layout->addWidget (summaryLabel);
+	layout->addWidget (resultsTree);
+	layout->addWidget (buttonBox);
+
+	searchLocal ();
+}
+
+PostSearchDialog::~PostSearchDialog () = default;
+
+void PostSearchDialog::searchLocal ()
+{
+	SearchIndex& searchIndex = backend.getStorage().searchIndex;
+
+	//a new query. The server results of the previous one are not shown
+	++serverSearchID;
+	pendingServerSearches = 0;
+
+	resultsTree->clear ();
+	shownPostIds.clear ();
+
+	QElapsedTimer timer;
+	timer.start ();
+
+	QVector<SearchResult> results (searchIndex.search (queryEdit->text(), maxLocalResults));
+
+	for (const SearchResult& result: results) {
+		addResult (*result.post, false);
+	}
+
+	summaryLabel->setText (QString ("%1 loaded posts found in %2 ms (%3 posts, %4 words indexed)")
+			.arg (results.size()).arg (timer.nsecsElapsed() / 1000000.0, 0, 'f', 1)
+			.arg (searchIndex.getPostsCount()).arg (searchIndex.getWordsCount()));
+}
+
+void PostSearchDialog::searchServer ()
+{
+	QString terms (queryEdit->text().trimmed());
+
+	if (terms.isEmpty()) {
+		return;
+	}
+
+	//replies of earlier searches are ignored
+	uint32_t searchID = ++serverSearchID;
+	pendingServerSearches = backend.getStorage().teams.size();
+
+	QPointer<PostSearchDialog> self (this);
+
+	//the direct and group channels are searched with each team, the duplicates are skipped
+	for (const auto& team: backend.getStorage().teams) {
+		backend.searchPosts (team.first, terms, [self, searchID] (std::list<BackendPost>& posts) {
+
+			if (!self || self->serverSearchID != searchID) {
+				return;
+			}
+
+			for (const BackendPost& post: posts) {
+				self->addResult (post, true);
+			}
+
+			self->onServerSearchFinished (false);
+		});
+	}
+
+	failedServerSearches = 0;
+	updateServerSearchSummary ();
+}
+
+void PostSearchDialog::onServerSearchFinished (bool failed)
+{
+	if (pendingServerSearches == 0) {
+		return;
+	}
+
+	--pendingServerSearches;
+
+	if (failed) {
+		++failedServerSearches;
+	}
+
+	updateServerSearchSummary ();
+}
+
+void PostSearchDialog::updateServerSearchSummary ()
+{
+	QString summary (QString ("%1 posts found").arg (resultsTree->topLevelItemCount()));
+
+	if (pendingServerSearches > 0) {
+		summary += QString (". Searching the server (%1 teams left)...").arg (pendingServerSearches);
+	} else {
+		summary += " (loaded and on the server)";
+	}
+
+	if (failedServerSearches > 0) {
+		summary += QString (". %1 server searches failed").arg (failedServerSearches);
+	}
+
+	summaryLabel->setText (summary);
+}
+
+void PostSearchDialog::addResult (const BackendPost& post, bool fromServer)
+{
+	if (shownPostIds.contains (post.id)) {
+		return;
+	}
+
+	shownPostIds.insert (post.id);
+
+	BackendChannel* channel = backend.getStorage().getChannelById (post.channel_id);
+	QString message (post.message.section ('\n', 0, 0));
+
+	if (message.size() > 200) {
+		message = message.left (200) + "...";
+	}
+
+	QTreeWidgetItem* item = new QTreeWidgetItem (resultsTree, {
+		channel ? getChannelName (*channel) : post.channel_id,
+		post.getDisplayAuthorName(),
+		post.getCreationTime().toString ("dd.MM.yyyy HH:mm"),
+		fromServer ? "(server) " + message : message
+	});
+
+	item->setToolTip (3, post.message);
+	item->setData (0, channelIdRole, post.channel_id);
+	item->setData (0, postIdRole, post.id);
+	item->setData (0, rootIdRole, post.root_id);
+}
+
+void PostSearchDialog::openResult (QTreeWidgetItem* item)
+{
+	QString channelID (item->data (0, channelIdRole).toString());
+	QString postID (item->data (0, postIdRole).toString());
+	QString rootID (item->data (0, rootIdRole).toString());
+
+	ChatArea* chatArea = findChatArea (channelID);
+
+	if (!chatArea) {
+		summaryLabel->setText ("The channel of the post is not open");
+		return;
+	}
+
+	//selecting the channel tree item activates the chat area
+	chatArea->treeItem->treeWidget()->setCurrentItem (chatArea->treeItem);
+
+	BackendPost* post = chatArea->channel.postIdToPost.value (postID, nullptr);
+
+	if (post) {
+		chatArea->goToPost (*post);
+		return;
+	}
+
+	//the post is older than the loaded ones. Show it with its thread, which is retrieved if needed
+	chatArea->showThread (rootID.isEmpty() ? postID : rootID);
+}
+
+ChatArea* PostSearchDialog::findChatArea (const QString& channelID) const
+{
+	for (ChatArea* chatArea: mainWindow.findChildren<ChatArea*>()) {
+		if (chatArea->channel.id == channelID) {
+			return chatArea;
+		}
+	}
+
+	return nullptr;
+}
+
+} /* namespace Mattermost */
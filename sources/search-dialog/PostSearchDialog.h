@@ -0,0 +1,66 @@
+/**
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QDialog>
+#include <QSet>
+
+class QLabel;
+class QLineEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+namespace Mattermost {
+
+class Backend;
+class BackendPost;
+class ChatArea;
+
+/**
+ * Searches the posts. The loaded posts are searched locally (in the search index) while typing.
+ * The server is searched on Enter, for the posts which are not loaded.
+ * Activating a result shows the post in its channel
+ */
+class PostSearchDialog: public QDialog {
+	Q_OBJECT
+public:
+	PostSearchDialog (Backend& backend, QWidget& mainWindow, QWidget* parent = nullptr);
+	~PostSearchDialog ();
+private:
+	void searchLocal ();
+	void searchServer ();
+	void onServerSearchFinished (bool failed);
+	void updateServerSearchSummary ();
+	void addResult (const BackendPost& post, bool fromServer);
+	void openResult (QTreeWidgetItem* item);
+	ChatArea* findChatArea (const QString& channelID) const;
+private:
+	Backend&			backend;
+	QWidget&			mainWindow;
+	QLineEdit*			queryEdit;
+	QLabel*				summaryLabel;
+	QTreeWidget*		resultsTree;
+	QSet<QString>		shownPostIds;
+	uint32_t			serverSearchID;
+	uint32_t			pendingServerSearches;
+	uint32_t			failedServerSearches;
+};
+
+} /* namespace Mattermost */
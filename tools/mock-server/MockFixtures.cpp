@@ -0,0 +1,479 @@
+/**
+ * @file MockFixtures.cpp
+ * @brief Synthetic server data for the local stand-in server
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "MockFixtures.h"
+
+#include <algorithm>
+#include <QJsonDocument>
+
+namespace Mattermost {
+
+//1x1 PNG, used for avatars, files, previews and thumbnails
+static const unsigned char pngImage[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x06, 0x00, 0x00, 0x00, 0x1f, 0x15, 0xc4,
+	0x89, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0x60, 0x60, 0xf8, 0xff,
+	0x1f, 0x00, 0x03, 0x03, 0x02, 0x00, 0xef, 0x9a, 0x5e, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+	0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+//all timestamps are relative to this time (Jan 1, 2022), so that the data does not depend on the current time
+static constexpr uint64_t fixturesBaseTime = 1640995200000;
+
+//each post is one minute older than the previous one
+static constexpr uint64_t postInterval = 60000;
+
+/**
+ * Mattermost IDs are 26 characters long
+ */
+static QString makeID (char prefix, int a, int b = 0)
+{
+	return prefix + QString ("%1%2").arg (a, 12, 10, QChar ('0')).arg (b, 13, 10, QChar ('0'));
+}
+
+MockFixtures::MockFixtures (const MockScale& scale)
+:scale (scale)
+,baseTime (fixturesBaseTime)
+{
+}
+
+const MockScale& MockFixtures::getScale () const
+{
+	return scale;
+}
+
+QString MockFixtures::userID (int index) const
+{
+	return makeID ('u', index);
+}
+
+QString MockFixtures::teamID (int index) const
+{
+	return makeID ('t', index);
+}
+
+QString MockFixtures::channelID (int team, int index) const
+{
+	return makeID ('c', team, index);
+}
+
+QString MockFixtures::directChannelID (int index) const
+{
+	return makeID ('d', index);
+}
+
+QJsonObject MockFixtures::user (int index) const
+{
+	QString name ("user" + QString::number (index));
+
+	return QJsonObject {
+		{"id", userID (index)},
+		{"create_at", double (baseTime)},
+		{"update_at", double (baseTime)},
+		{"delete_at", 0},
+		{"username", name},
+		{"email", name + "@example.com"},
+		{"nickname", ""},
+		{"first_name", "First" + QString::number (index)},
+		{"last_name", "Last" + QString::number (index)},
+		{"position", ""},
+		{"roles", index == 0 ? "system_user,system_admin" : "system_user"},
+		{"locale", "en"},
+		{"last_picture_update", double (baseTime + index)},
+	};
+}
+
+QJsonObject MockFixtures::team (int index) const
+{
+	return QJsonObject {
+		{"id", teamID (index)},
+		{"create_at", double (baseTime)},
+		{"update_at", double (baseTime)},
+		{"delete_at", 0},
+		{"display_name", "Team " + QString::number (index)},
+		{"name", "team" + QString::number (index)},
+		{"description", ""},
+		{"type", "O"},
+		{"allow_open_invite", true},
+	};
+}
+
+QJsonObject MockFixtures::channel (int team, int index) const
+{
+	return QJsonObject {
+		{"id", channelID (team, index)},
+		{"create_at", double (baseTime)},
+		{"update_at", double (baseTime)},
+		{"delete_at", 0},
+		{"team_id", teamID (team)},
+		{"type", "O"},
+		{"display_name", "Channel " + QString::number (team) + "." + QString::number (index)},
+		{"name", "channel-" + QString::number (team) + "-" + QString::number (index)},
+		{"header", ""},
+		{"purpose", ""},
+		{"last_post_at", double (baseTime)},
+		{"total_msg_count", scale.postsPerChannel},
+		{"creator_id", userID (0)},
+	};
+}
+
+QJsonObject MockFixtures::directChannel (int index) const
+{
+	int otherUser = 1 + index % std::max (scale.users - 1, 1);
+
+	return QJsonObject {
+		{"id", directChannelID (index)},
+		{"create_at", double (baseTime)},
+		{"update_at", double (baseTime)},
+		{"delete_at", 0},
+		{"team_id", ""},
+		{"type", "D"},
+		{"display_name", ""},
+		{"name", userID (0) + "__" + userID (otherUser)},
+		{"last_post_at", double (baseTime)},
+		{"total_msg_count", scale.postsPerChannel},
+		{"creator_id", userID (0)},
+	};
+}
+
+QJsonObject MockFixtures::post (const QString& channelID, int channelSeed, int index) const
+{
+	//index 0 is the newest post
+	QString postID (makeID ('p', channelSeed, index));
+	uint64_t createTime = baseTime - uint64_t (index) * postInterval;
+
+	QJsonObject metadata;
+
+	//every 10th post has an image attachment
+	if (index % 10 == 5) {
+		metadata.insert ("files", QJsonArray {QJsonObject {
+			{"id", makeID ('f', channelSeed, index)},
+			{"name", "image" + QString::number (index) + ".png"},
+			{"extension", "png"},
+			{"mime_type", "image/png"},
+			{"size", int (sizeof (pngImage))},
+			{"width", 1},
+			{"height", 1},
+			{"has_preview_image", true},
+		}});
+	}
+
+	//every 7th post has a reaction
+	if (index % 7 == 3) {
+		metadata.insert ("reactions", QJsonArray {QJsonObject {
+			{"user_id", userID ((channelSeed + index) % scale.users)},
+			{"post_id", postID},
+			{"emoji_name", "+1"},
+			{"create_at", double (createTime)},
+		}});
+	}
+
+	return QJsonObject {
+		{"id", postID},
+		{"create_at", double (createTime)},
+		{"update_at", double (createTime)},
+		{"edit_at", 0},
+		{"delete_at", 0},
+		{"is_pinned", false},
+		{"user_id", userID ((channelSeed * 31 + index) % scale.users)},
+		{"channel_id", channelID},
+		{"root_id", ""},
+		{"original_id", ""},
+		{"message", "Message " + QString::number (index) + " with some **markdown** and a link https://example.com/" + QString::number (index)},
+		{"type", ""},
+		{"props", QJsonObject ()},
+		{"hashtags", ""},
+		{"pending_post_id", ""},
+		{"metadata", metadata},
+	};
+}
+
+QJsonObject MockFixtures::postList (const QString& channelID, int channelSeed, int page, int perPage, const QString& beforePostID) const
+{
+	int first = page * perPage;
+
+	//the posts before a given post are older posts, which have bigger indices
+	if (!beforePostID.isEmpty()) {
+		first += beforePostID.rightRef (13).toInt () + 1;
+	}
+
+	int last = std::min (first + perPage, scale.postsPerChannel);
+
+	QJsonArray order;
+	QJsonObject posts;
+
+	for (int i = first; i < last; ++i) {
+		QJsonObject postObject (post (channelID, channelSeed, i));
+		order.append (postObject.value ("id"));
+		posts.insert (postObject.value ("id").toString(), postObject);
+	}
+
+	return QJsonObject {
+		{"order", order},
+		{"posts", posts},
+		{"next_post_id", ""},
+		{"prev_post_id", ""},
+	};
+}
+
+bool MockFixtures::findChannel (const QString& channelID, int& seed) const
+{
+	for (int team = 0; team < scale.teams; ++team) {
+		for (int i = 0; i < scale.channelsPerTeam; ++i) {
+			if (this->channelID (team, i) == channelID) {
+				seed = team * scale.channelsPerTeam + i;
+				return true;
+			}
+		}
+	}
+
+	for (int i = 0; i < scale.directChannels; ++i) {
+		if (directChannelID (i) == channelID) {
+			seed = scale.teams * scale.channelsPerTeam + i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+MockResponse MockFixtures::json (const QJsonObject& object) const
+{
+	MockResponse response;
+	response.body = QJsonDocument (object).toJson (QJsonDocument::Compact);
+	return response;
+}
+
+MockResponse MockFixtures::json (const QJsonArray& array) const
+{
+	MockResponse response;
+	response.body = QJsonDocument (array).toJson (QJsonDocument::Compact);
+	return response;
+}
+
+MockResponse MockFixtures::image (const QString& eTag, const QHash<QByteArray, QByteArray>& requestHeaders) const
+{
+	MockResponse response;
+	QByteArray quotedETag ('"' + eTag.toUtf8() + '"');
+	response.headers.append (qMakePair (QByteArray ("ETag"), quotedETag));
+
+	if (requestHeaders.value ("if-none-match") == quotedETag) {
+		response.status = 304;
+		return response;
+	}
+
+	response.contentType = "image/png";
+	response.body = QByteArray (reinterpret_cast<const char*> (pngImage), sizeof (pngImage));
+	return response;
+}
+
+MockResponse MockFixtures::handleRequest (const QByteArray& method, const QString& path, const QUrlQuery& query, const QHash<QByteArray, QByteArray>& requestHeaders) const
+{
+	QStringList parts (path.split ('/'));
+	int page = query.queryItemValue ("page").toInt();
+	int perPage = query.hasQueryItem ("per_page") ? query.queryItemValue ("per_page").toInt() : 60;
+
+	if (method == "POST" && path == "users/login") {
+		MockResponse response (json (user (0)));
+		response.headers.append (qMakePair (QByteArray ("Token"), QByteArray ("mocktoken")));
+		return response;
+	}
+
+	if (method == "POST" && path == "users/status/ids") {
+		QJsonArray statuses;
+
+		for (int i = 0; i < scale.users; ++i) {
+			statuses.append (QJsonObject {
+				{"user_id", userID (i)},
+				{"status", i % 3 ? "offline" : "online"},
+				{"last_activity_at", double (baseTime)},
+			});
+		}
+
+		return json (statuses);
+	}
+
+	if (method != "GET") {
+		return json (QJsonObject ());
+	}
+
+	if (path == "users/me") {
+		return json (user (0));
+	}
+
+	if (path == "users/stats") {
+		return json (QJsonObject {{"total_users_count", scale.users}});
+	}
+
+	if (path == "users") {
+		QJsonArray users;
+
+		for (int i = page * perPage; i < std::min ((page + 1) * perPage, scale.users); ++i) {
+			users.append (user (i));
+		}
+
+		return json (users);
+	}
+
+	if (path == "users/me/teams") {
+		QJsonArray teams;
+
+		for (int i = 0; i < scale.teams; ++i) {
+			teams.append (team (i));
+		}
+
+		return json (teams);
+	}
+
+	if (path == "emoji" || path.endsWith ("/preferences")) {
+		return json (QJsonArray ());
+	}
+
+	//users/{id}, users/{id}/image
+	if (parts.size() >= 2 && parts[0] == "users" && parts[1].startsWith ('u')) {
+		if (parts.size() == 3 && parts[2] == "image") {
+			return image (parts[1], requestHeaders);
+		}
+
+		return json (user (parts[1].mid (1, 12).toInt()));
+	}
+
+	//users/me/teams/{id}/channels
+	if (parts.size() == 5 && parts[0] == "users" && parts[2] == "teams" && parts[4] == "channels") {
+		int teamIndex = parts[3].mid (1, 12).toInt();
+		QJsonArray channels;
+
+		for (int i = 0; i < scale.channelsPerTeam; ++i) {
+			channels.append (channel (teamIndex, i));
+		}
+
+		//the direct channels are listed with the first team
+		if (teamIndex == 0) {
+			for (int i = 0; i < scale.directChannels; ++i) {
+				channels.append (directChannel (i));
+			}
+		}
+
+		return json (channels);
+	}
+
+	//users/me/channels/{id}/posts/unread
+	if (parts.size() == 6 && parts[0] == "users" && parts[2] == "channels" && parts[5] == "unread") {
+		return json (QJsonObject {{"order", QJsonArray ()}, {"posts", QJsonObject ()}});
+	}
+
+	//teams/{id}/members
+	if (parts.size() == 3 && parts[0] == "teams" && parts[2] == "members") {
+		QJsonArray members;
+
+		for (int i = page * perPage; i < std::min ((page + 1) * perPage, scale.users); ++i) {
+			members.append (QJsonObject {
+				{"team_id", parts[1]},
+				{"user_id", userID (i)},
+				{"roles", i == 0 ? "team_user team_admin" : "team_user"},
+			});
+		}
+
+		return json (members);
+	}
+
+	//channels/{id}/...
+	int channelSeed;
+
+	if (parts.size() >= 2 && parts[0] == "channels" && findChannel (parts[1], channelSeed)) {
+		if (parts.size() == 3 && parts[2] == "posts") {
+			return json (postList (parts[1], channelSeed, page, perPage, query.queryItemValue ("before")));
+		}
+
+		if (parts.size() == 3 && parts[2] == "pinned") {
+			return json (QJsonObject {{"order", QJsonArray ()}, {"posts", QJsonObject ()}});
+		}
+
+		if (parts.size() == 3 && parts[2] == "members") {
+			QJsonArray members;
+
+			for (int i = 0; i < std::min (scale.channelMembers, scale.users); ++i) {
+				members.append (QJsonObject {
+					{"channel_id", parts[1]},
+					{"user_id", userID ((channelSeed + i) % scale.users)},
+					{"roles", "channel_user"},
+					{"last_viewed_at", double (baseTime)},
+				});
+			}
+
+			return json (members);
+		}
+	}
+
+	//files/{id}, files/{id}/preview, files/{id}/thumbnail
+	if (parts.size() >= 2 && parts[0] == "files") {
+		return image (path, requestHeaders);
+	}
+
+	MockResponse response (json (QJsonObject {{"message", "Not implemented in the stand-in server: " + path}}));
+	response.status = 404;
+	return response;
+}
+
+QJsonObject MockFixtures::statusChangeEvent (int userIndex, const QString& status) const
+{
+	return QJsonObject {
+		{"event", "status_change"},
+		{"data", QJsonObject {{"user_id", userID (userIndex)}, {"status", status}}},
+		{"broadcast", QJsonObject {{"user_id", userID (userIndex)}}},
+	};
+}
+
+QJsonObject MockFixtures::typingEvent (int userIndex, int team, int channel) const
+{
+	return QJsonObject {
+		{"event", "typing"},
+		{"data", QJsonObject {{"user_id", userID (userIndex)}, {"parent_id", ""}}},
+		{"broadcast", QJsonObject {{"channel_id", channelID (team, channel)}}},
+	};
+}
+
+QJsonObject MockFixtures::postedEvent (int userIndex, int team, int channel, int sequence) const
+{
+	QString channelID (this->channelID (team, channel));
+	QJsonObject postObject (post (channelID, team * scale.channelsPerTeam + channel, 0));
+
+	//new posts are newer than all generated posts
+	postObject.insert ("id", makeID ('n', team * scale.channelsPerTeam + channel, sequence));
+	postObject.insert ("create_at", double (baseTime + uint64_t (sequence + 1) * postInterval));
+	postObject.insert ("user_id", userID (userIndex));
+
+	return QJsonObject {
+		{"event", "posted"},
+		{"data", QJsonObject {
+			{"team_id", teamID (team)},
+			{"set_online", true},
+			//the server sends the post as a JSON string
+			{"post", QString (QJsonDocument (postObject).toJson (QJsonDocument::Compact))},
+		}},
+		{"broadcast", QJsonObject {{"channel_id", channelID}}},
+	};
+}
+
+} /* namespace Mattermost */
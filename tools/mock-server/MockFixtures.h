@@ -0,0 +1,101 @@
+/**
+ * @file MockFixtures.h
+ * @brief Synthetic server data for the local stand-in server
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QUrlQuery>
+
+namespace Mattermost {
+
+/**
+ * Size of the generated data
+ */
+struct MockScale {
+	int		users = 500;
+	int		teams = 2;
+	int		channelsPerTeam = 20;		//open channels in each team
+	int		directChannels = 10;		//direct channels of the logged-in user
+	int		postsPerChannel = 200;
+	int		channelMembers = 50;
+};
+
+struct MockResponse {
+	int										status = 200;
+	QByteArray								body;
+	QByteArray								contentType = "application/json";
+	QList<QPair<QByteArray, QByteArray>>	headers;
+};
+
+/**
+ * Deterministic data of a Mattermost server. The same scale always produces the same IDs,
+ * timestamps and messages, so that the measurements are reproducible.
+ * The logged-in user is the first user
+ */
+class MockFixtures {
+public:
+	explicit MockFixtures (const MockScale& scale);
+public:
+
+	/**
+	 * Build the response of an API request
+	 * @param path path after "/api/v4/"
+	 * @param requestHeaders lower case header names
+	 */
+	MockResponse handleRequest (const QByteArray& method, const QString& path, const QUrlQuery& query, const QHash<QByteArray, QByteArray>& requestHeaders) const;
+
+	QString userID (int index) const;
+	QString teamID (int index) const;
+	QString channelID (int team, int index) const;
+	QString directChannelID (int index) const;
+
+	//events pushed through the WebSocket
+	QJsonObject statusChangeEvent (int userIndex, const QString& status) const;
+	QJsonObject typingEvent (int userIndex, int team, int channel) const;
+	QJsonObject postedEvent (int userIndex, int team, int channel, int sequence) const;
+
+	const MockScale& getScale () const;
+private:
+	QJsonObject user (int index) const;
+	QJsonObject team (int index) const;
+	QJsonObject channel (int team, int index) const;
+	QJsonObject directChannel (int index) const;
+	QJsonObject post (const QString& channelID, int channelSeed, int index) const;
+	QJsonObject postList (const QString& channelID, int channelSeed, int page, int perPage, const QString& beforePostID) const;
+	bool findChannel (const QString& channelID, int& seed) const;
+	MockResponse json (const QJsonObject& object) const;
+	MockResponse json (const QJsonArray& array) const;
+	MockResponse image (const QString& eTag, const QHash<QByteArray, QByteArray>& requestHeaders) const;
+private:
+	MockScale	scale;
+	uint64_t	baseTime;
+};
+
+} /* namespace Mattermost */
@@ -0,0 +1,254 @@
+/**
+ * @file MockServer.cpp
+ * @brief Local stand-in Mattermost server, serving synthetic data over HTTP and WebSocket
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include "MockServer.h"
+
+#include <algorithm>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QtWebSockets/QWebSocket>
+#include "log.h"
+
+namespace Mattermost {
+
+static const QString apiRoot ("/api/v4/");
+
+MockServer::MockServer (const MockFixtures& fixtures)
+:fixtures (fixtures)
+,webSocketServer ("mattermost-mock-server", QWebSocketServer::NonSecureMode)
+{
+	connect (&tcpServer, &QTcpServer::newConnection, this, &MockServer::onNewConnection);
+	connect (&webSocketServer, &QWebSocketServer::newConnection, this, &MockServer::onNewWebSocketConnection);
+}
+
+MockServer::~MockServer () = default;
+
+bool MockServer::listen (const QHostAddress& address, quint16 port)
+{
+	return tcpServer.listen (address, port);
+}
+
+quint16 MockServer::serverPort () const
+{
+	return tcpServer.serverPort ();
+}
+
+void MockServer::addEvent (int delay, const QJsonObject& event)
+{
+	events.push_back (ScriptedEvent {delay, QJsonDocument (event).toJson (QJsonDocument::Compact)});
+}
+
+bool MockServer::loadEventScript (const QString& fileName)
+{
+	QFile file (fileName);
+
+	if (!file.open (QIODevice::ReadOnly)) {
+		LOG_DEBUG ("Cannot open event script " << fileName);
+		return false;
+	}
+
+	while (!file.atEnd()) {
+		QByteArray line (file.readLine().trimmed());
+
+		if (line.isEmpty()) {
+			continue;
+		}
+
+		QJsonObject lineObject (QJsonDocument::fromJson (line).object());
+		addEvent (lineObject.value ("delay").toInt(), lineObject.value ("event").toObject());
+	}
+
+	return true;
+}
+
+void MockServer::addEventStorm (const QString& eventType, int count, int start, int interval)
+{
+	const MockScale& scale (fixtures.getScale());
+
+	for (int i = 0; i < count; ++i) {
+		int userIndex = 1 + i % std::max (scale.users - 1, 1);
+		int team = i % std::max (scale.teams, 1);
+		int channel = (i / std::max (scale.teams, 1)) % std::max (scale.channelsPerTeam, 1);
+		int delay = start + i * interval;
+
+		if (eventType == "status_change") {
+			addEvent (delay, fixtures.statusChangeEvent (userIndex, (i / scale.users) % 2 ? "online" : "away"));
+		} else if (eventType == "typing") {
+			addEvent (delay, fixtures.typingEvent (userIndex, team, channel));
+		} else if (eventType == "posted") {
+			addEvent (delay, fixtures.postedEvent (userIndex, team, channel, i));
+		}
+	}
+}
+
+void MockServer::onNewConnection ()
+{
+	while (QTcpSocket* socket = tcpServer.nextPendingConnection()) {
+		connect (socket, &QTcpSocket::readyRead, this, [this, socket] {
+			onReadyRead (socket);
+		});
+
+		connect (socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+	}
+}
+
+void MockServer::onReadyRead (QTcpSocket* socket)
+{
+	//there may be several requests, if the connection is kept alive
+	for (;;) {
+		//the data is only peeked, because a WebSocket handshake has to be passed unread to the WebSocket server
+		QByteArray available (socket->peek (socket->bytesAvailable()));
+		int headersEnd = available.indexOf ("\r\n\r\n");
+
+		if (headersEnd < 0) {
+			return;
+		}
+
+		QList<QByteArray> lines (available.left (headersEnd).split ('\n'));
+		QList<QByteArray> requestLine (lines.takeFirst().trimmed().split (' '));
+
+		if (requestLine.size() < 2) {
+			socket->disconnectFromHost ();
+			return;
+		}
+
+		QHash<QByteArray, QByteArray> headers;
+
+		for (const QByteArray& line: lines) {
+			int separator = line.indexOf (':');
+
+			if (separator > 0) {
+				headers.insert (line.left (separator).trimmed().toLower(), line.mid (separator + 1).trimmed());
+			}
+		}
+
+		if (headers.value ("upgrade").toLower() == "websocket") {
+			disconnect (socket, &QTcpSocket::readyRead, this, nullptr);
+			disconnect (socket, &QTcpSocket::disconnected, socket, nullptr);
+			webSocketServer.handleConnection (socket);
+			return;
+		}
+
+		int requestSize = headersEnd + 4 + headers.value ("content-length").toInt();
+
+		//wait for the whole body
+		if (available.size() < requestSize) {
+			return;
+		}
+
+		socket->read (requestSize);
+
+		QByteArray method (requestLine[0]);
+		QUrl url (QString::fromUtf8 (requestLine[1]));
+		QString path (url.path());
+
+		if (!path.startsWith (apiRoot)) {
+			MockResponse response;
+			response.status = 404;
+			sendResponse (socket, response);
+			continue;
+		}
+
+		//LOG_DEBUG (method << " " << url.toString());
+		sendResponse (socket, fixtures.handleRequest (method, path.mid (apiRoot.size()), QUrlQuery (url), headers));
+	}
+}
+
+static QByteArray statusText (int status)
+{
+	switch (status) {
+	case 200:
+		return "OK";
+	case 304:
+		return "Not Modified";
+	case 404:
+		return "Not Found";
+	default:
+		return "Unknown";
+	}
+}
+
+void MockServer::sendResponse (QTcpSocket* socket, const MockResponse& response)
+{
+	QByteArray data ("HTTP/1.1 " + QByteArray::number (response.status) + ' ' + statusText (response.status) + "\r\n");
+	data += "Content-Type: " + response.contentType + "\r\n";
+	data += "Content-Length: " + QByteArray::number (response.body.size()) + "\r\n";
+
+	for (const auto& header: response.headers) {
+		data += header.first + ": " + header.second + "\r\n";
+	}
+
+	data += "\r\n";
+	data += response.body;
+	socket->write (data);
+}
+
+void MockServer::onNewWebSocketConnection ()
+{
+	while (QWebSocket* socket = webSocketServer.nextPendingConnection()) {
+		LOG_DEBUG ("WebSocket client connected");
+
+		connect (socket, &QWebSocket::textMessageReceived, this, [this, socket] (const QString& message) {
+			onWebSocketMessage (socket, message);
+		});
+
+		connect (socket, &QWebSocket::disconnected, socket, &QObject::deleteLater);
+	}
+}
+
+void MockServer::onWebSocketMessage (QWebSocket* socket, const QString& message)
+{
+	QJsonObject messageObject (QJsonDocument::fromJson (message.toUtf8()).object());
+
+	if (messageObject.value ("action").toString() != "authentication_challenge") {
+		return;
+	}
+
+	socket->sendTextMessage (QJsonDocument (QJsonObject {
+		{"status", "OK"},
+		{"seq_reply", messageObject.value ("seq")},
+	}).toJson (QJsonDocument::Compact));
+
+	socket->sendTextMessage (QJsonDocument (QJsonObject {
+		{"event", "hello"},
+		{"data", QJsonObject {{"server_version", "mock"}}},
+		{"broadcast", QJsonObject ()},
+	}).toJson (QJsonDocument::Compact));
+
+	LOG_DEBUG ("WebSocket client authenticated. Sending " << events.size() << " events");
+
+	//the timers are owned by the socket, so they are stopped when the client disconnects
+	for (const ScriptedEvent& event: events) {
+		QByteArray packet (event.packet);
+
+		QTimer::singleShot (event.delay, socket, [socket, packet] {
+			socket->sendTextMessage (QString::fromUtf8 (packet));
+		});
+	}
+}
+
+} /* namespace Mattermost */
@@ -0,0 +1,87 @@
+/**
+ * @file MockServer.h
+ * @brief Local stand-in Mattermost server, serving synthetic data over HTTP and WebSocket
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <vector>
+#include <QObject>
+#include <QTcpServer>
+#include <QtWebSockets/QWebSocketServer>
+#include "MockFixtures.h"
+
+class QTcpSocket;
+class QWebSocket;
+
+namespace Mattermost {
+
+/**
+ * Minimal HTTP/1.1 and WebSocket server, listening on a single port (like the real server).
+ * Serves the REST API from MockFixtures and pushes scripted events to each WebSocket client after its authentication.
+ * The client connects to it with http://127.0.0.1:<port> as a server address
+ */
+class MockServer: public QObject {
+	Q_OBJECT
+public:
+	explicit MockServer (const MockFixtures& fixtures);
+	virtual ~MockServer ();
+public:
+	bool listen (const QHostAddress& address, quint16 port);
+	quint16 serverPort () const;
+
+	/**
+	 * Add an event, sent to each client
+	 * @param delay time after the WebSocket authentication (in milliseconds)
+	 */
+	void addEvent (int delay, const QJsonObject& event);
+
+	/**
+	 * Load events from a file. Each line is a JSON object {"delay": <ms>, "event": {...}}
+	 */
+	bool loadEventScript (const QString& fileName);
+
+	/**
+	 * Add many generated events of the same type ("status_change", "typing" or "posted")
+	 * @param start time of the first event, after the WebSocket authentication (in milliseconds)
+	 * @param interval time between the events (in milliseconds)
+	 */
+	void addEventStorm (const QString& eventType, int count, int start, int interval);
+private:
+	struct ScriptedEvent {
+		int				delay;
+		QByteArray		packet;
+	};
+
+	void onNewConnection ();
+	void onReadyRead (QTcpSocket* socket);
+	void sendResponse (QTcpSocket* socket, const MockResponse& response);
+	void onNewWebSocketConnection ();
+	void onWebSocketMessage (QWebSocket* socket, const QString& message);
+private:
+	const MockFixtures&				fixtures;
+	QTcpServer						tcpServer;
+	QWebSocketServer				webSocketServer;
+	std::vector<ScriptedEvent>		events;
+};
+
+} /* namespace Mattermost */
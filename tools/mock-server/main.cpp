@@ -0,0 +1,85 @@
+/**
+ * @file main.cpp
+ * @brief Local stand-in Mattermost server for performance measurements
+ * @author Lyubomir Filipov
+ * @date Oct 18, 2026
+ *
+ * Copyright 2021, 2022 Lyubomir Filipov
+ *
+ * This file is part of Mattermost-QT.
+ *
+ * Mattermost-QT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Mattermost-QT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Mattermost-QT. if not, see https://www.gnu.org/licenses/.
+ */
+
+#include <iostream>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include "MockServer.h"
+
+using namespace Mattermost;
+
+int main (int argc, char** argv)
+{
+	QCoreApplication app (argc, argv);
+	QCommandLineParser parser;
+
+	parser.setApplicationDescription ("Local stand-in Mattermost server. Serves synthetic data, so that the client startup"
+			" and event handling can be measured offline. Use http://127.0.0.1:<port> as a server address");
+	parser.addHelpOption ();
+
+	QCommandLineOption portOption ("port", "Port to listen on (default 8065)", "port", "8065");
+	QCommandLineOption usersOption ("users", "Number of users", "count", "500");
+	QCommandLineOption teamsOption ("teams", "Number of teams", "count", "2");
+	QCommandLineOption channelsOption ("channels", "Number of open channels in each team", "count", "20");
+	QCommandLineOption directChannelsOption ("direct-channels", "Number of direct channels", "count", "10");
+	QCommandLineOption postsOption ("posts", "Number of posts in each channel", "count", "200");
+	QCommandLineOption membersOption ("channel-members", "Number of members of each channel", "count", "50");
+	QCommandLineOption eventsOption ("events", "Event script. Each line is a JSON object {\"delay\": <ms>, \"event\": {...}}", "file");
+	QCommandLineOption stormOption ("storm", "Generated events: status_change, typing or posted", "type");
+	QCommandLineOption stormCountOption ("storm-count", "Number of generated events", "count", "1000");
+	QCommandLineOption stormStartOption ("storm-start", "Time of the first generated event, after the WebSocket authentication (ms)", "ms", "5000");
+	QCommandLineOption stormIntervalOption ("storm-interval", "Time between the generated events (ms)", "ms", "0");
+
+	parser.addOptions ({portOption, usersOption, teamsOption, channelsOption, directChannelsOption, postsOption, membersOption,
+		eventsOption, stormOption, stormCountOption, stormStartOption, stormIntervalOption});
+	parser.process (app);
+
+	MockScale scale;
+	scale.users = std::max (parser.value (usersOption).toInt(), 1);
+	scale.teams = parser.value (teamsOption).toInt();
+	scale.channelsPerTeam = parser.value (channelsOption).toInt();
+	scale.directChannels = parser.value (directChannelsOption).toInt();
+	scale.postsPerChannel = parser.value (postsOption).toInt();
+	scale.channelMembers = parser.value (membersOption).toInt();
+
+	MockFixtures fixtures (scale);
+	MockServer server (fixtures);
+
+	if (parser.isSet (eventsOption) && !server.loadEventScript (parser.value (eventsOption))) {
+		return 1;
+	}
+
+	if (parser.isSet (stormOption)) {
+		server.addEventStorm (parser.value (stormOption), parser.value (stormCountOption).toInt(),
+				parser.value (stormStartOption).toInt(), parser.value (stormIntervalOption).toInt());
+	}
+
+	if (!server.listen (QHostAddress::LocalHost, parser.value (portOption).toUShort())) {
+		std::cerr << "Cannot listen on port " << parser.value (portOption).toStdString() << std::endl;
+		return 1;
+	}
+
+	std::cout << "Listening on http://127.0.0.1:" << server.serverPort() << std::endl;
+	return app.exec ();
+}